@@ -18,43 +18,18 @@ namespace irk_avs_dec {
 
 using irk::msb_index_unzero;
 
-static const int16_t s_lgPmpsAdd[4] = {197, 197, 95, 46};
-
-static inline void update_ctx(AecDecCtx* pCtx, int binVal)
-{
-    assert(pCtx->lgPmps > 4 && pCtx->lgPmps < 1024);
-    if (binVal != pCtx->mps)
-    {
-        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-        int cycno = pCtx->cycNo;
-        int lgPmps = pCtx->lgPmps + s_lgPmpsAdd[cycno];
-        int32_t msk = (1023 - lgPmps) >> 31;            // lgPmps > 1023 ? -1 : 0
-        pCtx->mps ^= (msk & 1);
-        pCtx->cycNo += (cycno < 3);                     // MIN( cycno + 1, 3 )
-        pCtx->lgPmps = lgPmps ^ (msk & 2047);
-    }
-    else
-    {
-        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-        pCtx->cycNo += (pCtx->cycNo == 0);
-        int tmp = pCtx->lgPmps >> (2 + pCtx->cycNo);
-        pCtx->lgPmps -= (tmp + (tmp >> 2));
-    }
-}
-
 void AvsAecParser::init()
 {
-    assert(m_pCur != nullptr && m_Offset == 0);
-    m_rS1 = 0;
-    m_rT1 = 255;
-    m_ValueS = 0;
-    m_ValueT = read_bits(9);
-    while (m_ValueT < 0x100)
+    assert(m_pCur != nullptr && byte_aligned());
+    int valueS = 0;
+    int valueT = read_bits(9);
+    while (valueT < 0x100)
     {
-        m_ValueT = (m_ValueT << 1) | read1();
-        m_ValueS++;
+        valueT = (valueT << 1) | read1();
+        valueS++;
     }
-    m_ValueT &= 0xFF;
+    m_Range = -255;                                 // rS1 = 0, rT1 = 255
+    m_Value = valueS * 256 - (valueT & 0xFF);
 
     for (int i = 0; i < 200; i++)
     {
@@ -64,239 +39,86 @@ void AvsAecParser::init()
     }
 }
 
-uint8_t AvsAecParser::dec_decision(int cIdx)
+void AvsAecParser::dec_lps(int lgPmps2)
 {
-    assert(cIdx >= 0 && cIdx <= 323);
-    AecDecCtx* pCtx = m_CtxAry + cIdx;
-    uint8_t binVal = pCtx->mps;
-    const int lgPmps2 = pCtx->lgPmps >> 2;
-    assert(lgPmps2 > 0);
-
-    int32_t rT2 = m_rT1 - lgPmps2;
-    int32_t sMask = rT2 >> 31;          // m_rT1 >= lgPmps2 ? 0 : -1
-    int32_t rS2 = m_rS1 - sMask;
+    // 拆分为标准中的状态变量
+    int32_t rS1 = (m_Range + 255) >> 8;
+    int32_t rT1 = rS1 * 256 - m_Range;
+    int32_t valueS = (m_Value + 255) >> 8;
+    int32_t valueT = valueS * 256 - m_Value;
+    assert(rT1 >= 0 && rT1 <= 0xFF && valueT >= 0 && valueT <= 0xFF);
+
+    int32_t rT2 = rT1 - lgPmps2;
+    int32_t sMask = rT2 >> 31;          // rT1 >= lgPmps2 ? 0 : -1
+    int32_t rS2 = rS1 - sMask;
     rT2 += (sMask & 256);
+    assert(rS2 > valueS || (rS2 == valueS && valueT >= rT2));
 
-    int valueT = m_ValueT;
-    if (rS2 > m_ValueS || (rS2 == m_ValueS && valueT >= rT2))
-    {
-        binVal ^= 1;
-
-        if (rS2 == m_ValueS)
-            valueT = valueT - rT2;
-        else
-            valueT = 256 + ((valueT << 1) | read1()) - rT2;
-
-        int tRlps = (sMask & m_rT1) + lgPmps2;
-        if (tRlps < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)tRlps);
-            tRlps <<= cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(tRlps >= 0x100);
-        m_rS1 = 0;
-        m_rT1 = tRlps & 0xFF;
-
-        int valueS = 0;
-        while (valueT == 0)
-        {
-            valueS += 9;
-            valueT = read_bits(9);
-        }
-        if (valueT < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)valueT);
-            valueS += cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(valueT >= 0x100);
-        m_ValueS = valueS;
-        m_ValueT = valueT & 0xFF;
-
-        // update_ctx()
-        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-        int cycno = pCtx->cycNo;
-        int lgPmps = pCtx->lgPmps + s_lgPmpsAdd[cycno];
-        int32_t mask = (1023 - lgPmps) >> 31;           // lgPmps > 1023 ? -1 : 0
-        pCtx->mps ^= (mask & 1);
-        pCtx->cycNo += (cycno < 3);                     // MIN( cycno + 1, 3 )
-        pCtx->lgPmps = lgPmps ^ (mask & 2047);
-    }
+    // 重新归一化最多读取 1 + 8 + 8 位, 一次填充比特缓存即可
+    fill_bits();
+    if (rS2 == valueS)
+        valueT = valueT - rT2;
     else
-    {
-        m_rS1 = rS2;
-        m_rT1 = rT2;
-
-        // update_ctx()
-        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-        pCtx->cycNo += (pCtx->cycNo == 0);
-        int tmp = lgPmps2 >> pCtx->cycNo;
-        pCtx->lgPmps -= (tmp + (tmp >> 2));
-    }
-
-    assert(binVal == 0 || binVal == 1);
-    return binVal;
-}
+        valueT = 256 + ((valueT << 1) | take_bits(1)) - rT2;
 
-uint8_t AvsAecParser::dec_decision2(int cIdx1, int cIdx2)
-{
-    assert(cIdx1 >= 0 && cIdx1 <= 323);
-    assert(cIdx2 >= 0 && cIdx2 <= 323);
-    AecDecCtx* pCtx1 = m_CtxAry + cIdx1;
-    AecDecCtx* pCtx2 = m_CtxAry + cIdx2;
-
-    int lgPmps2;
-    uint8_t binVal;
-    if (pCtx1->mps == pCtx2->mps)
+    int tRlps = (sMask & rT1) + lgPmps2;
+    if (tRlps < 0x100)
     {
-        binVal = pCtx1->mps;
-        lgPmps2 = (pCtx1->lgPmps + pCtx2->lgPmps) >> 3;
+        int cnt = 8 - msb_index_unzero((uint32_t)tRlps);
+        tRlps <<= cnt;
+        valueT = (valueT << cnt) | take_bits(cnt);
     }
-    else if (pCtx1->lgPmps < pCtx2->lgPmps)
-    {
-        binVal = pCtx1->mps;
-        lgPmps2 = 1023 - ((pCtx2->lgPmps - pCtx1->lgPmps) >> 1);
-        lgPmps2 >>= 2;
-    }
-    else
-    {
-        binVal = pCtx2->mps;
-        lgPmps2 = 1023 - ((pCtx1->lgPmps - pCtx2->lgPmps) >> 1);
-        lgPmps2 >>= 2;
-    }
-    assert(lgPmps2 > 0);
-
-    int32_t rT2 = m_rT1 - lgPmps2;
-    int32_t sMask = rT2 >> 31;          // m_rT1 >= lgPmps2 ? 0 : -1
-    int32_t rS2 = m_rS1 - sMask;
-    rT2 += (sMask & 256);
+    assert(tRlps >= 0x100);
 
-    int valueT = m_ValueT;
-    if (rS2 > m_ValueS || (rS2 == m_ValueS && valueT >= rT2))
+    valueS = 0;
+    while (valueT == 0)
     {
-        binVal ^= 1;
-
-        if (rS2 == m_ValueS)
-            valueT = valueT - rT2;
-        else
-            valueT = 256 + ((valueT << 1) | read1()) - rT2;
-
-        int tRlps = (sMask & m_rT1) + lgPmps2;
-        if (tRlps < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)tRlps);
-            tRlps <<= cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(tRlps >= 0x100);
-        m_rS1 = 0;
-        m_rT1 = tRlps & 0xFF;
-
-        int valueS = 0;
-        while (valueT == 0)
-        {
-            valueS += 9;
-            valueT = read_bits(9);
-        }
-        if (valueT < 0x100)
+        valueS += 9;
+        if (valueS > 8192)      // 伪起始码机制保证正确码流中不会有如此长的连续 0, 避免读取越过输入缓冲的填充区
         {
-            int cnt = 8 - msb_index_unzero((uint32_t)valueT);
-            valueS += cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
+            valueT = 0x100;
+            break;
         }
-        assert(valueT >= 0x100);
-        m_ValueS = valueS;
-        m_ValueT = valueT & 0xFF;
+        valueT = read_bits(9);
     }
-    else
+    if (valueT < 0x100)
     {
-        m_rS1 = rS2;
-        m_rT1 = rT2;
+        int cnt = 8 - msb_index_unzero((uint32_t)valueT);
+        valueS += cnt;
+        valueT = (valueT << cnt) | take_bits(cnt);
     }
+    assert(valueT >= 0x100);
 
-    assert(binVal == 0 || binVal == 1);
-    update_ctx(pCtx1, binVal);
-    update_ctx(pCtx2, binVal);
-
-    return binVal;
+    m_Range = -(tRlps & 0xFF);                      // rS1 = 0
+    m_Value = valueS * 256 - (valueT & 0xFF);
 }
 
 int AvsAecParser::dec_zero_cnt(int cIdx, int maxCnt)
 {
-    assert(cIdx >= 0 && cIdx <= 323);
+    assert(cIdx >= 0 && cIdx < 200);
     AecDecCtx* pCtx = m_CtxAry + cIdx;
     int zeroCnt = 0;
-    int rS1 = m_rS1;
-    int rT1 = m_rT1;
-    int valueS = m_ValueS;
-    int valueT = m_ValueT;
+    int32_t range = m_Range;
+    int32_t value = m_Value;
 
     while (zeroCnt < maxCnt)
     {
-        uint8_t binVal = pCtx->mps;
         const int lgPmps2 = pCtx->lgPmps >> 2;
         assert(lgPmps2 > 0);
 
-        int32_t rT2 = rT1 - lgPmps2;
-        int32_t sMask = rT2 >> 31;          // m_rT1 >= lgPmps2 ? 0 : -1
-        int32_t rS2 = rS1 - sMask;
-        rT2 += (sMask & 256);
-
-        if (rS2 > valueS || (rS2 == valueS && valueT >= rT2))
+        uint8_t binVal;
+        if (range + lgPmps2 >= value)
         {
-            binVal ^= 1;
-
-            if (rS2 == valueS)
-                valueT = valueT - rT2;
-            else
-                valueT = 256 + ((valueT << 1) | read1()) - rT2;
-
-            int tRlps = (sMask & rT1) + lgPmps2;
-            if (tRlps < 0x100)
-            {
-                int cnt = 8 - msb_index_unzero((uint32_t)tRlps);
-                tRlps <<= cnt;
-                valueT = (valueT << cnt) | read_bits(cnt);
-            }
-            assert(tRlps >= 0x100);
-            rS1 = 0;
-            rT1 = tRlps & 0xFF;
-
-            valueS = 0;
-            while (valueT == 0)
-            {
-                valueS += 9;
-                valueT = read_bits(9);
-            }
-            if (valueT < 0x100)
-            {
-                int cnt = 8 - msb_index_unzero((uint32_t)valueT);
-                valueS += cnt;
-                valueT = (valueT << cnt) | read_bits(cnt);
-            }
-            assert(valueT >= 0x100);
-            valueT &= 0xFF;
-
-            // update_ctx()
-            assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-            int cycno = pCtx->cycNo;
-            int lgPmps = pCtx->lgPmps + s_lgPmpsAdd[cycno];
-            int32_t mask = (1023 - lgPmps) >> 31;           // lgPmps > 1023 ? -1 : 0
-            pCtx->mps ^= (mask & 1);
-            pCtx->cycNo += (cycno < 3);                     // MIN( cycno + 1, 3 )
-            pCtx->lgPmps = lgPmps ^ (mask & 2047);
+            m_Range = range;
+            dec_lps(lgPmps2);
+            range = m_Range;
+            value = m_Value;
+            binVal = update_ctx_lps(pCtx);
         }
         else
         {
-            rS1 = rS2;
-            rT1 = rT2;
-
-            // update_ctx()
-            assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
-            pCtx->cycNo += (pCtx->cycNo == 0);
-            int tmp = lgPmps2 >> pCtx->cycNo;
-            pCtx->lgPmps -= (tmp + (tmp >> 2));
+            range += lgPmps2;
+            binVal = update_ctx_mps(pCtx, lgPmps2);
         }
 
         if (binVal != 0)
@@ -305,115 +127,19 @@ int AvsAecParser::dec_zero_cnt(int cIdx, int maxCnt)
     }
 
     assert(zeroCnt <= maxCnt);
-    m_rS1 = rS1;
-    m_rT1 = rT1;
-    m_ValueS = valueS;
-    m_ValueT = valueT;
+    m_Range = range;
     return zeroCnt;
 }
 
-uint8_t AvsAecParser::dec_bypass()
-{
-    int32_t rT2 = m_rT1 - 255;
-    int32_t sMask = rT2 >> 31;          // m_rT1 >= 255 ? 0 : -1
-    int32_t rS2 = m_rS1 - sMask;
-    rT2 += (sMask & 256);
-
-    int valueT = m_ValueT;
-    if (rS2 > m_ValueS || (rS2 == m_ValueS && valueT >= rT2))
-    {
-        if (rS2 == m_ValueS)
-            valueT = valueT - rT2;
-        else
-            valueT = 256 + ((valueT << 1) | read1()) - rT2;
-
-        int tRlps = (sMask & m_rT1) + 255;
-        if (tRlps < 0x100)
-        {
-            tRlps <<= 1;
-            valueT = ((valueT << 1) | read1());
-        }
-        assert(tRlps >= 0x100);
-        m_rS1 = 0;
-        m_rT1 = tRlps & 0xFF;
-
-        int valueS = 0;
-        while (valueT == 0)
-        {
-            valueS += 9;
-            valueT = read_bits(9);
-        }
-        if (valueT < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)valueT);
-            valueS += cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(valueT >= 0x100);
-        m_ValueS = valueS;
-        m_ValueT = valueT & 0xFF;
-
-        return 1;
-    }
-    else
-    {
-        m_rS1 = rS2;
-        m_rT1 = rT2;
-    }
-
-    return 0;
-}
-
 uint8_t AvsAecParser::dec_stuffing_bit()
 {
-    int32_t rT2 = m_rT1 - 1;
-    int32_t sMask = rT2 >> 31;      // m_rT1 >= 1 ? 0 : -1
-    int32_t rS2 = m_rS1 - sMask;
-    rT2 += (sMask & 256);
-
-    if (rS2 > m_ValueS || (rS2 == m_ValueS && m_ValueT >= rT2))
+    int32_t range = m_Range + 1;
+    if (range >= m_Value)
     {
-        int valueT;
-        if (rS2 == m_ValueS)
-            valueT = m_ValueT - rT2;
-        else
-            valueT = 256 + ((m_ValueT << 1) | read1()) - rT2;
-
-        int tRlps = (sMask & m_rT1) + 1;
-        if (tRlps < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)tRlps);
-            tRlps <<= cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(tRlps >= 0x100);
-        m_rS1 = 0;
-        m_rT1 = tRlps & 0xFF;
-
-        int valueS = 0;
-        while (valueT == 0)
-        {
-            valueS += 9;
-            valueT = read_bits(9);
-        }
-        if (valueT < 0x100)
-        {
-            int cnt = 8 - msb_index_unzero((uint32_t)valueT);
-            valueS += cnt;
-            valueT = (valueT << cnt) | read_bits(cnt);
-        }
-        assert(valueT >= 0x100);
-        m_ValueS = valueS;
-        m_ValueT = valueT & 0xFF;
-
+        dec_lps(1);
         return 1;
     }
-    else
-    {
-        m_rS1 = rS2;
-        m_rT1 = rT2;
-    }
-
+    m_Range = range;
     return 0;
 }
 
@@ -450,89 +176,57 @@ int AvsAecParser::dec_mb_type_B(int ctxInc)
     return 8 + dec_zero_cnt(18, 24);
 }
 
-void AvsAecParser::dec_mvd(int16_t* mvd, int16_t* mvdAbs)
+int AvsAecParser::dec_eg0_bypass()
 {
-    // mv_diff_x
-    int ctxIdxX = 36 + (mvdAbs[0] >= 16) + (mvdAbs[0] >= 2);
-    if (dec_decision(ctxIdxX) == 0)
-    {
-        mvdAbs[0] = 0;
-        mvd[0] = 0;
-    }
-    else if (dec_decision(36 + 3) == 0)
+    int cnt = 0;
+    int val = 1;
+    while (dec_bypass() == 0 && cnt < 16)
     {
-        int sign = dec_bypass();
-        mvdAbs[0] = 1;
-        mvd[0] = (int16_t)(1 - (sign << 1));
-    }
-    else if (dec_decision(36 + 4) == 0)
-    {
-        int sign = dec_bypass();
-        mvdAbs[0] = 2;
-        mvd[0] = (int16_t)(2 - (sign << 2));
+        cnt++;
     }
-    else
+    while (cnt-- > 0)
     {
-        int absMvd = 3 + dec_decision(36 + 5);
-        int cnt = 0;
-        int val = 1;
-        while (dec_bypass() == 0 && cnt < 16)
-        {
-            cnt++;
-        }
-        while (cnt-- > 0)      // 0 阶哥伦布编码
-        {
-            val = (val << 1) | dec_bypass();
-        }
-        absMvd += (val - 1) * 2;
-
-        int sign = dec_bypass();
-        mvdAbs[0] = absMvd;
-        mvd[0] = (int16_t)((absMvd ^ -sign) + sign);
+        val = (val << 1) | dec_bypass();
     }
+    return val - 1;
+}
 
-    // mv_diff_y
-    int ctxIdxY = 42 + (mvdAbs[1] >= 16) + (mvdAbs[1] >= 2);
-    if (dec_decision(ctxIdxY) == 0)
+int16_t AvsAecParser::dec_mvd_comp(int ctxIdxBase, int16_t* mvdAbs)
+{
+    int ctxIdx = ctxIdxBase + (*mvdAbs >= 16) + (*mvdAbs >= 2);
+    if (dec_decision(ctxIdx) == 0)
     {
-        mvdAbs[1] = 0;
-        mvd[1] = 0;
+        *mvdAbs = 0;
+        return 0;
     }
-    else if (dec_decision(42 + 3) == 0)
+    else if (dec_decision(ctxIdxBase + 3) == 0)
     {
         int sign = dec_bypass();
-        mvdAbs[1] = 1;
-        mvd[1] = (int16_t)(1 - (sign << 1));
+        *mvdAbs = 1;
+        return (int16_t)(1 - (sign << 1));
     }
-    else if (dec_decision(42 + 4) == 0)
+    else if (dec_decision(ctxIdxBase + 4) == 0)
     {
         int sign = dec_bypass();
-        mvdAbs[1] = 2;
-        mvd[1] = (int16_t)(2 - (sign << 2));
+        *mvdAbs = 2;
+        return (int16_t)(2 - (sign << 2));
     }
-    else
-    {
-        int absMvd = 3 + dec_decision(42 + 5);
-        int cnt = 0;
-        int val = 1;
-        while (dec_bypass() == 0 && cnt < 16)
-        {
-            cnt++;
-        }
-        while (cnt-- > 0)      // 0 order golomb code
-        {
-            val = (val << 1) | dec_bypass();
-        }
-        absMvd += (val - 1) * 2;
 
-        int sign = dec_bypass();
-        mvdAbs[1] = (int16_t)absMvd;
-        mvd[1] = (int16_t)((absMvd ^ -sign) + sign);
-    }
+    int absMvd = 3 + dec_decision(ctxIdxBase + 5);
+    absMvd += dec_eg0_bypass() * 2;
+    int sign = dec_bypass();
+    *mvdAbs = (int16_t)absMvd;
+    return (int16_t)((absMvd ^ -sign) + sign);
+}
+
+void AvsAecParser::dec_mvd(int16_t* mvd, int16_t* mvdAbs)
+{
+    mvd[0] = dec_mvd_comp(36, mvdAbs);          // mv_diff_x
+    mvd[1] = dec_mvd_comp(42, mvdAbs + 1);      // mv_diff_y
 }
 
 // q.v. 8.4.4.2
-bool AvsAecParser::dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, uint8_t shift)
+int AvsAecParser::dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, uint8_t shift)
 {
     static const int s_PriIdx3[8] = {0 - 1, 3 - 1, 6 - 1, 9 - 1, 9 - 1, 12 - 1, 12 - 1};
     static const int s_PriIdx4[8] = {0 + 46, 4 + 46, 8 + 46, 12 + 46, 12 + 46, 16 + 46, 16 + 46};
@@ -573,7 +267,7 @@ bool AvsAecParser::dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, ui
         if (pos >= 64)
         {
             if (pos > 64 || dec_decision2(ctxIdxL, ctxIdxW + 31) == 0)   // bad stream
-                return false;
+                return COEFF_ERROR;
             break;
         }
         else
@@ -615,6 +309,7 @@ bool AvsAecParser::dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, ui
 
     zero_block8x8(coeff);
     int rnd = 1 << (shift - 1);
+    int nzMask = 0;
     int k = -1;
     while (--i >= 0)
     {
@@ -623,9 +318,10 @@ bool AvsAecParser::dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, ui
         int idx = m_invScan[k];
         int tmp = ((levelAry[i] * m_weightQM[idx] >> 3) * scale) >> 4;
         coeff[idx] = (int16_t)((tmp + rnd) >> shift);
+        nzMask |= (coeff[idx] != 0) ? (idx | 64) : 0;
     }
 
-    return true;
+    return coeff_shape(nzMask);
 }
 
 }   // namespace irk_avs_dec
@@ -18,17 +18,24 @@
 
 namespace irk_avs_dec {
 
+// 上下文状态, 各成员使用 16 位整数, 避免字符类型的别名分析使编译器反复读写解码器状态
 struct AecDecCtx
 {
-    int8_t  mps;
-    int8_t  cycNo;
+    int16_t mps;
+    int16_t cycNo;
     int16_t lgPmps;
 };
 
+// 高级熵编码解析器
+// 标准中的 (rS1, rT1) 和 (valueS, valueT) 分别合并为一个整数: m_Range = rS1 * 256 - rT1, m_Value = valueS * 256 - valueT,
+// rS1 <= valueS 且 rT1, valueT 均在 [0, 255] 范围内, 故标准中的 LPS 判断条件等价于 m_Range + (lgPmps >> 2) >= m_Value,
+// MPS 路径只需一次加法和一次比较, 只有 LPS 路径才需要拆分状态并重新归一化.
+// 码流通过 64 位缓存读取, 重新归一化时无需逐次访问内存.
 class AvsAecParser : IrkNocopy
 {
 public:
-    AvsAecParser() : m_pBuf(nullptr), m_pCur(nullptr), m_pEnd(nullptr), m_invScan(nullptr), m_weightQM(nullptr) {}
+    AvsAecParser() : m_pBuf(nullptr), m_pEnd(nullptr), m_pCur(nullptr), m_bitBuf(0), m_bitCnt(0),
+        m_invScan(nullptr), m_weightQM(nullptr) {}
 
     // 设置逆扫描和量化矩阵
     void set_scan_quant_matrix(const uint8_t* invScan, const uint8_t* wqm)
@@ -44,7 +51,8 @@ public:
         m_pBuf = buff;
         m_pEnd = buff + size;
         m_pCur = buff;
-        m_Offset = 0;
+        m_bitBuf = 0;
+        m_bitCnt = 0;
     }
 
     // 解析器初始化
@@ -53,44 +61,46 @@ public:
     // 读取下一个 bit
     uint8_t read1()
     {
-        uint8_t value = m_pCur[0] >> (m_Offset ^ 7);
-        m_Offset += 1;
-        m_pCur += m_Offset >> 3;
-        m_Offset &= 7;
-        return (value & 1);
+        fill_bits();
+        uint8_t value = (uint8_t)(m_bitBuf >> 63);
+        m_bitBuf <<= 1;
+        m_bitCnt -= 1;
+        return value;
     }
 
     // 读取指定位数, 要求 bitCnt > 0 && bitCnt <= 25
     uint32_t read_bits(uint32_t bitCnt)
     {
         assert(bitCnt > 0 && bitCnt <= 25);
-        uint32_t value = BE_READ32(m_pCur);
-        value = (value << m_Offset) >> (32 - bitCnt);
-        m_Offset += bitCnt;
-        m_pCur += m_Offset >> 3;
-        m_Offset &= 7;
+        fill_bits();
+        uint32_t value = (uint32_t)(m_bitBuf >> (64 - bitCnt));
+        m_bitBuf <<= bitCnt;
+        m_bitCnt -= bitCnt;
         return value;
     }
 
     // 当前读取位置是否字节对其
     bool byte_aligned() const
     {
-        return m_Offset == 0;
+        return (m_bitCnt & 7) == 0;
     }
 
     // 使下次读取从字节对齐处开始
     void make_byte_aligned()
     {
-        m_pCur += (m_Offset + 7) >> 3;
-        m_Offset = 0;
+        int bitCnt = m_bitCnt & 7;
+        m_bitBuf <<= bitCnt;
+        m_bitCnt -= bitCnt;
     }
 
     // 实现标准定义 is_end_of_slice()
     bool is_end_of_slice() const
     {
-        if (m_pCur < m_pEnd - 1)   // 快速返回
+        const uint8_t* pCur = m_pCur - ((m_bitCnt + 7) >> 3);       // 当前读取位置所在的字节
+        if (pCur < m_pEnd - 1)   // 快速返回
             return false;
-        if ((m_pCur >= m_pEnd) || (((m_pCur[0] << m_Offset) & 0xFF) == 0x80))
+        int offset = (-m_bitCnt) & 7;
+        if ((pCur >= m_pEnd) || (((pCur[0] << offset) & 0xFF) == 0x80))
             return true;
         return false;
     }
@@ -135,23 +145,157 @@ public:
     // mv_diff_x, mv_diff_y
     void dec_mvd(int16_t* mvd, int16_t* mvdAbs);
 
-    // 8x8 coefficient block
-    bool dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, uint8_t shift);
+    // 8x8 coefficient block, 返回非零系数的分布 CoeffShape, 码流错误返回 COEFF_ERROR(0)
+    int dec_coeff_block(int16_t* coeff, int ctxIdxBase, int scale, uint8_t shift);
 
 private:
+    // 保证比特缓存中至少有 33 位可读
+    void fill_bits()
+    {
+        if (m_bitCnt <= 32)
+        {
+            m_bitBuf |= (uint64_t)BE_READ32(m_pCur) << (32 - m_bitCnt);
+            m_pCur += 4;
+            m_bitCnt += 32;
+        }
+    }
+
+    // 从比特缓存中读取指定位数, 调用者保证缓存中有足够的数据
+    uint32_t take_bits(int bitCnt)
+    {
+        assert(bitCnt > 0 && bitCnt <= m_bitCnt);
+        uint32_t value = (uint32_t)(m_bitBuf >> (64 - bitCnt));
+        m_bitBuf <<= bitCnt;
+        m_bitCnt -= bitCnt;
+        return value;
+    }
+
+    // 解码出 LPS 后更新解码器状态, lgPmps2 为 LPS 概率的对数
+    void dec_lps(int lgPmps2);
+
+    // 根据解码结果更新上下文
+    static uint8_t update_ctx_mps(AecDecCtx* pCtx, int lgPmps2)
+    {
+        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
+        pCtx->cycNo += (pCtx->cycNo == 0);
+        int tmp = lgPmps2 >> pCtx->cycNo;
+        pCtx->lgPmps -= (tmp + (tmp >> 2));
+        return (uint8_t)pCtx->mps;
+    }
+    static uint8_t update_ctx_lps(AecDecCtx* pCtx)
+    {
+        static const int16_t s_lgPmpsAdd[4] = {197, 197, 95, 46};
+        assert(pCtx->cycNo >= 0 && pCtx->cycNo <= 3);
+        int cycno = pCtx->cycNo;
+        int binVal = pCtx->mps ^ 1;
+        int lgPmps = pCtx->lgPmps + s_lgPmpsAdd[cycno];
+        int32_t mask = (1023 - lgPmps) >> 31;            // lgPmps > 1023 ? -1 : 0
+        pCtx->mps ^= (mask & 1);
+        pCtx->cycNo += (cycno < 3);                     // MIN( cycno + 1, 3 )
+        pCtx->lgPmps = lgPmps ^ (mask & 2047);
+        return (uint8_t)binVal;
+    }
+
+    // 0 阶指数哥伦布编码的 bypass 二元符号串, 用于 mvd
+    int dec_eg0_bypass();
+
+    // mv_diff_x 或 mv_diff_y
+    int16_t dec_mvd_comp(int ctxIdxBase, int16_t* mvdAbs);
+
     const uint8_t*  m_pBuf;
     const uint8_t*  m_pEnd;
-    const uint8_t*  m_pCur;         // current read position
-    uint32_t        m_Offset;       // [0, 7]
-    int32_t         m_rS1;
-    int32_t         m_rT1;
-    int32_t         m_ValueS;
-    int32_t         m_ValueT;
+    const uint8_t*  m_pCur;         // 下一个读入比特缓存的字节
+    uint64_t        m_bitBuf;       // 比特缓存, 高位对齐
+    int32_t         m_bitCnt;       // 比特缓存中的有效位数
+    int32_t         m_Range;        // rS1 * 256 - rT1
+    int32_t         m_Value;        // valueS * 256 - valueT
     AecDecCtx       m_CtxAry[200];
     const uint8_t*  m_invScan;
     const uint8_t*  m_weightQM;
 };
 
+// decode_decision, contextWeighting == 0
+inline uint8_t AvsAecParser::dec_decision(int cIdx)
+{
+    assert(cIdx >= 0 && cIdx < 200);
+    AecDecCtx* pCtx = m_CtxAry + cIdx;
+    const int lgPmps2 = pCtx->lgPmps >> 2;
+    assert(lgPmps2 > 0);
+
+    int32_t range = m_Range + lgPmps2;
+    if (range >= m_Value)
+    {
+        dec_lps(lgPmps2);
+        return update_ctx_lps(pCtx);
+    }
+    m_Range = range;
+    return update_ctx_mps(pCtx, lgPmps2);
+}
+
+// decode_decision, contextWeighting == 1
+inline uint8_t AvsAecParser::dec_decision2(int cIdx1, int cIdx2)
+{
+    assert(cIdx1 >= 0 && cIdx1 < 200);
+    assert(cIdx2 >= 0 && cIdx2 < 200);
+    AecDecCtx* pCtx1 = m_CtxAry + cIdx1;
+    AecDecCtx* pCtx2 = m_CtxAry + cIdx2;
+
+    int lgPmps2;
+    int binVal;
+    if (pCtx1->mps == pCtx2->mps)
+    {
+        binVal = pCtx1->mps;
+        lgPmps2 = (pCtx1->lgPmps + pCtx2->lgPmps) >> 3;
+    }
+    else if (pCtx1->lgPmps < pCtx2->lgPmps)
+    {
+        binVal = pCtx1->mps;
+        lgPmps2 = (1023 - ((pCtx2->lgPmps - pCtx1->lgPmps) >> 1)) >> 2;
+    }
+    else
+    {
+        binVal = pCtx2->mps;
+        lgPmps2 = (1023 - ((pCtx1->lgPmps - pCtx2->lgPmps) >> 1)) >> 2;
+    }
+    assert(lgPmps2 > 0);
+
+    int32_t range = m_Range + lgPmps2;
+    if (range >= m_Value)
+    {
+        dec_lps(lgPmps2);
+        binVal ^= 1;
+    }
+    else
+    {
+        m_Range = range;
+    }
+
+    // 两个上下文按各自的 mps 更新
+    if (binVal == pCtx1->mps)
+        update_ctx_mps(pCtx1, pCtx1->lgPmps >> 2);
+    else
+        update_ctx_lps(pCtx1);
+    if (binVal == pCtx2->mps)
+        update_ctx_mps(pCtx2, pCtx2->lgPmps >> 2);
+    else
+        update_ctx_lps(pCtx2);
+
+    return (uint8_t)binVal;
+}
+
+// decode_bypass
+inline uint8_t AvsAecParser::dec_bypass()
+{
+    int32_t range = m_Range + 255;
+    if (range >= m_Value)
+    {
+        dec_lps(255);
+        return 1;
+    }
+    m_Range = range;
+    return 0;
+}
+
 // intra_chroma_pred_mode()
 inline uint8_t AvsAecParser::dec_intra_chroma_pred_mode(int ctxInc)
 {
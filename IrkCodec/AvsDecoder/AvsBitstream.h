@@ -91,6 +91,20 @@ public:
         m_pCur++;
     }
 
+    // 连续写出 n 个字节, 输出可与输入重叠, 但写出位置不能超过读取位置
+    void write_bytes(const uint8_t* src, int n)
+    {
+        for (; n >= 8; n -= 8, src += 8)
+        {
+            const uint64_t data = BE_READ64(src);
+            BE_WRITE64(m_pCur, ((uint64_t)m_pCur[0] << 56) | (data >> m_Offset));
+            m_pCur += 8;
+            m_pCur[0] = (uint8_t)(data << (8 - m_Offset));
+        }
+        for (; n > 0; n--)
+            write_byte(*src++);
+    }
+
     void make_byte_aligned()
     {
         m_pCur += (m_Offset + 7) >> 3;
@@ -108,5 +122,14 @@ private:
     uint32_t    m_Offset;   // [0, 7]
 };
 
+// 查找 00 00 01(起始码) 或 00 00 02(伪起始码), 返回其开始位置, 找不到返回 size
+// 解码器使用 AvsContext::pfnFindSc, 由解码器创建时检测的 CPU 级别选择
+typedef int (*PFN_FindScCandidate)(const uint8_t* data, int size);
+int find_sc_candidate_sse4(const uint8_t* data, int size);
+int find_sc_candidate_avx2(const uint8_t* data, int size);
+
+// 不依赖解码器的版本, 供 irk_avs_find_start_code 使用, 第一次调用时检测 CPU 特性
+int find_sc_candidate(const uint8_t* data, int size);
+
 }   // namespace irk_avs_dec
 #endif
@@ -17,6 +17,11 @@
 #pragma intrinsic(__cpuidex)
 #define cpuidex __cpuidex
 
+static inline unsigned long long xgetbv(unsigned int idx)
+{
+    return _xgetbv(idx);
+}
+
 #elif defined(__GNUC__) || defined(__clang__)
 
 static void cpuidex(int result[4], int eaxVal, int ecxVal)
@@ -43,21 +48,66 @@ static void cpuidex(int result[4], int eaxVal, int ecxVal)
     result[3] = d;
 }
 
+static inline unsigned long long xgetbv(unsigned int idx)
+{
+    unsigned int a, d;
+    __asm__(".byte 0x0f, 0x01, 0xd0" : "=a"(a), "=d"(d) : "c"(idx));  // xgetbv
+    return ((unsigned long long)d << 32) | a;
+}
+
 #else
 #error unsupport compiler
 #endif
 
+// AVX2 = 501, AVX2 + BMI2 = 502
+// AVX-512BW = 601
+// 返回 CPU 和操作系统都支持的 AVX 版本, 不支持 AVX2 返回 0
+static int get_avx_version()
+{
+    int abcd[4] = {0};
+    cpuidex(abcd, 0, 0);
+    if (abcd[0] < 7)
+        return 0;
+
+    // 需要 OSXSAVE 和 AVX 支持
+    cpuidex(abcd, 1, 0);
+    if ((abcd[2] & 0x18000000) != 0x18000000)
+        return 0;
+
+    // 操作系统需保存 XMM/YMM 寄存器状态
+    const unsigned long long xcr0 = xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)
+        return 0;
+
+    cpuidex(abcd, 7, 0);
+    if ((abcd[1] & 0x20) == 0)          // AVX2
+        return 0;
+    if ((abcd[1] & 0x100) == 0)         // BMI2
+        return 501;
+
+    // AVX-512F + AVX-512BW, 操作系统需保存 opmask/ZMM 寄存器状态
+    if ((abcd[1] & 0x40010000) == 0x40010000 && (xcr0 & 0xE0) == 0xE0)
+        return 601;
+
+    return 502;
+}
+
 // SSE1 = 100
 // SSE2 = 200
 // SSE3 = 300, SSSE3 = 301
 // SSE4.1 = 401, SSE4.2 = 402
+// AVX2 = 501, AVX2 + BMI2 = 502
+// AVX-512BW = 601
 extern "C" int get_sse_version()
 {
     int abcd[4] = {0};
     cpuidex(abcd, 1, 0);
 
     if (abcd[2] & 0x100000)         // SSE4.2
-        return 402;
+    {
+        const int avxVer = get_avx_version();
+        return avxVer > 0 ? avxVer : 402;
+    }
     else if (abcd[2] & 0x80000)     // SSE4.1
         return 401;
     else if (abcd[2] & 0x200)       // SSSE3
@@ -15,6 +15,11 @@
 #define _AVS_DECUTILITY_H_
 
 #include <emmintrin.h>  // SSE-2
+#ifdef _MSC_VER
+#include <intrin.h>     // __rdtsc
+#else
+#include <x86intrin.h>  // __rdtsc
+#endif
 #include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -82,6 +87,13 @@ inline int clip3(int val, int minv, int maxv)
 
 #endif
 
+// 读取 CPU 时间戳计数, 用于统计解码各阶段耗时
+// 使用 static, 避免与 AVX2 编译的版本混淆
+static inline int64_t read_cycles()
+{
+    return (int64_t)__rdtsc();
+}
+
 inline void zero_aligned(void* dst, uint32_t size)
 {
     assert(((uintptr_t)dst & 15) == 0);
@@ -120,4 +132,24 @@ inline void zero_block8x8(int16_t* dst)
     _mm_store_si128((__m128i*)(dst + 8 * 7), xmz);
 }
 
+// 反量化后 8x8 系数块中非零系数的分布, 用于选择反变换函数
+enum CoeffShape
+{
+    COEFF_ERROR = 0,    // 码流错误
+    COEFF_ZERO,         // 系数全为 0
+    COEFF_DC,           // 只有 DC 系数非零
+    COEFF_4x4,          // 非零系数都在左上角 4x4 内
+    COEFF_8x8,          // 其它
+};
+
+// nzMask: 所有非零系数的位置索引按位或, 再或上 64 表示存在非零系数
+static inline int coeff_shape(int nzMask)
+{
+    if (nzMask == 0)
+        return COEFF_ZERO;
+    if (nzMask == 64)
+        return COEFF_DC;
+    return (nzMask & 0x24) ? COEFF_8x8 : COEFF_4x4;     // 行号或列号 >= 4
+}
+
 #endif
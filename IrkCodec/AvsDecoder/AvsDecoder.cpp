@@ -109,65 +109,63 @@ alignas(16) static const uint8_t s_WQParam[4][8] =
 //======================================================================================================================
 
 // 更新当前帧解码进度
+// NOTE: 同一帧的进度同一时刻只有一个更新者(帧解码线程, 或重建线程, wavefront 模式下各宏块行按顺序发布进度)
 void DecodingState::update_state(int line)
 {
     if (m_lineReady >= line)
         return;
 
-    irk::Mutex::Guard guard_(m_mutex);
-
-    m_lineReady = line;
+    irk::atomic_store(&m_lineReady, line);
 
-    // 通知已满足条件的参考数据等待者
-    if (m_reqCnt > 0)
+    // 与 wait_line 中的 m_waiterCnt 增加构成 Dekker 式同步: 要么更新者看到等待者, 要么等待者看到新进度
+    atomic_full_fence();
+    if (irk::atomic_load(&m_waiterCnt) > 0)
     {
-        int checkedCnt = m_reqCnt;
-        for (int i = 0; i < MAX_THEAD_CNT; i++)
-        {
-            if (m_reqList[i] != nullptr)
-            {
-                if (m_reqList[i]->m_refLine <= line)
-                {
-                    m_reqList[i]->m_NotifyEvt.set();
-                    m_reqList[i] = nullptr;
-                    m_reqCnt--;
-                }
-                if (--checkedCnt == 0)
-                    break;
-            }
-        }
+        irk::Mutex::Guard guard_(m_mutex);
+        m_cond.notify_all();
     }
-    assert(m_reqCnt >= 0);
 }
 
-// 添加参考数据请求, 等待请求满足
-void DecodingState::wait_request(RefDataReq* req)
+// 等待当前帧解码到 line 行, 先自旋, 仍未满足则阻塞
+void DecodingState::wait_line(int line)
 {
-    if (m_lineReady >= req->m_refLine) // 请求已满足, 快速返回
+    if (irk::atomic_load(&m_lineReady) >= line)
         return;
 
-    req->m_NotifyEvt.reset();
+    // 参考帧与当前帧解码进度通常相差不大, 短暂自旋可以避免大部分线程切换
+    for (int i = 0; i < 1024; i++)
+    {
+        atomic_cpu_pause();
+        if (irk::atomic_load(&m_lineReady) >= line)
+            return;
+    }
 
     irk::Mutex::Guard guard_(m_mutex);
+    irk::atomic_inc(&m_waiterCnt);
+    while (irk::atomic_load(&m_lineReady) < line)
+        m_cond.wait(m_mutex);
+    irk::atomic_dec(&m_waiterCnt);
+}
 
-    if (m_lineReady >= req->m_refLine) // 请求已满足, 快速返回
-        return;
+// 标识当前帧解码完成, 所有等待者返回
+// NOTE: 在锁内置位并通知, 保证 wait_frame_done 返回后(帧可能随即被释放)不再访问本对象
+void DecodingState::set_frame_done()
+{
+    irk::Mutex::Guard guard_(m_mutex);
+    irk::atomic_store(&m_lineReady, INT32_MAX);
+    m_cond.notify_all();
+}
 
-    // 添加请求到列表
-    assert(m_reqCnt < MAX_THEAD_CNT);
-    for (int i = 0; i < MAX_THEAD_CNT; i++)
+// 等待当前帧解码完成
+void DecodingState::wait_frame_done()
+{
+    irk::Mutex::Guard guard_(m_mutex);
+    while (m_lineReady != INT32_MAX)
     {
-        if (m_reqList[i] == nullptr)
-        {
-            m_reqList[i] = req;
-            m_reqCnt++;
-            break;
-        }
+        irk::atomic_inc(&m_waiterCnt);
+        m_cond.wait(m_mutex);
+        irk::atomic_dec(&m_waiterCnt);
     }
-    guard_.unlock();
-
-    // 等待请求条件满足
-    req->m_NotifyEvt.wait();
 }
 
 //======================================================================================================================
@@ -189,6 +187,9 @@ static void avs_default_dealloc(IrkMemBlock* mblock, void*)
     mblock->size = 0;
 }
 
+extern void* alloc_huge_pages(size_t size, int numaNode, size_t* allocSize);
+extern void free_huge_pages(void* pbuf, size_t allocSize);
+
 FrameFactory::FrameFactory()
 {
     m_pfnAlloc = &avs_default_alloc;
@@ -196,6 +197,9 @@ FrameFactory::FrameFactory()
     m_pfnDealloc = &avs_default_dealloc;
     m_deallocParam = nullptr;
     m_bDefAlloc = true;
+    m_hugePage = false;
+    m_numaNode = -1;
+    m_edgePadding = true;
     m_chromaFmt = 0;
     m_lumaWidth = 0;
     m_lumaHeight = 0;
@@ -205,34 +209,46 @@ FrameFactory::FrameFactory()
     m_chromaHeight = 0;
     m_chromaPitch = 0;
     m_chromaSize = 0;
+    m_resShift = 0;
+    m_outFormat = IRK_AVS_OUTPUT_I420;
+    m_outPitch = 0;
+    m_outSize = 0;
     m_generation = 0;
 
-    m_frameCnt = 0;
-    memset(m_frameCache, 0, sizeof(m_frameCache));
-    m_colMvCnt = 0;
-    memset(m_colMvCache, 0, sizeof(m_colMvCache));
-    m_decStateCnt = 0;
-    memset(m_decStateCache, 0, sizeof(m_decStateCache));
+    m_cacheSize = kDefCacheSize;
+    m_frameCache.reserve(kDefCacheSize);
+    m_colMvCache.reserve(kDefCacheSize);
+    m_decStateCache.reserve(kDefCacheSize);
 
-    m_pool.init(sizeof(DecFrame), kCacheSize, alignof(DecFrame));
+    m_pool.init(sizeof(DecFrame), kDefCacheSize, alignof(DecFrame));
 }
 
 FrameFactory::~FrameFactory()
 {
-    for (int i = 0; i < m_frameCnt; i++)
+    for (size_t i = 0; i < m_frameCache.size(); i++)
     {
-        (*m_pfnDealloc)(&m_frameCache[i]->mblock, m_deallocParam);
+        free_frame(m_frameCache[i]);
     }
-    for (int i = 0; i < m_colMvCnt; i++)
+    for (size_t i = 0; i < m_colMvCache.size(); i++)
     {
         delete[] m_colMvCache[i];
     }
-    for (int i = 0; i < m_decStateCnt; i++)
+    for (size_t i = 0; i < m_decStateCache.size(); i++)
     {
         delete m_decStateCache[i];
     }
 }
 
+// 设置各缓存的最大数目
+void FrameFactory::set_cache_size(int cacheSize)
+{
+    irk::Mutex::Guard guard_(m_mutex);
+    m_cacheSize = cacheSize;
+    m_frameCache.reserve(cacheSize);
+    m_colMvCache.reserve(cacheSize);
+    m_decStateCache.reserve(cacheSize);
+}
+
 // 设置自定义内存分配函数
 void FrameFactory::set_alloc_callback(PFN_CodecAlloc pfnAlloc, void* cbparam)
 {
@@ -247,102 +263,232 @@ void FrameFactory::set_dealloc_callback(PFN_CodecDealloc pfnDealloc, void* cbpar
     m_bDefAlloc = false;
 }
 
+// 使用大页内存, numaNode >= 0 时绑定到该 NUMA 节点
+void FrameFactory::set_huge_page(int numaNode)
+{
+    m_hugePage = true;
+    m_numaNode = numaNode;
+}
+
+// 是否预留左右边界填充的空间
+void FrameFactory::set_edge_padding(bool padding)
+{
+    m_edgePadding = padding;
+}
+
 // 配置视频帧大小
-bool FrameFactory::config(int width, int height, int chromaFmt)
+bool FrameFactory::config(int width, int height, int chromaFmt, int resShift, int outFormat)
 {
     // 如果没有变化直接返回
-    if (width == m_lumaWidth && height == m_lumaHeight && chromaFmt == m_chromaFmt)
+    if (width == m_lumaWidth && height == m_lumaHeight && chromaFmt == m_chromaFmt && resShift == m_resShift &&
+        outFormat == m_outFormat)
         return true;
 
+    // 低分辨率解码时, 图像内存按缩小后的宏块大小分配
+    // 填充左右边界时, 左右各预留 8 个字节
+    const int margin = m_edgePadding ? 16 : 0;
     m_chromaFmt = chromaFmt;
+    m_resShift = resShift;
     m_lumaWidth = width;
     m_lumaHeight = height;
-    m_lumaPitch = XmmPitch(width) + 16;                         // 左右边界预留 8 个字节
-    m_lumaSize = m_lumaPitch * YmmPitch(height);
+    m_lumaPitch = XmmPitch(XmmPitch(width) >> resShift) + margin;
+    m_lumaSize = m_lumaPitch * (YmmPitch(height) >> resShift);
 
     if (chromaFmt == AVS_CHROMA_420)
     {
         m_chromaWidth = width >> 1;
         m_chromaHeight = height >> 1;
-        m_chromaPitch = XmmPitch(m_chromaWidth) + 16;           // 左右边界预留 8 个字节
-        m_chromaSize = m_chromaPitch * YmmPitch(height) >> 1;
+        m_chromaPitch = XmmPitch(XmmPitch(m_chromaWidth) >> resShift) + margin;
+        m_chromaSize = m_chromaPitch * (YmmPitch(height) >> (resShift + 1));
     }
     else if (chromaFmt == AVS_CHROMA_422)
     {
         m_chromaWidth = width >> 1;
         m_chromaHeight = height;
-        m_chromaPitch = XmmPitch(m_chromaWidth) + 16;           // 左右边界预留 8 个字节
-        m_chromaSize = m_chromaPitch * YmmPitch(height);
+        m_chromaPitch = XmmPitch(XmmPitch(m_chromaWidth) >> resShift) + margin;
+        m_chromaSize = m_chromaPitch * (YmmPitch(height) >> resShift);
     }
     else
     {
         return false;
     }
 
+    // 转换后的输出图像, 行宽按 32 字节对齐, 转换函数每次处理 32 个像素, 可能写到行尾之外
+    // NV12 的亮度平面直接使用重建图像, 只另外分配交织的 CbCr 平面
+    const int rnd = (1 << resShift) - 1;
+    m_outFormat = outFormat;
+    if (outFormat == IRK_AVS_OUTPUT_NV12)
+    {
+        m_outPitch = YmmPitch((m_chromaWidth + rnd) >> resShift) * 2;
+        m_outSize = m_outPitch * (m_chromaSize / m_chromaPitch);
+    }
+    else if (outFormat == IRK_AVS_OUTPUT_UYVY)
+    {
+        m_outPitch = YmmPitch((m_lumaWidth + rnd) >> resShift) * 2;
+        m_outSize = m_outPitch * (m_lumaSize / m_lumaPitch);
+    }
+    else
+    {
+        m_outPitch = 0;
+        m_outSize = 0;
+    }
+
     // free old data if exists
-    if (m_frameCnt > 0)
+    if (!m_frameCache.empty())
     {
-        for (int i = 0; i < m_frameCnt; i++)
+        for (size_t i = 0; i < m_frameCache.size(); i++)
         {
-            (*m_pfnDealloc)(&m_frameCache[i]->mblock, m_deallocParam);
-            m_pool.dealloc(m_frameCache[i]);
-            m_frameCache[i] = nullptr;
+            free_frame(m_frameCache[i]);
         }
-        m_frameCnt = 0;
+        m_frameCache.clear();
 
-        for (int i = 0; i < m_colMvCnt; i++)
+        for (size_t i = 0; i < m_colMvCache.size(); i++)
         {
             delete[] m_colMvCache[i];
-            m_colMvCache[i] = nullptr;
         }
-        m_colMvCnt = 0;
+        m_colMvCache.clear();
 
-        for (int i = 0; i < m_decStateCnt; i++)
+        for (size_t i = 0; i < m_decStateCache.size(); i++)
         {
-            delete[] m_decStateCache[i];
-            m_decStateCache[i] = nullptr;
+            delete m_decStateCache[i];
         }
-        m_decStateCnt = 0;
+        m_decStateCache.clear();
     }
 
     m_generation++;     // 标记不同的设置
+
+    // 大页模式, 按缓存数目预先分配全部帧, 之前的大页内存在其所有帧释放后释放
+    if (m_hugePage && m_bDefAlloc)
+        prealloc_frames();
+
     return true;
 }
 
+// 大页模式下预先分配全部帧, 连续存放在一块大页内存中
+void FrameFactory::prealloc_frames()
+{
+    const int frameCnt = m_cacheSize;
+    const size_t blockSize = ((size_t)m_lumaSize + m_chromaSize * 2 + m_lumaPitch * 4 + 64 + m_outSize + 63) & ~(size_t)63;
+
+    size_t allocSize = 0;
+    void* pbuf = alloc_huge_pages(blockSize * frameCnt, m_numaNode, &allocSize);
+    if (!pbuf)  // 失败则按需单独分配
+        return;
+
+    FrameArena* arena = new FrameArena;
+    arena->buf = pbuf;
+    arena->size = allocSize;
+    arena->frameCnt = frameCnt;
+
+    for (int i = 0; i < frameCnt; i++)
+    {
+        IrkMemBlock mblock = {};
+        mblock.buf = (uint8_t*)pbuf + blockSize * i;
+        mblock.size = blockSize;
+        m_frameCache.push_back(new_frame(mblock, arena));
+    }
+}
+
+// 使用已分配的内存创建 DecFrame
+DecFrame* FrameFactory::new_frame(const IrkMemBlock& mblock, FrameArena* arena)
+{
+    // NOTE: 为了增强解码器稳定性, 避免错误码流导致内存越界, 多分配了一些内存
+    const int frameSize = m_lumaSize + m_chromaSize * 2 + m_lumaPitch * 4 + 64;
+    uint8_t* buf = (uint8_t*)mblock.buf + m_lumaPitch * 2 + 32;
+
+    DecFrame* pFrame = (DecFrame*)m_pool.alloc();
+    memset(pFrame, 0, sizeof(DecFrame));
+    pFrame->recPlane[0] = buf;
+    pFrame->recPlane[1] = buf + m_lumaSize;
+    pFrame->recPlane[2] = buf + m_lumaSize + m_chromaSize;
+    pFrame->recPitch[0] = m_lumaPitch;
+    pFrame->recPitch[1] = m_chromaPitch;
+    pFrame->recPitch[2] = m_chromaPitch;
+    pFrame->mblock = mblock;
+    pFrame->arena = arena;
+
+    // 输出图像, 位于重建图像之后
+    uint8_t* outBuf = (uint8_t*)mblock.buf + frameSize;
+    if (m_outFormat == IRK_AVS_OUTPUT_NV12)
+    {
+        pFrame->plane[0] = pFrame->recPlane[0];
+        pFrame->plane[1] = outBuf;
+        pFrame->pitch[0] = m_lumaPitch;
+        pFrame->pitch[1] = m_outPitch;
+    }
+    else if (m_outFormat == IRK_AVS_OUTPUT_UYVY)
+    {
+        pFrame->plane[0] = outBuf;
+        pFrame->pitch[0] = m_outPitch;
+    }
+    else
+    {
+        memcpy(pFrame->plane, pFrame->recPlane, sizeof(pFrame->recPlane));
+        memcpy(pFrame->pitch, pFrame->recPitch, sizeof(pFrame->recPitch));
+    }
+    if (m_outFormat != IRK_AVS_OUTPUT_I420)
+        pFrame->rowConverted = new uint8_t[YmmPitch(m_lumaHeight) >> 4];
+
+    return pFrame;
+}
+
+// 释放 DecFrame 及其内存, 大页内存中的帧全部释放后释放整块内存
+void FrameFactory::free_frame(DecFrame* pFrame)
+{
+    FrameArena* arena = pFrame->arena;
+    if (arena)
+    {
+        if (--arena->frameCnt == 0)
+        {
+            free_huge_pages(arena->buf, arena->size);
+            delete arena;
+        }
+    }
+    else
+    {
+        (*m_pfnDealloc)(&pFrame->mblock, m_deallocParam);
+    }
+    delete[] pFrame->rowConverted;
+    m_pool.dealloc(pFrame);
+}
+
 // 创建一帧 DecFrame, isRef: 是否为参考帧
 DecFrame* FrameFactory::create(bool isRef)
 {
     irk::Mutex::Guard guard_(m_mutex);
     DecFrame* pFrame = nullptr;
 
-    if (m_frameCnt > 0) // 回收之前丢弃的帧
+    if (!m_frameCache.empty()) // 回收之前丢弃的帧
     {
-        pFrame = m_frameCache[--m_frameCnt];
-        m_frameCache[m_frameCnt] = nullptr;
+        pFrame = m_frameCache.back();
+        m_frameCache.pop_back(1);
     }
-    else
+    else    // 大页内存中的帧都在使用中时, 单独分配
     {
-        // NOTE: 为了增强解码器稳定性, 避免错误码流导致内存越界, 多分配了一些内存
         int frameSize = m_lumaSize + m_chromaSize * 2 + m_lumaPitch * 4 + 64;
-        IrkMemBlock mblock = (*m_pfnAlloc)(frameSize, 32, m_allocParam);
-        uint8_t* buf = (uint8_t*)mblock.buf + m_lumaPitch * 2 + 32;
-
-        pFrame = (DecFrame*)m_pool.alloc();
-        memset(pFrame, 0, sizeof(DecFrame));
-        pFrame->plane[0] = buf;
-        pFrame->plane[1] = buf + m_lumaSize;
-        pFrame->plane[2] = buf + m_lumaSize + m_chromaSize;
-        pFrame->width[0] = m_lumaWidth;
-        pFrame->width[1] = m_chromaWidth;
-        pFrame->width[2] = m_chromaWidth;
-        pFrame->height[0] = m_lumaHeight;
-        pFrame->height[1] = m_chromaHeight;
-        pFrame->height[2] = m_chromaHeight;
-        pFrame->pitch[0] = m_lumaPitch;
-        pFrame->pitch[1] = m_chromaPitch;
-        pFrame->pitch[2] = m_chromaPitch;
-        pFrame->mblock = mblock;
-    }
+        IrkMemBlock mblock = (*m_pfnAlloc)(frameSize + m_outSize, 32, m_allocParam);
+        pFrame = new_frame(mblock, nullptr);
+    }
+
+    // 缩略图模式输出时会修改宽高, 回收的帧需要重新设置
+    // 低分辨率解码时为缩小后的宽高
+    const int rnd = (1 << m_resShift) - 1;
+    // NV12 的 CbCr 平面宽度为 CbCr 对数, UYVY 只有一个平面
+    pFrame->width[0] = (m_lumaWidth + rnd) >> m_resShift;
+    pFrame->width[1] = (m_chromaWidth + rnd) >> m_resShift;
+    pFrame->width[2] = (m_chromaWidth + rnd) >> m_resShift;
+    pFrame->height[0] = (m_lumaHeight + rnd) >> m_resShift;
+    pFrame->height[1] = (m_chromaHeight + rnd) >> m_resShift;
+    pFrame->height[2] = (m_chromaHeight + rnd) >> m_resShift;
+    if (m_outFormat != IRK_AVS_OUTPUT_I420)
+    {
+        pFrame->width[2] = pFrame->height[2] = 0;
+        if (m_outFormat == IRK_AVS_OUTPUT_UYVY)
+            pFrame->width[1] = pFrame->height[1] = 0;
+        memset(pFrame->rowConverted, 0, YmmPitch(m_lumaHeight) >> 4);
+    }
+    pFrame->sliceError = 0;
+    pFrame->rowsNotified = 0;
 
     // 参考帧
     if (isRef)
@@ -350,10 +496,10 @@ DecFrame* FrameFactory::create(bool isRef)
         assert(pFrame->colMvs == nullptr);
 
         // 分配存储 BDColMvs 的内存
-        if (m_colMvCnt > 0)        // 回收之前丢弃的数据
+        if (!m_colMvCache.empty())     // 回收之前丢弃的数据
         {
-            pFrame->colMvs = m_colMvCache[--m_colMvCnt];
-            m_colMvCache[m_colMvCnt] = nullptr;
+            pFrame->colMvs = m_colMvCache.back();
+            m_colMvCache.pop_back(1);
         }
         else
         {
@@ -365,10 +511,10 @@ DecFrame* FrameFactory::create(bool isRef)
 
     // 解码状态, 用于并行解码跟踪参考帧状态
     assert(pFrame->decState == nullptr);
-    if (m_decStateCnt > 0)     // 回收之前丢弃的数据
+    if (!m_decStateCache.empty())  // 回收之前丢弃的数据
     {
-        pFrame->decState = m_decStateCache[--m_decStateCnt];
-        m_decStateCache[m_decStateCnt] = nullptr;
+        pFrame->decState = m_decStateCache.back();
+        m_decStateCache.pop_back(1);
         pFrame->decState->reset();
     }
     else
@@ -392,8 +538,8 @@ void FrameFactory::discard(DecFrame* pFrame)
     // 释放 BDColMvs
     if (pFrame->colMvs)
     {
-        if (m_colMvCnt < kCacheSize && pFrame->generation == m_generation)
-            m_colMvCache[m_colMvCnt++] = pFrame->colMvs;
+        if ((int)m_colMvCache.size() < m_cacheSize && pFrame->generation == m_generation)
+            m_colMvCache.push_back(pFrame->colMvs);
         else
             delete[] pFrame->colMvs;
         pFrame->colMvs = nullptr;
@@ -402,22 +548,22 @@ void FrameFactory::discard(DecFrame* pFrame)
     // 释放解码进度状态
     if (pFrame->decState)
     {
-        if (m_decStateCnt < kCacheSize)
-            m_decStateCache[m_decStateCnt++] = pFrame->decState;
+        if ((int)m_decStateCache.size() < m_cacheSize)
+            m_decStateCache.push_back(pFrame->decState);
         else
             delete pFrame->decState;
         pFrame->decState = nullptr;
     }
 
-    // 如果使用缺省内存分配函数, 缓存内存块以便后续复用
-    if (m_bDefAlloc && m_frameCnt < kCacheSize && pFrame->generation == m_generation)
+    // 如果使用缺省内存分配函数, 缓存内存块以便后续复用, 大页内存中的帧总是缓存
+    if (pFrame->generation == m_generation &&
+        (pFrame->arena != nullptr || (m_bDefAlloc && (int)m_frameCache.size() < m_cacheSize)))
     {
-        m_frameCache[m_frameCnt++] = pFrame;
+        m_frameCache.push_back(pFrame);
     }
     else
     {
-        (*m_pfnDealloc)(&pFrame->mblock, m_deallocParam);
-        m_pool.dealloc(pFrame);
+        free_frame(pFrame);
     }
 }
 
@@ -425,6 +571,7 @@ void FrameFactory::discard(DecFrame* pFrame)
 FrmDecContext::FrmDecContext()
 {
     this->avsCtx = nullptr;
+    this->kernels = nullptr;
     this->picWidth = 0;
     this->picHeight = 0;
     this->chromaFmt = 0;
@@ -448,6 +595,11 @@ FrmDecContext::FrmDecContext()
     this->coeff = (int16_t*)(buf + 2048 + 1024 + 256);
 
     this->decTask = nullptr;
+    this->reconJob = nullptr;
+    this->profiling = 0;
+    this->keyOnly = 0;
+    this->resShift = 0;
+    this->stats.reset();
 }
 
 FrmDecContext::~FrmDecContext()
@@ -469,17 +621,18 @@ FrmDecContext::~FrmDecContext()
         assert(this->decTask->ref_count() == 1);
         this->decTask->dismiss();
     }
+
+    if (this->reconJob)
+        delete this->reconJob;
 }
 
-FrmCtxFactory::FrmCtxFactory()
+FrmCtxFactory::FrmCtxFactory() : m_cacheSize(kDefCacheSize), m_ctxCache(kDefCacheSize)
 {
-    m_ctxCnt = 0;
-    memset(m_ctxCache, 0, sizeof(m_ctxCache));
 }
 
 FrmCtxFactory::~FrmCtxFactory()
 {
-    for (int i = 0; i < m_ctxCnt; i++)
+    for (size_t i = 0; i < m_ctxCache.size(); i++)
         delete m_ctxCache[i];
 }
 
@@ -487,10 +640,10 @@ FrmCtxFactory::~FrmCtxFactory()
 FrmDecContext* FrmCtxFactory::create()
 {
     FrmDecContext* ctx = nullptr;
-    if (m_ctxCnt > 0)
+    if (!m_ctxCache.empty())
     {
-        ctx = m_ctxCache[--m_ctxCnt];
-        m_ctxCache[m_ctxCnt] = nullptr;
+        ctx = m_ctxCache.back();
+        m_ctxCache.pop_back(1);
     }
     else
     {
@@ -502,10 +655,9 @@ FrmDecContext* FrmCtxFactory::create()
 // 丢弃单帧解码 context
 void FrmCtxFactory::discard(FrmDecContext* ctx)
 {
-    if (m_ctxCnt < kCacheSize)
+    if ((int)m_ctxCache.size() < m_cacheSize)
     {
-        m_ctxCache[m_ctxCnt] = ctx;
-        m_ctxCnt++;
+        m_ctxCache.push_back(ctx);
     }
     else
     {
@@ -518,6 +670,7 @@ inline FrmDecContext* create_frame_ctx(AvsContext* avsCtx)
 {
     FrmDecContext* ctx = avsCtx->ctxFactory.create();
     ctx->avsCtx = avsCtx;
+    ctx->stats.reset();
     assert(ctx->curFrame == nullptr);
     assert(ctx->refFrames[0] == nullptr);
     assert(ctx->refFrames[1] == nullptr);
@@ -559,92 +712,91 @@ private:
 //======================================================================================================================
 
 // 查找 start code, 返回 start code 所在位置, 找不到返回输入数据长度
-static int find_start_code(uint8_t* data, int size)
+static int find_start_code(PFN_FindScCandidate pfnFind, uint8_t* data, int size)
 {
-    uint32_t sc32 = 0xFFFFFFFF;
-    for (int i = 0; i < size; i++)
+    int i = 0;
+    while (1)
     {
-        sc32 = (sc32 << 8) | data[i];
-        if (sc32 <= 0x1FF)     // 找到 start code
-        {
-            assert(i >= 3);
-            return i - 3;
-        }
+        i += (*pfnFind)(data + i, size - i);
+        if (i + 3 >= size)
+            return size;
+        if (data[i + 2] == 0x1)     // 找到 start code
+            return i;
+        i++;                        // 伪起始码, 继续查找
     }
-    return size;
 };
 
 // 查找下一个 start code, 返回下一个 start code 所在位置, 找不到返回输入数据长度
-static int find_next_start_code(uint8_t* data, int size)
+static int find_next_start_code(PFN_FindScCandidate pfnFind, uint8_t* data, int size)
 {
     assert(size > 4);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
 
-    uint32_t sc32 = 0xFFFFFFFF;
-    for (int i = 4; i < size; i++)
+    int i = 4;
+    while (1)
     {
-        sc32 = (sc32 << 8) | data[i];
-        if ((sc32 & 0xFFFFFF) == 0x1)  // 找到下一个 start code
-        {
-            assert(i >= 6);
-            return i - 2;
-        }
+        i += (*pfnFind)(data + i, size - i);
+        if (i >= size)
+            return size;
+        if (data[i + 2] == 0x1)     // 找到下一个 start code
+            return i;
+        i++;                        // 伪起始码, 继续查找
     }
-    return size;
 };
 
 // 查找下一个 picture, 返回所在位置, 找不到返回输入数据长度
-static int find_next_picture(uint8_t* data, int size)
+static int find_next_picture(PFN_FindScCandidate pfnFind, uint8_t* data, int size)
 {
     assert(size > 4);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
 
-    uint32_t sc32 = 0xFFFFFFFF;
-    for (int i = 4; i < size; i++)
+    int i = 4;
+    while (1)
     {
-        sc32 = (sc32 << 8) | data[i];
-        if (sc32 <= 0x1FF)     // 找到 start code
+        i += (*pfnFind)(data + i, size - i);
+        if (i + 3 >= size)
+            return size;
+        if (data[i + 2] == 0x1)     // 找到 start code
         {
             // 找到序列头, 图像头, 视频编辑码
-            if (sc32 == 0x1B0 || sc32 == 0x1B3 || sc32 == 0x1B6 || sc32 == 0x1B7)
-                return i - 3;
+            const uint8_t scode = data[i + 3];
+            if (scode == 0xB0 || scode == 0xB3 || scode == 0xB6 || scode == 0xB7)
+                return i;
         }
+        i++;
     }
-    return size;
 };
 
 // 去除 AVS 伪起始码
 // 返回已处理的原始数据长度, *plen 赋值为处理后的数据长度
-static int remove_faked_start_code(uint8_t* data, int size, int* pLen)
+static int remove_faked_start_code(PFN_FindScCandidate pfnFind, uint8_t* data, int size, int* pLen)
 {
     assert(data[0] == 0x2 && size > 0);
     AvsBitWriter bitsw;
     bitsw.setup(data);    // 初始化, 写出 6 个比特的 0
 
-    uint32_t sc32 = 0xFFFFFFFF;
-    for (int i = 1; i < size; i++)
+    int i = 1;
+    while (i < size)
     {
-        sc32 = (sc32 << 8) | data[i];
-        sc32 &= 0xFFFFFF;
-        if (sc32 > 0x2)            // 正常数据
+        // 下一个起始码或伪起始码之前都是正常数据, 成批写出
+        // 00 00 00 实为码流错误, 为了增强容错性, 作为正常数据
+        const int k = i + (*pfnFind)(data + i, size - i);
+        if (k >= size)
         {
-            bitsw.write_byte(data[i]);
+            bitsw.write_bytes(data + i, size - i);
+            break;
         }
-        else if (sc32 == 0x1)      // 下一个起始码
+        bitsw.write_bytes(data + i, k + 2 - i);
+        i = k + 2;
+
+        if (data[i] == 0x1)         // 下一个起始码
         {
-            assert(i >= 3);
             bitsw.make_byte_aligned();
             *pLen = bitsw.get_size() - 2;
             return i - 2;
         }
-        else if (sc32 == 0x2)      // 伪起始码
-        {
-            bitsw.write_6bits(data[i]);
-        }
-        else
-        {
-            bitsw.write_byte(0);  // 实为码流错误, 为了增强容错性, 无视
-        }
+        bitsw.write_6bits(data[i]); // 伪起始码
+        i++;
     }
 
     bitsw.make_byte_aligned();
@@ -654,40 +806,33 @@ static int remove_faked_start_code(uint8_t* data, int size, int* pLen)
 
 // 查找下一个 start code 并去除当前 start code unit 里面的伪起始码
 // 返回当前 start code unit 原始数据长度, *pLen 为处理后的 start code unit 长度
-static int split_and_purify_sc_unit(uint8_t* data, int size, int* pLen)
+static int split_and_purify_sc_unit(PFN_FindScCandidate pfnFind, uint8_t* data, int size, int* pLen)
 {
     assert(size > 4);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
 
-    uint32_t sc32 = 0xFFFFFFFF;
-    for (int i = 4; i < size; i++)
+    int i = 4 + (*pfnFind)(data + 4, size - 4);
+    if (i < size)
     {
-        sc32 = (sc32 << 8) | data[i];
-        if ((sc32 & 0xFFFFFF) <= 0x2)
+        if (data[i + 2] == 0x1)     // 找到下一个 start code
         {
-            if (data[i] == 0x1)        // 找到下一个 start code
-            {
-                *pLen = i - 2;
-                return i - 2;
-            }
-            else if (data[i] == 0x2)   // 伪起始码
-            {
-                int lens = 0;
-                int used = remove_faked_start_code(data + i, size - i, &lens);
-                assert(lens > 0 && used >= lens);
-                lens += i;
-                used += i;
-
-                // 填充 0 有助于解码时数据末尾检测               
-                for (int j = lens; j < used; j++)
-                    data[j] = 0;
-                *pLen = lens;
-                return used;
-            }
-            else
-            {
-                // 实为码流错误, 为了增强容错性, 忽略
-            }
+            *pLen = i;
+            return i;
+        }
+        else                        // 伪起始码
+        {
+            i += 2;
+            int lens = 0;
+            int used = remove_faked_start_code(pfnFind, data + i, size - i, &lens);
+            assert(lens > 0 && used >= lens);
+            lens += i;
+            used += i;
+
+            // 填充 0 有助于解码时数据末尾检测               
+            for (int j = lens; j < used; j++)
+                data[j] = 0;
+            *pLen = lens;
+            return used;
         }
     }
 
@@ -696,6 +841,64 @@ static int split_and_purify_sc_unit(uint8_t* data, int size, int* pLen)
     return size;
 }
 
+// 零拷贝输入模式下查找下一个 start code, 不修改输入数据
+// 不含伪起始码的 start code unit 直接引用输入数据, 否则复制到 ctx->dataBuf 后去除伪起始码
+// 返回当前 start code unit 原始数据长度, *pData 和 *pLen 为处理后的 start code unit 地址和长度
+static int split_sc_unit_zero_copy(FrmDecContext* ctx, uint8_t* data, int size, uint8_t** pData, int* pLen)
+{
+    assert(size > 4);
+    assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
+
+    const PFN_FindScCandidate pfnFind = ctx->avsCtx->pfnFindSc;
+    int unitLen = size;
+    bool faked = false;
+    int i = 4;
+    while (1)
+    {
+        i += (*pfnFind)(data + i, size - i);
+        if (i >= size)
+            break;
+        if (data[i + 2] == 0x1)     // 找到下一个 start code
+        {
+            unitLen = i;
+            break;
+        }
+        faked = true;               // 伪起始码
+        i++;
+    }
+
+    if (!faked)     // 绝大多数 start code unit 不含伪起始码, 直接引用输入数据
+    {
+        *pData = data;
+        *pLen = unitLen;
+        return unitLen;
+    }
+
+    // 复制到内部缓存, 预留 4K 空间, 避免错误的码流导致内存越界
+    DataVector& buf = ctx->dataBuf;
+    const size_t offset = buf.size();
+    if (offset + unitLen + 8 + 4096 > buf.capacity())
+    {
+        uint8_t* oldBuf = buf.data();
+        buf.reserve(std::max(buf.capacity() * 3 / 2, offset + unitLen + 8192));
+
+        // 内部缓存重新分配, 更新已分割出的 slice 地址
+        SliceVector& sliVec = ctx->sliceVec;
+        for (size_t i = 0; i < sliVec.size(); i++)
+        {
+            if (sliVec[i].data >= oldBuf && sliVec[i].data < oldBuf + offset)
+                sliVec[i].data = buf.data() + (sliVec[i].data - oldBuf);
+        }
+    }
+    buf.push_back(data, unitLen);
+    buf.resize(offset + unitLen + 8);
+    *(uint64_t*)(buf.data() + offset + unitLen) = 0;    // 填充 0 有助于解码时数据末尾检测
+
+    *pData = buf.data() + offset;
+    split_and_purify_sc_unit(pfnFind, *pData, unitLen, pLen);
+    return unitLen;
+}
+
 // 解析sequence header 并检测是否正确, 解码器是否支持
 static int parse_and_check_seqhdr(AvsSeqHdr* hdr, const uint8_t* data, int size)
 {
@@ -799,7 +1002,7 @@ static int begin_sequence_decoding(AvsContext* ctx, const uint8_t* data, int siz
             return errc;
 
         // 配置视频帧缓存
-        ctx->frmFactory.config(seqHdr.width, seqHdr.height, seqHdr.chroma_format);
+        ctx->frmFactory.config(seqHdr.width, seqHdr.height, seqHdr.chroma_format, ctx->resShift, ctx->outFormat);
     }
     else    // sequence header 已解析, 查看是否发生变化
     {
@@ -822,7 +1025,7 @@ static int begin_sequence_decoding(AvsContext* ctx, const uint8_t* data, int siz
             end_sequence_decoding(ctx);
 
             // 重新配置视频帧缓存
-            ctx->frmFactory.config(newHdr.width, newHdr.height, newHdr.chroma_format);
+            ctx->frmFactory.config(newHdr.width, newHdr.height, newHdr.chroma_format, ctx->resShift, ctx->outFormat);
         }
 
         // 复制新的 sequence header
@@ -877,12 +1080,12 @@ static int begin_frame_decoding(FrmDecContext* frmCtx)
         frmCtx->picWidth = avsCtx->frameWidth;
         frmCtx->picHeight = avsCtx->frameHeight;
         frmCtx->invScan = s_InvScan;
-        frmCtx->picPlane[0] = curFrame->plane[0];
-        frmCtx->picPlane[1] = curFrame->plane[1];
-        frmCtx->picPlane[2] = curFrame->plane[2];
-        frmCtx->picPitch[0] = curFrame->pitch[0];
-        frmCtx->picPitch[1] = curFrame->pitch[1];
-        frmCtx->picPitch[2] = curFrame->pitch[2];
+        frmCtx->picPlane[0] = curFrame->recPlane[0];
+        frmCtx->picPlane[1] = curFrame->recPlane[1];
+        frmCtx->picPlane[2] = curFrame->recPlane[2];
+        frmCtx->picPitch[0] = curFrame->recPitch[0];
+        frmCtx->picPitch[1] = curFrame->recPitch[1];
+        frmCtx->picPitch[2] = curFrame->recPitch[2];
     }
     else    // 场编码
     {
@@ -897,19 +1100,19 @@ static int begin_frame_decoding(FrmDecContext* frmCtx)
 
         if (picHdr.top_field_first)    // 顶场在前
         {
-            frmCtx->picPlane[0] = curFrame->plane[0];
-            frmCtx->picPlane[1] = curFrame->plane[1];
-            frmCtx->picPlane[2] = curFrame->plane[2];
+            frmCtx->picPlane[0] = curFrame->recPlane[0];
+            frmCtx->picPlane[1] = curFrame->recPlane[1];
+            frmCtx->picPlane[2] = curFrame->recPlane[2];
         }
         else    // 底场在前
         {
-            frmCtx->picPlane[0] = curFrame->plane[0] + curFrame->pitch[0];
-            frmCtx->picPlane[1] = curFrame->plane[1] + curFrame->pitch[1];
-            frmCtx->picPlane[2] = curFrame->plane[2] + curFrame->pitch[2];
+            frmCtx->picPlane[0] = curFrame->recPlane[0] + curFrame->recPitch[0];
+            frmCtx->picPlane[1] = curFrame->recPlane[1] + curFrame->recPitch[1];
+            frmCtx->picPlane[2] = curFrame->recPlane[2] + curFrame->recPitch[2];
         }
-        frmCtx->picPitch[0] = curFrame->pitch[0] * 2;
-        frmCtx->picPitch[1] = curFrame->pitch[1] * 2;
-        frmCtx->picPitch[2] = curFrame->pitch[2] * 2;
+        frmCtx->picPitch[0] = curFrame->recPitch[0] * 2;
+        frmCtx->picPitch[1] = curFrame->recPitch[1] * 2;
+        frmCtx->picPitch[2] = curFrame->recPitch[2] * 2;
     }
 
     // 色差宽度和高度
@@ -929,14 +1132,15 @@ static int begin_frame_decoding(FrmDecContext* frmCtx)
     frmCtx->frameCoding = picHdr.picture_structure;
     frmCtx->fieldIdx = 0;
 
-    // 设置有效参考范围, 左右边界有 8 字节填充
-    frmCtx->refRcLuma.x1 = -8;
+    // 设置有效参考范围, 填充边界时左右边界有 8 字节填充, 否则只能使用图像内的数据
+    const int margin = avsCtx->edgePadding ? 8 : 0;
+    frmCtx->refRcLuma.x1 = avsCtx->edgePadding ? -8 : -1;
     frmCtx->refRcLuma.y1 = -1;
-    frmCtx->refRcLuma.x2 = frmCtx->picWidth + 8;
+    frmCtx->refRcLuma.x2 = frmCtx->picWidth + margin;
     frmCtx->refRcLuma.y2 = frmCtx->picHeight;
-    frmCtx->refRcCbcr.x1 = -8;
+    frmCtx->refRcCbcr.x1 = avsCtx->edgePadding ? -8 : -1;
     frmCtx->refRcCbcr.y1 = -1;
-    frmCtx->refRcCbcr.x2 = frmCtx->chromaWidth + 8;
+    frmCtx->refRcCbcr.x2 = frmCtx->chromaWidth + margin;
     frmCtx->refRcCbcr.y2 = frmCtx->chromaHeight;
 
     // 设置 weight quant matrix
@@ -975,19 +1179,30 @@ static int begin_frame_decoding(FrmDecContext* frmCtx)
     }
 
     // 码流本身或者用户禁用环路滤波
-    frmCtx->lfDisabled = picHdr.loop_filter_disable | avsCtx->config.disable_lf;
+    // 缩略图模式只使用 DC 系数重建, 低分辨率解码时块边界不再对应, 同样不做环路滤波
+    frmCtx->resShift = avsCtx->resShift;
+    frmCtx->lfDisabled = picHdr.loop_filter_disable | avsCtx->config.disable_lf | avsCtx->config.thumbnail;
+    frmCtx->lfDisabled |= (avsCtx->resShift != 0);
+
+    // 两级流水线模式, 当前线程只解析, 像素处理由重建任务完成
+    // wavefront 模式, 多个重建任务同时重建不同的宏块行
+    if ((avsCtx->config.pipeline || avsCtx->config.wavefront) && avsCtx->threadCnt > 1 && frmCtx->reconJob == nullptr)
+    {
+        const int workerCnt = avsCtx->config.wavefront ? avsCtx->threadCnt - 1 : 1;
+        frmCtx->reconJob = new ReconJob(frmCtx, workerCnt);
+    }
+    frmCtx->profiling = avsCtx->config.enable_stats;
+    frmCtx->keyOnly = avsCtx->config.thumbnail || avsCtx->skipMode == IRK_AVS_DEC_SKIP_NONKEY;
+    if (frmCtx->reconJob)
+        frmCtx->kernels = &g_RecordKernels;
+    else
+        frmCtx->kernels = frmCtx->profiling ? &g_ProfKernels : &avsCtx->kernels;
 
     if (picHdr.aec_enable) // 高级熵编码
     {
         if (frmCtx->aecParser == nullptr)
             frmCtx->aecParser = new AvsAecParser;
         frmCtx->aecParser->set_scan_quant_matrix(frmCtx->invScan, frmCtx->wqMatrix);
-
-        // AVS+ 高级熵编码的设计, 如果码流错误, 存在大量的连续 0 可能导致内存越界
-        uint8_t* picData = frmCtx->dataBuf.data();
-        size_t picSize = frmCtx->dataBuf.size();
-        assert(frmCtx->dataBuf.capacity() >= picSize + 4096);
-        memset(picData + picSize + 8, 0xFF, 4096 - 8);
     }
     else // VLC 编码
     {
@@ -999,11 +1214,73 @@ static int begin_frame_decoding(FrmDecContext* frmCtx)
     return 0;
 }
 
+extern void downscale_8x8_sse4(uint8_t* plane, int pitch, int width, int height);
+extern void convert_frame(const AvsContext* avsCtx, DecFrame* frame, bool fieldCoding);
+extern void convert_missed_rows(FrmDecContext* ctx);
+
+// 缩略图模式, 原地缩小为 1/8 宽高, 再转换为输出格式
+static void make_thumbnail(const AvsContext* avsCtx, DecFrame* frame)
+{
+    // 输出格式可能不是 I420, 重建图像的宽高由亮度宽高计算
+    const int width[3] = {frame->width[0], frame->width[0] >> 1, frame->width[0] >> 1};
+    const int height[3] = {frame->height[0], frame->height[0] >> 1, frame->height[0] >> 1};
+    for (int k = 0; k < 3; k++)
+    {
+        downscale_8x8_sse4(frame->recPlane[k], frame->recPitch[k], width[k], height[k]);
+        if (frame->width[k] > 0)
+        {
+            frame->width[k] = (width[k] + 7) >> 3;
+            frame->height[k] = (height[k] + 7) >> 3;
+        }
+    }
+
+    if (avsCtx->outFormat != IRK_AVS_OUTPUT_I420)
+        convert_frame(avsCtx, frame, false);
+}
+
+// 当前帧解码进度推进到 line 行(按帧计算的原始分辨率亮度行)后, 通知用户新完成的输出图像行
+// NOTE: 同一帧同一时刻只有一个调用者, 与更新解码进度相同
+void notify_decoded_rows(FrmDecContext* ctx, int line)
+{
+    DecFrame* frame = ctx->curFrame;
+    const int lineEnd = std::min(line >> ctx->resShift, frame->height[0]);
+    if (lineEnd <= frame->rowsNotified)
+        return;
+
+    IrkAvsDecedRows rows;
+    rows.pic = frame;
+    rows.line_beg = frame->rowsNotified;
+    rows.line_end = lineEnd;
+    frame->rowsNotified = lineEnd;
+
+    AvsContext* avsCtx = ctx->avsCtx;
+    (*avsCtx->pfnNotify)(IRK_AVS_DEC_ROWS_READY, &rows, avsCtx->notifyParam);
+}
+
 // 结束一帧的解码, 输出解码后的视频帧给用户, 需要在主线程调用
 static void end_frame_decoding(FrmDecContext* frmCtx)
 {
     AvsContext* avsCtx = frmCtx->avsCtx;
 
+    // 汇总解码统计数据
+    if (frmCtx->profiling)
+    {
+        frmCtx->stats.frames = 1;
+        avsCtx->stats.merge(frmCtx->stats);
+    }
+
+    // 码流错误或缺少 slice 时部分宏块行没有逐行转换, 此时补充转换
+    if (avsCtx->rowConvert)
+        convert_missed_rows(frmCtx);
+
+    // 逐行通知时补充通知剩余的图像行, 包括码流错误没有解码的宏块行
+    if (avsCtx->rowNotify)
+        notify_decoded_rows(frmCtx, INT32_MAX);
+
+    // 缩略图模式只解码 I 帧, 之后的帧不会再参考当前帧
+    if (avsCtx->config.thumbnail)
+        make_thumbnail(avsCtx, frmCtx->curFrame);
+
     if (frmCtx->picHdr.pic_type == PIC_TYPE_B || avsCtx->config.output_order != 0 || avsCtx->seqHdr.low_delay)
     {
         // B 帧或者用户要求按编码顺序输出, 立即输出当前帧
@@ -1021,6 +1298,14 @@ static void end_frame_decoding(FrmDecContext* frmCtx)
         }
         avsCtx->outFrame = frmCtx->curFrame;
         frmCtx->curFrame = nullptr;
+
+        // 只解码 I 帧时, 之后解码的帧显示顺序都在当前帧之后, 立即输出
+        if (frmCtx->keyOnly)
+        {
+            (*avsCtx->pfnNotify)(IRK_CODEC_DONE, avsCtx->outFrame, avsCtx->notifyParam);
+            avsCtx->outFrame->dismiss();
+            avsCtx->outFrame = nullptr;
+        }
     }
 }
 
@@ -1099,6 +1384,131 @@ extern void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size
     (dst)[1] = (src1)[1] + (src2)[1];   \
     (dst)[2] = (src1)[2] + (src2)[2]; }while(0)
 
+// 场编码时返回第二场的第一个 slice 的索引, 否则返回 slice 总数
+static int second_field_slice(const FrmDecContext* ctx)
+{
+    const SliceVector& sliVec = ctx->sliceVec;
+    int sIdx = 0;
+    if (ctx->frameCoding == 0)
+    {
+        while (sIdx < (int)sliVec.size() && sliVec[sIdx].data[3] < ctx->mbRowCnt)
+            sIdx++;
+        return sIdx;
+    }
+    return (int)sliVec.size();
+}
+
+// 复制帧/场级解码参数到重建任务使用的 context
+static void copy_pic_params(FrmDecContext* dst, const FrmDecContext* src)
+{
+    // 分配解码使用的内部空间
+    if (dst->picWidth != src->picWidth)
+    {
+        if (dst->topMbBuf[0])
+        {
+            irk::aligned_free(dst->topMbBuf[0]);
+            dst->topMbBuf[0] = nullptr;
+        }
+        const int colCnt = src->mbColCnt + 2;
+        dst->topMbBuf[0] = (MbContext*)irk::aligned_malloc(sizeof(MbContext) * 2 * colCnt, 16);
+        dst->topMbBuf[1] = dst->topMbBuf[0] + colCnt;
+    }
+
+    dst->avsCtx = src->avsCtx;
+    dst->kernels = src->kernels;
+    dst->profiling = src->profiling;
+    dst->keyOnly = src->keyOnly;
+    dst->picHdr = src->picHdr;
+    dst->curFrame = src->curFrame;          // 不持有引用, 解码结束后清除
+    dst->picWidth = src->picWidth;
+    dst->picHeight = src->picHeight;
+    dst->chromaFmt = src->chromaFmt;
+    dst->chromaWidth = src->chromaWidth;
+    dst->chromaHeight = src->chromaHeight;
+    dst->pFieldSkip = src->pFieldSkip;
+    dst->bFieldEnhance = src->bFieldEnhance;
+    COPY3X(dst->picPlane, src->picPlane);
+    COPY3X(dst->picPitch, src->picPitch);
+    dst->resShift = src->resShift;
+    dst->mbColCnt = src->mbColCnt;
+    dst->mbRowCnt = src->mbRowCnt;
+    dst->maxRefIdx = src->maxRefIdx;
+    dst->frameCoding = src->frameCoding;
+    dst->fieldIdx = src->fieldIdx;
+    dst->refFrames[0] = src->refFrames[0];  // 不持有引用, 解码结束后清除
+    dst->refFrames[1] = src->refFrames[1];
+    memcpy(dst->refPics, src->refPics, sizeof(src->refPics));
+    memcpy(dst->distBuf, src->distBuf, sizeof(src->distBuf));
+    dst->backIdxXor = src->backIdxXor;
+    memcpy(dst->backMvScale, src->backMvScale, sizeof(src->backMvScale));
+    dst->lfDisabled = src->lfDisabled;
+    dst->colMvs = src->colMvs;
+    dst->invScan = src->invScan;
+    memcpy(dst->wqMatrix, src->wqMatrix, 64 * sizeof(uint8_t));
+    dst->refRcLuma = src->refRcLuma;
+    dst->refRcCbcr = src->refRcCbcr;
+
+    if (src->picHdr.aec_enable) // 高级熵编码
+    {
+        if (dst->aecParser == nullptr)
+            dst->aecParser = new AvsAecParser;
+        dst->aecParser->set_scan_quant_matrix(dst->invScan, dst->wqMatrix);
+    }
+    else // VLC 编码
+    {
+        if (dst->vlcParser == nullptr)
+            dst->vlcParser = new AvsVlcParser;
+        dst->vlcParser->set_scan_quant_matrix(dst->invScan, dst->wqMatrix);
+    }
+}
+
+// 解码一个 slice, 开启统计时 slice 耗时中除去各像素处理阶段的部分计入熵解码
+static inline void decode_one_slice(FrmDecContext* ctx, PFN_DecodeSlice pfnDecSlice, const SliceData& slice)
+{
+    if (!ctx->profiling)
+    {
+        (*pfnDecSlice)(ctx, slice.data, slice.size);
+    }
+    else
+    {
+        FrmDecContext* prevCtx = set_prof_context(ctx);
+        const int64_t reconCycles = ctx->stats.recon_cycles();
+        const int64_t start = read_cycles();
+        (*pfnDecSlice)(ctx, slice.data, slice.size);
+        const int64_t elapsed = read_cycles() - start;
+        ctx->stats.cycles[STAGE_ENTROPY] += elapsed - (ctx->stats.recon_cycles() - reconCycles);
+        set_prof_context(prevCtx);
+    }
+
+    if (ctx->errCode)
+        ctx->curFrame->sliceError = 1;
+}
+
+// 解码 slice [sBeg, sEnd)
+static void decode_slices(FrmDecContext* ctx, PFN_DecodeSlice pfnDecSlice, int sBeg, int sEnd)
+{
+    const SliceVector& sliVec = ctx->sliceVec;
+    ReconJob* recJob = ctx->reconJob;
+    if (recJob)     // 两级流水线或 wavefront 模式, 当前线程逐一解析 slice, 重建任务同时回放像素处理命令
+    {
+        for (size_t i = 0; i < recJob->workers.size(); i++)
+        {
+            FrmDecContext* worker = recJob->workers[i];
+            copy_pic_params(worker, ctx);
+            worker->kernels = &ctx->avsCtx->kernels;
+        }
+
+        recJob->start();
+        for (int i = sBeg; i < sEnd; i++)
+            decode_one_slice(ctx, pfnDecSlice, sliVec[i]);
+        recJob->finish();
+        return;
+    }
+
+    for (int i = sBeg; i < sEnd; i++)
+        decode_one_slice(ctx, pfnDecSlice, sliVec[i]);
+}
+
 // I 帧解码,  可能在后台线程调用
 static void decode_frame_I(FrmDecContext* ctx)
 {
@@ -1118,19 +1528,13 @@ static void decode_frame_I(FrmDecContext* ctx)
     // slice 解码函数
     PFN_DecodeSlice pfn_DecSlice = ctx->picHdr.aec_enable ? &decode_slice_I_AEC : &decode_slice_I;
 
-    // slice 逐一解码
-    const SliceVector& sliVec = ctx->sliceVec;
-    int sIdx = 0;
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        const uint8_t* data = sliVec[sIdx].data;
-        if (ctx->frameCoding == 0 && data[3] >= ctx->mbRowCnt) // 第二场
-            break;
-        (*pfn_DecSlice)(ctx, data, sliVec[sIdx].size);
-    }
+    // 解码帧或者第一场的 slice
+    const int sliceCnt = (int)ctx->sliceVec.size();
+    const int sIdx = second_field_slice(ctx);
+    decode_slices(ctx, pfn_DecSlice, 0, sIdx);
 
     // 帧编码或者未检测到第二场数据, 解码结束
-    if (sIdx >= sliVec.size())
+    if (sIdx >= sliceCnt)
         return;
 
     //------------------------------------------------------------------------------------   
@@ -1156,21 +1560,18 @@ static void decode_frame_I(FrmDecContext* ctx)
     // 第二场在帧内的位置
     if (ctx->picHdr.top_field_first)
     {
-        ADD3X(ctx->picPlane, curFrame->plane, curFrame->pitch);
+        ADD3X(ctx->picPlane, curFrame->recPlane, curFrame->recPitch);
     }
     else
     {
-        COPY3X(ctx->picPlane, curFrame->plane);
+        COPY3X(ctx->picPlane, curFrame->recPlane);
     }
 
     // 场编码下 I 帧的第二场是 P 场
     pfn_DecSlice = ctx->picHdr.aec_enable ? &decode_slice_P_AEC : &decode_slice_P;
 
-    // slice 逐一解码
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        (*pfn_DecSlice)(ctx, sliVec[sIdx].data, sliVec[sIdx].size);
-    }
+    // 解码第二场的 slice
+    decode_slices(ctx, pfn_DecSlice, sIdx, sliceCnt);
 }
 
 // P 帧解码, 可能在后台线程调用
@@ -1179,7 +1580,7 @@ static void decode_frame_P(FrmDecContext* ctx)
     DecFrame* curFrame = ctx->curFrame;
     DecFrame** refFrames = ctx->refFrames;
     RefPicture* refPics = ctx->refPics;
-    const int* framePitchs = curFrame->pitch;
+    const int* framePitchs = curFrame->recPitch;
 
     if (ctx->frameCoding)  // 帧编码
     {
@@ -1189,8 +1590,8 @@ static void decode_frame_P(FrmDecContext* ctx)
         // 帧编码有 2 个参考帧
         refPics[0].pframe = refFrames[0];
         refPics[1].pframe = refFrames[1];
-        COPY3X(refPics[0].plane, refFrames[0]->plane);
-        COPY3X(refPics[1].plane, refFrames[1]->plane);
+        COPY3X(refPics[0].plane, refFrames[0]->recPlane);
+        COPY3X(refPics[1].plane, refFrames[1]->recPlane);
 
         // 设置参考帧距离
         ctx->refDist[-1] = 1;
@@ -1220,23 +1621,23 @@ static void decode_frame_P(FrmDecContext* ctx)
         refPics[3].pframe = refFrames[1];
         if (refFrames[0]->topfield_first)
         {
-            ADD3X(refPics[0].plane, refFrames[0]->plane, framePitchs);
-            COPY3X(refPics[1].plane, refFrames[0]->plane);
+            ADD3X(refPics[0].plane, refFrames[0]->recPlane, framePitchs);
+            COPY3X(refPics[1].plane, refFrames[0]->recPlane);
         }
         else
         {
-            COPY3X(refPics[0].plane, refFrames[0]->plane);
-            ADD3X(refPics[1].plane, refFrames[0]->plane, framePitchs);
+            COPY3X(refPics[0].plane, refFrames[0]->recPlane);
+            ADD3X(refPics[1].plane, refFrames[0]->recPlane, framePitchs);
         }
         if (refFrames[1]->topfield_first)
         {
-            ADD3X(refPics[2].plane, refFrames[1]->plane, framePitchs);
-            COPY3X(refPics[3].plane, refFrames[1]->plane);
+            ADD3X(refPics[2].plane, refFrames[1]->recPlane, framePitchs);
+            COPY3X(refPics[3].plane, refFrames[1]->recPlane);
         }
         else
         {
-            COPY3X(refPics[2].plane, refFrames[1]->plane);
-            ADD3X(refPics[3].plane, refFrames[1]->plane, framePitchs);
+            COPY3X(refPics[2].plane, refFrames[1]->recPlane);
+            ADD3X(refPics[3].plane, refFrames[1]->recPlane, framePitchs);
         }
 
         // 设置参考帧距离
@@ -1272,19 +1673,13 @@ static void decode_frame_P(FrmDecContext* ctx)
     // slice 解码函数
     PFN_DecodeSlice pfn_DecSlice = ctx->picHdr.aec_enable ? &decode_slice_P_AEC : &decode_slice_P;
 
-    // slice 逐一解码
-    const SliceVector& sliVec = ctx->sliceVec;
-    int sIdx = 0;
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        const uint8_t* data = sliVec[sIdx].data;
-        if (ctx->frameCoding == 0 && data[3] >= ctx->mbRowCnt) // 第二场
-            break;
-        (*pfn_DecSlice)(ctx, data, sliVec[sIdx].size);
-    }
+    // 解码帧或者第一场的 slice
+    const int sliceCnt = (int)ctx->sliceVec.size();
+    const int sIdx = second_field_slice(ctx);
+    decode_slices(ctx, pfn_DecSlice, 0, sIdx);
 
     // 帧编码或者未检测到第二场数据, 解码结束
-    if (sIdx >= sliVec.size())
+    if (sIdx >= sliceCnt)
         return;
 
     //------------------------------------------------------------------------------------
@@ -1299,21 +1694,21 @@ static void decode_frame_P(FrmDecContext* ctx)
 
     if (refFrames[0]->topfield_first)
     {
-        ADD3X(refPics[1].plane, refFrames[0]->plane, framePitchs);
-        COPY3X(refPics[2].plane, refFrames[0]->plane);
+        ADD3X(refPics[1].plane, refFrames[0]->recPlane, framePitchs);
+        COPY3X(refPics[2].plane, refFrames[0]->recPlane);
     }
     else
     {
-        COPY3X(refPics[1].plane, refFrames[0]->plane);
-        ADD3X(refPics[2].plane, refFrames[0]->plane, framePitchs);
+        COPY3X(refPics[1].plane, refFrames[0]->recPlane);
+        ADD3X(refPics[2].plane, refFrames[0]->recPlane, framePitchs);
     }
     if (refFrames[1]->topfield_first)
     {
-        ADD3X(refPics[3].plane, refFrames[1]->plane, framePitchs);
+        ADD3X(refPics[3].plane, refFrames[1]->recPlane, framePitchs);
     }
     else
     {
-        COPY3X(refPics[3].plane, refFrames[1]->plane);
+        COPY3X(refPics[3].plane, refFrames[1]->recPlane);
     }
 
     // 设置参考场距离
@@ -1343,21 +1738,18 @@ static void decode_frame_P(FrmDecContext* ctx)
     // 第二场在帧内的位置
     if (ctx->picHdr.top_field_first)
     {
-        ADD3X(ctx->picPlane, curFrame->plane, framePitchs);
+        ADD3X(ctx->picPlane, curFrame->recPlane, framePitchs);
     }
     else
     {
-        COPY3X(ctx->picPlane, curFrame->plane);
+        COPY3X(ctx->picPlane, curFrame->recPlane);
     }
 
     // 针对 B_Direct 运动估计
     ctx->colMvs = curFrame->colMvs + ctx->mbRowCnt * ctx->mbColCnt;
 
-    // slice 逐一解码
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        (*pfn_DecSlice)(ctx, sliVec[sIdx].data, sliVec[sIdx].size);
-    }
+    // 解码第二场的 slice
+    decode_slices(ctx, pfn_DecSlice, sIdx, sliceCnt);
 }
 
 // B 帧解码, 可能在后台线程调用
@@ -1366,7 +1758,7 @@ static void decode_frame_B(FrmDecContext* ctx)
     DecFrame* curFrame = ctx->curFrame;
     DecFrame** refFrames = ctx->refFrames;
     RefPicture* refPics = ctx->refPics;
-    const int* framePitchs = curFrame->pitch;
+    const int* framePitchs = curFrame->recPitch;
 
     if (ctx->frameCoding)  // 帧编码
     {
@@ -1377,8 +1769,8 @@ static void decode_frame_B(FrmDecContext* ctx)
         // 帧编码有 2 个参考帧
         refPics[0].pframe = refFrames[1];
         refPics[1].pframe = refFrames[0];
-        COPY3X(refPics[0].plane, refFrames[1]->plane);
-        COPY3X(refPics[1].plane, refFrames[0]->plane);
+        COPY3X(refPics[0].plane, refFrames[1]->recPlane);
+        COPY3X(refPics[1].plane, refFrames[0]->recPlane);
 
         // 设置参考帧距离
         ctx->refDist[-1] = 1;
@@ -1407,25 +1799,25 @@ static void decode_frame_B(FrmDecContext* ctx)
         refPics[3].pframe = refFrames[0];
         if (refFrames[1]->topfield_first)
         {
-            ADD3X(refPics[0].plane, refFrames[1]->plane, framePitchs);
-            COPY3X(refPics[2].plane, refFrames[1]->plane);
+            ADD3X(refPics[0].plane, refFrames[1]->recPlane, framePitchs);
+            COPY3X(refPics[2].plane, refFrames[1]->recPlane);
         }
         else
         {
-            COPY3X(refPics[0].plane, refFrames[1]->plane);
-            ADD3X(refPics[2].plane, refFrames[1]->plane, framePitchs);
+            COPY3X(refPics[0].plane, refFrames[1]->recPlane);
+            ADD3X(refPics[2].plane, refFrames[1]->recPlane, framePitchs);
         }
 
         // 标准后向参考索引 0 对应 1, 1 对应 3
         if (refFrames[0]->topfield_first)
         {
-            COPY3X(refPics[1].plane, refFrames[0]->plane);
-            ADD3X(refPics[3].plane, refFrames[0]->plane, framePitchs);
+            COPY3X(refPics[1].plane, refFrames[0]->recPlane);
+            ADD3X(refPics[3].plane, refFrames[0]->recPlane, framePitchs);
         }
         else
         {
-            ADD3X(refPics[1].plane, refFrames[0]->plane, framePitchs);
-            COPY3X(refPics[3].plane, refFrames[0]->plane);
+            ADD3X(refPics[1].plane, refFrames[0]->recPlane, framePitchs);
+            COPY3X(refPics[3].plane, refFrames[0]->recPlane);
         }
 
         // 设置参考帧距离
@@ -1459,19 +1851,13 @@ static void decode_frame_B(FrmDecContext* ctx)
     // slice 解码函数
     PFN_DecodeSlice pfn_DecSlice = ctx->picHdr.aec_enable ? &decode_slice_B_AEC : &decode_slice_B;
 
-    // slice 逐一解码
-    const SliceVector& sliVec = ctx->sliceVec;
-    int sIdx = 0;
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        const uint8_t* data = sliVec[sIdx].data;
-        if (ctx->frameCoding == 0 && data[3] >= ctx->mbRowCnt) // 第二场
-            break;
-        (*pfn_DecSlice)(ctx, data, sliVec[sIdx].size);
-    }
+    // 解码帧或者第一场的 slice
+    const int sliceCnt = (int)ctx->sliceVec.size();
+    const int sIdx = second_field_slice(ctx);
+    decode_slices(ctx, pfn_DecSlice, 0, sIdx);
 
     // 帧编码或者未检测到第二场数据, 解码结束
-    if (sIdx >= sliVec.size())
+    if (sIdx >= sliceCnt)
         return;
 
     //------------------------------------------------------------------------------------
@@ -1505,18 +1891,15 @@ static void decode_frame_B(FrmDecContext* ctx)
     // 第二场所在位置
     if (ctx->picHdr.top_field_first)
     {
-        ADD3X(ctx->picPlane, curFrame->plane, framePitchs);
+        ADD3X(ctx->picPlane, curFrame->recPlane, framePitchs);
     }
     else
     {
-        COPY3X(ctx->picPlane, curFrame->plane);
+        COPY3X(ctx->picPlane, curFrame->recPlane);
     }
 
-    // slice 逐一解码
-    for (; sIdx < sliVec.size(); sIdx++)
-    {
-        (*pfn_DecSlice)(ctx, sliVec[sIdx].data, sliVec[sIdx].size);
-    }
+    // 解码第二场的 slice
+    decode_slices(ctx, pfn_DecSlice, sIdx, sliceCnt);
 }
 
 // 配置异步解码任务
@@ -1535,117 +1918,153 @@ void FrmDecTask::work()
 }
 
 //======================================================================================================================
-extern void dec_macroblock_PSkip(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P16x16(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P16x8(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P8x16(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P8x8(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P16x16_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P16x8_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P8x16_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_P8x8_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_BSkip(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_BDirect(FrmDecContext* ctx, int mx, int my);
-extern void dec_macroblock_B16x16(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B16x8(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B8x16(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B8x8(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_BSkip_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_BDirect_AEC(FrmDecContext* ctx, int mx, int my);
-extern void dec_macroblock_B16x16_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B16x8_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B8x16_AEC(FrmDecContext*, int mx, int my);
-extern void dec_macroblock_B8x8_AEC(FrmDecContext*, int mx, int my);
+extern void IDCT_8x8_add_sse4(const int16_t src[64], uint8_t* dst, int dstPitch);
+extern void IDCT_8x8_add_1x1_sse4(const int16_t src[64], uint8_t* dst, int dstPitch);
+extern void IDCT_8x8_add_4x4_sse4(const int16_t src[64], uint8_t* dst, int dstPitch);
+extern void IDCT_16x8_add_sse4(const int16_t src[128], uint8_t* dst, int dstPitch);
+extern void IDCT_16x8_add_dc_sse4(const int16_t src[128], uint8_t* dst, int dstPitch);
+extern void IDCT_16x8_add_avx2(const int16_t src[128], uint8_t* dst, int dstPitch);
+extern void loop_filterI_sse4(FrmDecContext* ctx, int my);
+extern void loop_filterPB_sse4(FrmDecContext* ctx, int my);
+extern void loop_filterI_avx2(FrmDecContext* ctx, int my);
+extern void loop_filterPB_avx2(FrmDecContext* ctx, int my);
+extern void interleave_cbcr_sse2(uint8_t* dst, const uint8_t* srcCb, const uint8_t* srcCr, int width);
+extern void interleave_cbcr_avx2(uint8_t* dst, const uint8_t* srcCb, const uint8_t* srcCr, int width);
+extern void pack_uyvy_sse2(uint8_t* dst, const uint8_t* srcY, const uint8_t* srcCb, const uint8_t* srcCr, int width);
+extern void pack_uyvy_avx2(uint8_t* dst, const uint8_t* srcY, const uint8_t* srcCb, const uint8_t* srcCr, int width);
 
 // 缺省解码回调函数
 static void default_codec_notify(int, void*, void*)
 {}
 
-AvsContext::AvsContext(const IrkAvsDecConfig* cfg, int sseVer) : workingQueue(MAX_THEAD_CNT)
+// 拉取模式下, 解码帧放入输出队列
+static void queue_frame_notify(int code, void* data, void* cbparam)
+{
+    if (code == IRK_CODEC_DONE)
+    {
+        AvsContext* ctx = static_cast<AvsContext*>(cbparam);
+        DecFrame* frame = static_cast<DecFrame*>((IrkAvsDecedPic*)data);
+        frame->add_ref();
+        ctx->outQueue.force_push_back(frame);    // 一次解码可能输出多帧, 允许超出容量
+    }
+}
+
+// 拉取模式下在输出队列末尾放入码流结束标记, 用户取到标记时返回 IRK_AVS_DEC_EOF
+static void put_end_of_stream(AvsContext* ctx)
+{
+    if (ctx->pfnNotify == &queue_frame_notify)
+        ctx->outQueue.force_push_back(nullptr);
+}
+
+AvsContext::AvsContext(const IrkAvsDecConfig* cfg, int sseVer)
+    : workingQueue(MAX_THEAD_CNT)
+    , outQueue(cfg->output_queue_size > 0 ? cfg->output_queue_size : 8)
 {
     this->config = *cfg;
     this->sseVersion = sseVer;
     this->pfnNotify = &default_codec_notify;
     this->notifyParam = nullptr;
+    this->receiveCnt = 0;
 
     // 帧内预测函数
-    this->pfnLumaIPred[0] = &intra_pred_ver;
-    this->pfnLumaIPred[1] = &intra_pred_hor;
-    this->pfnLumaIPred[2] = &intra_pred_dc;
-    this->pfnLumaIPred[3] = &intra_pred_downleft;
-    this->pfnLumaIPred[4] = &intra_pred_downright;
-    this->pfnCbCrIPred[0] = &intra_pred_dc;
-    this->pfnCbCrIPred[1] = &intra_pred_hor;
-    this->pfnCbCrIPred[2] = &intra_pred_ver;
-    this->pfnCbCrIPred[3] = &intra_pred_plane;
-
-    // P 宏块解码函数
-    this->pfnDecMbP[0] = &dec_macroblock_PSkip;
-    this->pfnDecMbP[1] = &dec_macroblock_P16x16;
-    this->pfnDecMbP[2] = &dec_macroblock_P16x8;
-    this->pfnDecMbP[3] = &dec_macroblock_P8x16;
-    this->pfnDecMbP[4] = &dec_macroblock_P8x8;
-    this->pfnDecMbP_AEC[0] = &dec_macroblock_PSkip;
-    this->pfnDecMbP_AEC[1] = &dec_macroblock_P16x16_AEC;
-    this->pfnDecMbP_AEC[2] = &dec_macroblock_P16x8_AEC;
-    this->pfnDecMbP_AEC[3] = &dec_macroblock_P8x16_AEC;
-    this->pfnDecMbP_AEC[4] = &dec_macroblock_P8x8_AEC;
-
-    // B 宏块解码函数
-    this->pfnDecMbB[0] = &dec_macroblock_BSkip;
-    this->pfnDecMbB[1] = &dec_macroblock_BDirect;
-    this->pfnDecMbB[2] =
-    this->pfnDecMbB[3] =
-    this->pfnDecMbB[4] = &dec_macroblock_B16x16;
-    this->pfnDecMbB[5] =
-    this->pfnDecMbB[7] =
-    this->pfnDecMbB[9] =
-    this->pfnDecMbB[11] =
-    this->pfnDecMbB[13] =
-    this->pfnDecMbB[15] =
-    this->pfnDecMbB[17] =
-    this->pfnDecMbB[19] =
-    this->pfnDecMbB[21] = &dec_macroblock_B16x8;
-    this->pfnDecMbB[6] =
-    this->pfnDecMbB[8] =
-    this->pfnDecMbB[10] =
-    this->pfnDecMbB[12] =
-    this->pfnDecMbB[14] =
-    this->pfnDecMbB[16] =
-    this->pfnDecMbB[18] =
-    this->pfnDecMbB[20] =
-    this->pfnDecMbB[22] = &dec_macroblock_B8x16;
-    this->pfnDecMbB[23] = &dec_macroblock_B8x8;
-    this->pfnDecMbB_AEC[0] = &dec_macroblock_BSkip_AEC;
-    this->pfnDecMbB_AEC[1] = &dec_macroblock_BDirect_AEC;
-    this->pfnDecMbB_AEC[2] =
-    this->pfnDecMbB_AEC[3] =
-    this->pfnDecMbB_AEC[4] = &dec_macroblock_B16x16_AEC;
-    this->pfnDecMbB_AEC[5] =
-    this->pfnDecMbB_AEC[7] =
-    this->pfnDecMbB_AEC[9] =
-    this->pfnDecMbB_AEC[11] =
-    this->pfnDecMbB_AEC[13] =
-    this->pfnDecMbB_AEC[15] =
-    this->pfnDecMbB_AEC[17] =
-    this->pfnDecMbB_AEC[19] =
-    this->pfnDecMbB_AEC[21] = &dec_macroblock_B16x8_AEC;
-    this->pfnDecMbB_AEC[6] =
-    this->pfnDecMbB_AEC[8] =
-    this->pfnDecMbB_AEC[10] =
-    this->pfnDecMbB_AEC[12] =
-    this->pfnDecMbB_AEC[14] =
-    this->pfnDecMbB_AEC[16] =
-    this->pfnDecMbB_AEC[18] =
-    this->pfnDecMbB_AEC[20] =
-    this->pfnDecMbB_AEC[22] = &dec_macroblock_B8x16_AEC;
-    this->pfnDecMbB_AEC[23] = &dec_macroblock_B8x8_AEC;
-
+    this->kernels.pfnLumaIPred[0] = &intra_pred_ver;
+    this->kernels.pfnLumaIPred[1] = &intra_pred_hor;
+    this->kernels.pfnLumaIPred[2] = &intra_pred_dc;
+    this->kernels.pfnLumaIPred[3] = &intra_pred_downleft;
+    this->kernels.pfnLumaIPred[4] = &intra_pred_downright;
+    this->kernels.pfnCbCrIPred[0] = &intra_pred_dc;
+    this->kernels.pfnCbCrIPred[1] = &intra_pred_hor;
+    this->kernels.pfnCbCrIPred[2] = &intra_pred_ver;
+    this->kernels.pfnCbCrIPred[3] = &intra_pred_plane;
+
+    // 缺省使用 SSE4 优化函数
+    this->kernels.pfnLumaMC16x16 = &luma_inter_pred_16x16;
+    this->kernels.pfnLumaMC16x8 = &luma_inter_pred_16x8;
+    this->kernels.pfnLumaMC8x16 = &luma_inter_pred_8x16;
+    this->kernels.pfnLumaMC8x8 = &luma_inter_pred_8x8;
+    this->kernels.pfnChromaMC8x8 = &chroma_inter_pred_8x8;
+    this->kernels.pfnChromaMC8x4 = &chroma_inter_pred_8x4;
+    this->kernels.pfnChromaMC4x8 = &chroma_inter_pred_4x8;
+    this->kernels.pfnChromaMC4x4 = &chroma_inter_pred_4x4;
+    this->kernels.pfnLumaMCBlend16x16 = &luma_inter_pred_blend_16x16;
+    this->kernels.pfnLumaMCBlend16x8 = &luma_inter_pred_blend_16x8;
+    this->kernels.pfnLumaMCBlend8x16 = &luma_inter_pred_blend_8x16;
+    this->kernels.pfnLumaMCBlend8x8 = &luma_inter_pred_blend_8x8;
+    this->kernels.pfnChromaMCBlend8x8 = &chroma_inter_pred_blend_8x8;
+    this->kernels.pfnChromaMCBlend8x4 = &chroma_inter_pred_blend_8x4;
+    this->kernels.pfnChromaMCBlend4x8 = &chroma_inter_pred_blend_4x8;
+    this->kernels.pfnChromaMCBlend4x4 = &chroma_inter_pred_blend_4x4;
+    this->kernels.pfnIdct8x8Add = &IDCT_8x8_add_sse4;
+    this->kernels.pfnIdct8x8AddDC = &IDCT_8x8_add_1x1_sse4;
+    this->kernels.pfnIdct8x8Add4x4 = &IDCT_8x8_add_4x4_sse4;
+    this->kernels.pfnIdct16x8Add = &IDCT_16x8_add_sse4;
+    this->kernels.pfnLoopFilterI = &loop_filterI_sse4;
+    this->kernels.pfnLoopFilterPB = &loop_filterPB_sse4;
+
+    // CPU 支持 AVX2 和 BMI2, 替换为 AVX2 优化函数, AVX2 文件编译时同时允许生成 BMI2 指令
+    // AVX-512 暂时使用 AVX2 版本
+    if (sseVer >= 502)
+    {
+        this->kernels.pfnLumaMC16x16 = &luma_inter_pred_16x16_avx2;
+        this->kernels.pfnLumaMC16x8 = &luma_inter_pred_16x8_avx2;
+        this->kernels.pfnChromaMC8x8 = &chroma_inter_pred_8x8_avx2;
+        this->kernels.pfnChromaMC8x4 = &chroma_inter_pred_8x4_avx2;
+        this->kernels.pfnChromaMC4x8 = &chroma_inter_pred_4x8_avx2;
+        this->kernels.pfnChromaMC4x4 = &chroma_inter_pred_4x4_avx2;
+        this->kernels.pfnLumaMCBlend16x16 = &luma_inter_pred_blend_16x16_avx2;
+        this->kernels.pfnLumaMCBlend16x8 = &luma_inter_pred_blend_16x8_avx2;
+        this->kernels.pfnChromaMCBlend8x8 = &chroma_inter_pred_blend_8x8_avx2;
+        this->kernels.pfnChromaMCBlend8x4 = &chroma_inter_pred_blend_8x4_avx2;
+        this->kernels.pfnChromaMCBlend4x8 = &chroma_inter_pred_blend_4x8_avx2;
+        this->kernels.pfnChromaMCBlend4x4 = &chroma_inter_pred_blend_4x4_avx2;
+        this->kernels.pfnLoopFilterI = &loop_filterI_avx2;
+        this->kernels.pfnLoopFilterPB = &loop_filterPB_avx2;
+        this->kernels.pfnIdct16x8Add = &IDCT_16x8_add_avx2;
+    }
+
+    // 缩略图模式, 只使用 DC 系数反变换
+    if (this->config.thumbnail)
+    {
+        this->kernels.pfnIdct8x8Add = &IDCT_8x8_add_1x1_sse4;
+        this->kernels.pfnIdct8x8AddDC = &IDCT_8x8_add_1x1_sse4;
+        this->kernels.pfnIdct8x8Add4x4 = &IDCT_8x8_add_1x1_sse4;
+        this->kernels.pfnIdct16x8Add = &IDCT_16x8_add_dc_sse4;
+    }
+
+    // 低分辨率解码, 使用缩小尺寸的像素处理函数
+    this->resShift = 0;
+    if (!this->config.thumbnail && (this->config.low_res == 1 || this->config.low_res == 2))
+    {
+        this->resShift = this->config.low_res;
+        this->kernels = (this->resShift == 1) ? g_HalfResKernels : g_QuarterResKernels;
+    }
+
+    // 输出格式, 不支持的格式按 I420 输出
+    this->outFormat = IRK_AVS_OUTPUT_I420;
+    if (this->config.output_format == IRK_AVS_OUTPUT_NV12 || this->config.output_format == IRK_AVS_OUTPUT_UYVY)
+        this->outFormat = this->config.output_format;
+    this->rowConvert = (this->outFormat != IRK_AVS_OUTPUT_I420 && !this->config.thumbnail);
+    this->pfnInterleaveCbCr = (sseVer >= 502) ? &interleave_cbcr_avx2 : &interleave_cbcr_sse2;
+    this->pfnPackUYVY = (sseVer >= 502) ? &pack_uyvy_avx2 : &pack_uyvy_sse2;
+    this->pfnFindSc = (sseVer >= 502) ? &find_sc_candidate_avx2 : &find_sc_candidate_sse4;
+
+    // 不填充参考帧边界时, 图像内存也不再预留左右边界
+    this->edgePadding = !this->config.disable_padding;
+    this->rowNotify = (this->config.row_notify != 0 && !this->config.thumbnail);
+    this->frmFactory.set_edge_padding(this->edgePadding);
+
+    // 帧内存使用大页, numa_node 为节点序号加 1
+    if (this->config.huge_page)
+        this->frmFactory.set_huge_page(this->config.numa_node - 1);
+
+    this->stats.reset();
+    this->threadPool = &this->ownPool;
     this->threadCnt = 1;
     this->status = 0;
     this->frameWidth = 0;
     this->frameHeight = 0;
-    this->skipNonRef = 0;
+    this->skipMode = IRK_AVS_DEC_SKIP_NONE;
+    this->randomAccess = false;
     this->refFrames[0] = nullptr;
     this->refFrames[1] = nullptr;
     this->outFrame = nullptr;
@@ -1653,16 +2072,24 @@ AvsContext::AvsContext(const IrkAvsDecConfig* cfg, int sseVer) : workingQueue(MA
 
 AvsContext::~AvsContext()
 {
+    // 关闭输出队列, 唤醒拉取模式下等待解码帧的用户, 等待其返回后才能释放输出队列
+    this->outQueue.close();
+    while (irk::atomic_load(&this->receiveCnt) > 0)
+        irk::OSThread::yield();
+
     // 丢弃已有的解码数据
     this->clear();
 
-    // 关闭线程池
-    if (this->threadCnt > 1)
+    // 关闭自有线程池, 外部共享线程池由用户销毁
+    if (this->threadCnt > 1 && this->threadPool == &this->ownPool)
     {
-        this->threadPool.shutdown();
+        this->ownPool.shutdown();
     }
 }
 
+extern void* bind_new_threads(int numaNode);
+extern void restore_new_threads(void* oldAffinity);
+
 // 解码器初始化
 bool AvsContext::setup()
 {
@@ -1673,20 +2100,49 @@ bool AvsContext::setup()
         return true;
     }
 
-    const int coreCnt = irk::cpu_core_count();  // CPU 核心数
+    if (this->config.thread_pool)   // 使用外部共享线程池, threadCnt 限制本解码器同时解码的帧数
+    {
+        const int poolSize = this->config.thread_pool->threadCnt;
+        if (threadCnt <= 0 || threadCnt > poolSize)
+            threadCnt = poolSize;
+        if (threadCnt > MAX_THEAD_CNT)
+            threadCnt = MAX_THEAD_CNT;
+        if (threadCnt <= 1)
+        {
+            this->threadCnt = 1;
+            return true;
+        }
+        this->threadPool = &this->config.thread_pool->pool;
+    }
+    else
+    {
+        const int coreCnt = irk::cpu_core_count();  // CPU 核心数
 
-    if (threadCnt <= 0 || threadCnt > coreCnt)
-        threadCnt = coreCnt;
-    if (threadCnt > MAX_THEAD_CNT)
-        threadCnt = MAX_THEAD_CNT;
+        if (threadCnt <= 0 || threadCnt > coreCnt)
+            threadCnt = coreCnt;
+        if (threadCnt > MAX_THEAD_CNT)
+            threadCnt = MAX_THEAD_CNT;
 
-    if (this->threadPool.setup(threadCnt))      // 启动线程池
-    {
-        this->threadCnt = threadCnt;
-        return true;
+        // 大页模式绑定了 NUMA 节点时, 解码线程也只运行在该节点上
+        void* oldAffinity = nullptr;
+        if (this->config.huge_page && this->config.numa_node > 0)
+            oldAffinity = bind_new_threads(this->config.numa_node - 1);
+
+        const bool launched = this->ownPool.setup(threadCnt);   // 启动线程池
+        restore_new_threads(oldAffinity);
+        if (!launched)
+            return false;
     }
 
-    return false;
+    this->threadCnt = threadCnt;
+
+    // 同时解码的帧数随线程数增加, 另外预留参考帧与输出帧
+    if (threadCnt + 4 > 16)
+    {
+        this->frmFactory.set_cache_size(threadCnt + 4);
+        this->ctxFactory.set_cache_size(threadCnt + 4);
+    }
+    return true;
 }
 
 // 丢弃已有的解码数据
@@ -1707,6 +2163,14 @@ void AvsContext::clear()
     DISMISS_FRAME(this->refFrames[0]);
     DISMISS_FRAME(this->refFrames[1]);
     DISMISS_FRAME(this->outFrame);
+
+    // 丢弃用户尚未取走的解码帧
+    DecFrame* frame = nullptr;
+    while (this->outQueue.pop_front(&frame))
+    {
+        if (frame)
+            frame->dismiss();
+    }
 }
 
 }   // namespace irk_avs_dec
@@ -1752,6 +2216,9 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
     }
     assert(ctx->workingQueue.count() < ctx->threadCnt);
 
+    // 统计码流分割与头信息解析的耗时
+    const int64_t hdrStart = ctx->config.enable_stats ? read_cycles() : 0;
+
     // 创建当前帧解码 context
     FrmDecContext* frmCtx = create_frame_ctx(ctx);
     frmCtx->userPts = encPic->userpts;
@@ -1763,17 +2230,24 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
     frmCtx->sliceVec.reserve(16);
 
     // 先复制到内部缓存, 预留 4K 空间, 避免错误的码流导致内存越界
+    // 零拷贝输入模式下直接解析输入数据, 由调用者保证 IRK_AVS_DEC_INPUT_PADDING 字节的填充空间
+    const bool zeroCopy = ctx->config.zero_copy != 0;
+    uint8_t* picData = encPic->data;
     frmCtx->dataBuf.clear();
-    if (frmCtx->dataBuf.capacity() < encPic->size + 4096)
-        frmCtx->dataBuf.reserve(encPic->size + 8192);
-    frmCtx->dataBuf.assign(encPic->data, encPic->size);
+    if (!zeroCopy)
+    {
+        if (frmCtx->dataBuf.capacity() < encPic->size + 4096)
+            frmCtx->dataBuf.reserve(encPic->size + 8192);
+        frmCtx->dataBuf.assign(encPic->data, encPic->size);
+        picData = frmCtx->dataBuf.data();
+    }
 
-    uint8_t* picData = frmCtx->dataBuf.data();
     const int picSize = (int)encPic->size;
     *(uint64_t*)(picData + picSize) = 0;    // 填充 0 有助于解码时数据末尾检测
 
     // 查找第一个 start code
-    int used = find_start_code(picData, picSize);
+    const PFN_FindScCandidate pfnFind = ctx->pfnFindSc;
+    int used = find_start_code(pfnFind, picData, picSize);
 
     // 逐一处理 start code unit
     while (used < picSize - 4)
@@ -1787,7 +2261,7 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
             if (frmCtx->curFrame)   // 当前已有一帧在解码, 这是下一帧的数据
                 break;
 
-            int size = find_next_start_code(data, picSize - used);
+            int size = find_next_start_code(pfnFind, data, picSize - used);
             used += size;
             int errc = begin_sequence_decoding(ctx, data, size);
             if (errc != 0)
@@ -1800,14 +2274,18 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
 
             if (ctx->status < AVS_SEQ_HDR_PARSED)   // sequence header 未解析, 继续查找
             {
-                used += find_next_start_code(data, picSize - used);
+                used += find_next_start_code(pfnFind, data, picSize - used);
                 continue;
             }
 
             // 解析 picture header
             int size = 0;
-            used += split_and_purify_sc_unit(data, picSize - used, &size);
-            if (!parse_pic_header_I(&frmCtx->picHdr, &ctx->seqHdr, data, size))
+            uint8_t* hdrData = data;
+            if (zeroCopy)
+                used += split_sc_unit_zero_copy(frmCtx, data, picSize - used, &hdrData, &size);
+            else
+                used += split_and_purify_sc_unit(pfnFind, data, picSize - used, &size);
+            if (!parse_pic_header_I(&frmCtx->picHdr, &ctx->seqHdr, hdrData, size))
                 return IRK_AVS_DEC_BAD_STREAM;
 
             // 开始新一帧的解码
@@ -1822,20 +2300,33 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
 
             if (ctx->status < AVS_SEQ_HDR_PARSED)  // sequence header 未解析, 继续查找
             {
-                used += find_next_start_code(data, picSize - used);
+                used += find_next_start_code(pfnFind, data, picSize - used);
                 continue;
             }
 
             // 解析 picture header
             int size = 0;
-            used += split_and_purify_sc_unit(data, picSize - used, &size);
-            if (!parse_pic_header_PB(&frmCtx->picHdr, &ctx->seqHdr, data, size))
+            uint8_t* hdrData = data;
+            if (zeroCopy)
+                used += split_sc_unit_zero_copy(frmCtx, data, picSize - used, &hdrData, &size);
+            else
+                used += split_and_purify_sc_unit(pfnFind, data, picSize - used, &size);
+            if (!parse_pic_header_PB(&frmCtx->picHdr, &ctx->seqHdr, hdrData, size))
                 return IRK_AVS_DEC_BAD_STREAM;
 
-            // 查看是否跳过 B 帧
-            if (ctx->skipNonRef && frmCtx->picHdr.pic_type == PIC_TYPE_B)
+            // 查看是否跳过 B 帧, 或者只解码 I 帧
+            const bool keyOnly = ctx->config.thumbnail || ctx->skipMode == IRK_AVS_DEC_SKIP_NONKEY;
+            if (keyOnly || (ctx->skipMode != IRK_AVS_DEC_SKIP_NONE && frmCtx->picHdr.pic_type == PIC_TYPE_B))
             {
-                used += find_next_picture(data, picSize - used);
+                used += find_next_picture(pfnFind, data, picSize - used);
+                return used;
+            }
+
+            // 从随机访问点开始解码时, 跳过第一个 I 帧之前的 P/B 帧, 以及参考了该 I 帧之前图像的 B 帧(open GOP)
+            const int needRef = (frmCtx->picHdr.pic_type == PIC_TYPE_B) ? 1 : 0;
+            if (ctx->randomAccess && ctx->refFrames[needRef] == nullptr)
+            {
+                used += find_next_picture(pfnFind, data, picSize - used);
                 return used;
             }
 
@@ -1848,26 +2339,40 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
         {
             if (!frmCtx->curFrame)     // picture header 未解析
             {
-                used += find_next_start_code(data, picSize - used);
+                used += find_next_start_code(pfnFind, data, picSize - used);
                 continue;
             }
 
             // 分割出 slice 数据
-            int size = 0;
-            used += split_and_purify_sc_unit(data, picSize - used, &size);
-            SliceData slice = {data, size};
+            SliceData slice = {data, 0};
+            if (zeroCopy)
+                used += split_sc_unit_zero_copy(frmCtx, data, picSize - used, &slice.data, &slice.size);
+            else
+                used += split_and_purify_sc_unit(pfnFind, data, picSize - used, &slice.size);
             frmCtx->sliceVec.push_back(slice);
         }
         else
         {
             // 不处理, 直接跳过
-            used += find_next_start_code(data, picSize - used);
+            used += find_next_start_code(pfnFind, data, picSize - used);
         }
     }
 
     if (frmCtx->curFrame && frmCtx->sliceVec.size() > 0)
     {
         const int picType = frmCtx->picHdr.pic_type;
+
+        // AVS+ 高级熵编码的设计, 如果码流错误, 存在大量的连续 0 可能导致内存越界
+        if (frmCtx->picHdr.aec_enable)
+        {
+            memset(picData + picSize + 8, 0xFF, 4096 - 8);
+            if (zeroCopy && !frmCtx->dataBuf.empty())   // 复制到内部缓存的 slice
+            {
+                DataVector& buf = frmCtx->dataBuf;
+                assert(buf.capacity() >= buf.size() + 4096);
+                memset(buf.data() + buf.size(), 0xFF, 4096);
+            }
+        }
         DecFrame* curFrame = frmCtx->curFrame;
 
         // 设置当前帧的参考帧列表
@@ -1886,6 +2391,9 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
             curFrame->add_ref();
         }
 
+        if (frmCtx->profiling)
+            frmCtx->stats.cycles[STAGE_HEADER] += read_cycles() - hdrStart;
+
         if (ctx->threadCnt > 1)     // 多线程异步解码
         {
             // 配置异步解码任务
@@ -1908,7 +2416,7 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
             }
 
             // 启动异步解码
-            ctx->threadPool.run_task(frmCtx->decTask);
+            ctx->threadPool->run_task(frmCtx->decTask);
 
             // 添加到工作队列
             ctx->workingQueue.push_back(frmCtx);
@@ -1942,6 +2450,8 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCo
 // SSE2 = 200
 // SSE3 = 300, SSSE3 = 301
 // SSE4.1 = 401, SSE4.2 = 402
+// AVX2 = 501, AVX2 + BMI2 = 502
+// AVX-512BW = 601
 extern int get_sse_version();
 
 // create AVS+ decoder
@@ -1970,18 +2480,58 @@ IRK_AVSDEC_EXPORT void irk_destroy_avs_decoder(IrkAvsDecoder* decoder)
     delete ctx;
 }
 
+// create thread pool shared by several AVS+ decoders, see IrkAvsDecConfig::thread_pool
+// thread_cnt == 0 means CPU core count
+// return NULL if failed(create threads failed)
+IRK_AVSDEC_EXPORT IrkAvsThreadPool* irk_create_avs_thread_pool(int thread_cnt)
+{
+    if (thread_cnt <= 0)
+        thread_cnt = irk::cpu_core_count();
+
+    IrkAvsThreadPool* pool = new IrkAvsThreadPool;
+    if (!pool->pool.setup(thread_cnt))
+    {
+        delete pool;
+        return nullptr;
+    }
+    pool->threadCnt = thread_cnt;
+    return pool;
+}
+
+// destroy shared thread pool, all decoders using it must be destroyed first
+IRK_AVSDEC_EXPORT void irk_destroy_avs_thread_pool(IrkAvsThreadPool* pool)
+{
+    if (pool)
+    {
+        pool->pool.shutdown();
+        delete pool;
+    }
+}
+
 // reset AVS+ decoder(before decoding new bitstream)
 // if "resetAll" == false, global setting such as sequece header will not be reset
 IRK_AVSDEC_EXPORT void irk_avs_decoder_reset(IrkAvsDecoder* decoder, bool resetAll)
 {
     AvsContext* ctx = static_cast<AvsContext*>(decoder);
     ctx->clear();
+    put_end_of_stream(ctx);
+    ctx->randomAccess = false;
     if (resetAll)
         ctx->status = 0;    // clear sequence header  
 }
 
+// reset AVS+ decoder before decoding from a random access point(normally an I picture) after seeking in the bitstream
+IRK_AVSDEC_EXPORT void irk_avs_decoder_seek_reset(IrkAvsDecoder* decoder)
+{
+    AvsContext* ctx = static_cast<AvsContext*>(decoder);
+    ctx->clear();
+    put_end_of_stream(ctx);
+    ctx->randomAccess = true;
+}
+
 // set decoding notify callback
 // when got IRK_CODEC_DONE code, notify data point to IrkAvsDecedPic struct
+// when got IRK_AVS_DEC_ROWS_READY code, notify data point to IrkAvsDecedRows struct
 IRK_AVSDEC_EXPORT void irk_avs_decoder_set_notify(IrkAvsDecoder* decoder, PFN_CodecNotify callback, void* cbparam)
 {
     AvsContext* ctx = static_cast<AvsContext*>(decoder);
@@ -1989,11 +2539,94 @@ IRK_AVSDEC_EXPORT void irk_avs_decoder_set_notify(IrkAvsDecoder* decoder, PFN_Co
     ctx->notifyParam = cbparam;
 }
 
-// set skip mode, if "skip_mode" != 0, skip non-reference pictures
+// set skip mode, see IRK_AVS_DEC_SKIP_XXX
 IRK_AVSDEC_EXPORT void irk_avs_decoder_set_skip(IrkAvsDecoder* decoder, int skip_mode)
 {
     AvsContext* ctx = static_cast<AvsContext*>(decoder);
-    ctx->skipNonRef = skip_mode;
+    ctx->skipMode = skip_mode;
+}
+
+// pull mode: decode one AVS+ picture, decoded pictures are put into the output queue
+// if succeeded return data size consumed,
+// if the output queue is full return IRK_AVS_DEC_AGAIN, if failed return negtive error code
+// input NULL flushes cached pictures into the output queue, followed by an end of stream mark
+IRK_AVSDEC_EXPORT int irk_avs_decoder_send_packet(IrkAvsDecoder* decoder, const IrkCodedPic* encPic)
+{
+    AvsContext* ctx = static_cast<AvsContext*>(decoder);
+
+    // 输出队列已满, 用户需先取走解码帧; 刷新缓存帧总是允许
+    if (encPic && ctx->outQueue.is_full())
+        return IRK_AVS_DEC_AGAIN;
+
+    ctx->pfnNotify = &queue_frame_notify;
+    ctx->notifyParam = ctx;
+    const int ret = irk_avs_decoder_decode(decoder, encPic);
+
+    // 缓存帧都已放入输出队列, 之后放入码流结束标记
+    if (!encPic)
+        put_end_of_stream(ctx);
+    return ret;
+}
+
+// pull mode: take one decoded picture from the output queue
+// if succeeded return 0, if no picture is available return IRK_AVS_DEC_AGAIN,
+// if the end of stream mark is reached or the decoder is being destroyed return IRK_AVS_DEC_EOF
+IRK_AVSDEC_EXPORT int irk_avs_decoder_receive_frame(IrkAvsDecoder* decoder, IrkAvsDecedPic** pic, int wait_ms)
+{
+    AvsContext* ctx = static_cast<AvsContext*>(decoder);
+    DecFrame* frame = nullptr;
+
+    // 销毁解码器时等待所有调用返回
+    irk::atomic_inc(&ctx->receiveCnt);
+    irk::WaitStatus status = irk::WaitStatus::Ok;
+    if (wait_ms == 0)
+    {
+        if (!ctx->outQueue.pop_front(&frame))
+            status = ctx->outQueue.is_closed() ? irk::WaitStatus::Closed : irk::WaitStatus::Timeout;
+    }
+    else if (wait_ms < 0)
+    {
+        status = ctx->outQueue.pop_front_wait(&frame);
+    }
+    else
+    {
+        status = ctx->outQueue.pop_front_wait_for(&frame, wait_ms);
+    }
+    irk::atomic_dec(&ctx->receiveCnt);
+
+    if (status == irk::WaitStatus::Closed)      // 解码器正在销毁
+        return IRK_AVS_DEC_EOF;
+    if (status != irk::WaitStatus::Ok)
+        return IRK_AVS_DEC_AGAIN;
+    if (!frame)                                 // 码流结束标记
+        return IRK_AVS_DEC_EOF;
+
+    *pic = frame;
+    return 0;
+}
+
+// get per-stage decoding statistics
+// if succeeded return 0, if statistics is not enabled return IRK_AVS_DEC_UNAVAILABLE
+IRK_AVSDEC_EXPORT int irk_avs_decoder_get_stats(IrkAvsDecoder* decoder, IrkAvsDecStats* pstats, int reset)
+{
+    AvsContext* ctx = static_cast<AvsContext*>(decoder);
+    if (!ctx->config.enable_stats)
+        return IRK_AVS_DEC_UNAVAILABLE;
+
+    const DecStats& stats = ctx->stats;
+    pstats->frames = stats.frames;
+    pstats->header_cycles = stats.cycles[STAGE_HEADER];
+    pstats->entropy_cycles = stats.cycles[STAGE_ENTROPY];
+    pstats->intra_pred_cycles = stats.cycles[STAGE_INTRA];
+    pstats->inter_pred_cycles = stats.cycles[STAGE_INTER];
+    pstats->idct_cycles = stats.cycles[STAGE_IDCT];
+    pstats->loop_filter_cycles = stats.cycles[STAGE_LOOP_FILTER];
+    pstats->padding_cycles = stats.cycles[STAGE_PADDING];
+    pstats->wait_cycles = stats.cycles[STAGE_WAIT];
+
+    if (reset)
+        ctx->stats.reset();
+    return 0;
 }
 
 // get AVS+ stream basic infomation
@@ -2024,6 +2657,20 @@ IRK_AVSDEC_EXPORT int irk_avs_decoder_get_info(IrkAvsDecoder* decoder, IrkAvsStr
     return IRK_AVS_DEC_UNAVAILABLE;
 }
 
+// find the next AVS+ start code(00 00 01) in the coded data
+// return offset of the start code, return "size" if not found
+IRK_AVSDEC_EXPORT int irk_avs_find_start_code(const uint8_t* data, int size)
+{
+    int i = 0;
+    while (1)
+    {
+        i += find_sc_candidate(data + i, size - i);
+        if (i >= size || data[i + 2] == 0x1)
+            return std::min(i, size);
+        i++;
+    }
+}
+
 // normally decoded picture is only valid in notify callback function,
 // in case user wants to use decoded picture outside callback function, 
 // user can either use custom memory allocator or retain the decoded picture
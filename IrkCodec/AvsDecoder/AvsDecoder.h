@@ -31,8 +31,15 @@ struct IrkAvsDecoder
 {
 };
 
+// 多个解码器共享的线程池
+struct IrkAvsThreadPool
+{
+    irk::ThreadPool pool;
+    int             threadCnt;          // 线程池线程数
+};
+
 // 解码器允许的最大内部线程数, 如果创建的线程太多, 可能影响到系统其他模块, 同时占用过多内存
-#define MAX_THEAD_CNT 16
+#define MAX_THEAD_CNT 64
 
 namespace irk_avs_dec {
 
@@ -41,6 +48,11 @@ struct DecFrame;
 class  FrameFactory;
 struct FrmDecContext;
 class  FrmCtxFactory;
+struct DecKernels;
+struct ReconCmd;
+struct ReconRow;
+struct ReconJob;
+class  ReconTask;
 
 extern const int32_t g_DequantScale[64];
 extern const uint8_t g_DequantShift[64];
@@ -48,67 +60,98 @@ extern const uint8_t g_ChromaQp[64 + 16];
 
 //======================================================================================================================
 
-// 针对并行解码, 请求参考帧数据
-struct RefDataReq
+// 解码统计的各个阶段
+enum DecStage
 {
-    RefDataReq() : m_refLine(0), m_NotifyEvt(true) {}
-    volatile int    m_refLine;          // 请求参考帧 m_refLine 行解码完成
-    irk::SyncEvent  m_NotifyEvt;        // 参考帧已满足请求通知
+    STAGE_HEADER = 0,       // 码流分割, 头信息解析, 帧初始化
+    STAGE_ENTROPY,          // 熵解码, 宏块解析, 运动矢量预测等, 即 slice 解码中除以下各阶段之外的耗时
+    STAGE_INTRA,            // 帧内预测
+    STAGE_INTER,            // 帧间预测, 加权预测, 双向预测取平均
+    STAGE_IDCT,             // 反变换
+    STAGE_LOOP_FILTER,      // 环路滤波
+    STAGE_PADDING,          // 边界填充
+    STAGE_WAIT,             // 等待参考帧解码进度
+    STAGE_CNT,
 };
 
+// 解码统计数据, 单位为 CPU 时间戳计数
+struct DecStats
+{
+    int64_t frames;                 // 解码帧数
+    int64_t cycles[STAGE_CNT];      // 各阶段耗时
+
+    void reset()
+    {
+        memset(this, 0, sizeof(*this));
+    }
+
+    // 累加 other 的统计数据并清空 other
+    void merge(DecStats& other)
+    {
+        this->frames += other.frames;
+        for (int i = 0; i < STAGE_CNT; i++)
+            this->cycles[i] += other.cycles[i];
+        other.reset();
+    }
+
+    // slice 解码中熵解码之外各阶段的耗时之和
+    int64_t recon_cycles() const
+    {
+        int64_t sum = 0;
+        for (int i = STAGE_INTRA; i < STAGE_CNT; i++)
+            sum += this->cycles[i];
+        return sum;
+    }
+};
+
+
 // 针对并行解码, 管理当前帧解码进度
+// 解码进度为原子变量, 更新与查询均无需加锁; 等待者先短暂自旋, 仍未满足再阻塞在条件变量上,
+// 仅当存在阻塞的等待者时更新者才需要加锁通知, 因而不再限制同时等待的线程数
 struct DecodingState
 {
 public:
-    DecodingState() : m_lineReady(0), m_reqCnt(0), m_doneEvt(true)
-    {
-        memset(m_reqList, 0, sizeof(m_reqList));
-    }
+    DecodingState() : m_lineReady(0), m_waiterCnt(0) {}
     ~DecodingState()
     {
-        assert(m_reqCnt == 0);
+        assert(m_waiterCnt == 0);
     }
 
-    // 更新当前帧解码进度
+    // 更新当前帧解码进度, 进度只增不减
     void update_state(int line);
 
-    // 添加参考数据请求, 等待请求满足
-    void wait_request(RefDataReq* req);
+    // 等待当前帧解码到 line 行
+    // NOTE: 不在类内定义, 避免 AVX2 编译的文件生成同名的 inline 版本, 链接时与 SSE 版本混淆
+    void wait_line(int line);
 
-    // 标识当前帧解码完成, 所有请求者返回
-    void set_frame_done()
-    {
-        this->update_state(INT32_MAX);
-        m_doneEvt.set();
-        assert(m_reqCnt == 0);
-    }
+    // 标识当前帧解码完成, 所有等待者返回
+    void set_frame_done();
 
     // 等待当前帧解码完成
-    void wait_frame_done()
-    {
-        if (m_lineReady != INT32_MAX)
-            m_doneEvt.wait();
-        assert(m_reqCnt == 0);
-    }
+    void wait_frame_done();
 
     void reset()
     {
-        assert(m_reqCnt == 0);
+        assert(m_waiterCnt == 0);
         m_lineReady = 0;
-        m_reqCnt = 0;
-        memset(m_reqList, 0, sizeof(m_reqList));
-        m_doneEvt.reset();
     }
 
     volatile int    m_lineReady;                // 已解码的行数
-    int             m_reqCnt;                   // 当前参考数据请求总数
-    RefDataReq*     m_reqList[MAX_THEAD_CNT];   // 参考数据请求列表
-    irk::Mutex      m_mutex;                    // 内部互斥体
-    irk::SyncEvent  m_doneEvt;                  // 当前帧解码完成事件
+    volatile int    m_waiterCnt;                // 当前阻塞的等待者数目
+    irk::Mutex      m_mutex;                    // 仅用于阻塞等待
+    irk::CondVar    m_cond;
 };
 
 //======================================================================================================================
 
+// 大页模式下预先分配的一块内存, 切分为多帧使用, 所有帧都释放后才释放整块内存
+struct FrameArena
+{
+    void*           buf;
+    size_t          size;
+    int             frameCnt;           // 尚未释放的帧数
+};
+
 // 解码帧工厂, 用以管理解码后 YUV 帧内存
 class FrameFactory
 {
@@ -120,8 +163,9 @@ public:
     void set_alloc_callback(PFN_CodecAlloc pfnAlloc, void* cbparam);
     void set_dealloc_callback(PFN_CodecDealloc pfnDealloc, void* cbparam);
 
-    // 配置视频帧大小
-    bool config(int width, int height, int chromaFmt);
+    // 配置视频帧大小, resShift: 低分辨率解码时图像缩小倍数的 log2
+    // outFormat: 输出格式 IRK_AVS_OUTPUT_XXX, 非 I420 时另外分配转换后的输出图像
+    bool config(int width, int height, int chromaFmt, int resShift, int outFormat);
 
     // 创建一帧 DecFrame, isRef: 是否为参考帧
     DecFrame* create(bool isRef);
@@ -129,14 +173,36 @@ public:
     // 丢弃 DecFrame
     void discard(DecFrame* pFrame);
 
+    // 设置各缓存的最大数目, 应不小于同时解码的帧数加上参考帧与输出帧
+    void set_cache_size(int cacheSize);
+
+    // 使用 2M 大页内存, 配置帧大小时按缓存数目预先分配全部帧, numaNode >= 0 时绑定到该 NUMA 节点
+    // NOTE: 仅用于缺省内存分配
+    void set_huge_page(int numaNode);
+
+    // 是否预留左右边界填充的空间, 缺省预留
+    void set_edge_padding(bool padding);
+
 private:
-    static const int kCacheSize = MAX_THEAD_CNT;
+    static const int kDefCacheSize = 16;
+
+    // 使用已分配的内存创建 DecFrame
+    DecFrame* new_frame(const IrkMemBlock& mblock, FrameArena* arena);
+
+    // 释放 DecFrame 及其内存
+    void free_frame(DecFrame* pFrame);
+
+    // 大页模式下预先分配全部帧
+    void prealloc_frames();
 
     PFN_CodecAlloc      m_pfnAlloc;                 // 自定义内存分配函数
     void*               m_allocParam;               // 自定义内存分配函数的用户私有参数
     PFN_CodecDealloc    m_pfnDealloc;               // 自定义内存释放函数
     void*               m_deallocParam;             // 自定义内存释放函数的用户私有参数
     bool                m_bDefAlloc;                // 是否使用缺省内存分配
+    bool                m_hugePage;                 // 是否使用大页内存
+    int                 m_numaNode;                 // 大页内存绑定的 NUMA 节点, -1 表示不绑定
+    bool                m_edgePadding;              // 是否预留左右边界填充的空间
 
     int                 m_chromaFmt;                // 色差格式
     int                 m_lumaWidth;                // 亮度分量宽度
@@ -147,14 +213,16 @@ private:
     int                 m_chromaHeight;             // 色差分量高度
     int                 m_chromaPitch;              // 色差分量行宽
     int                 m_chromaSize;
+    int                 m_resShift;                 // 图像缩小倍数的 log2, 宽高为缩小前的大小
+    int                 m_outFormat;                // 输出格式
+    int                 m_outPitch;                 // 转换后输出图像的行宽, NV12 为 CbCr 平面的行宽
+    int                 m_outSize;                  // 转换后输出图像的大小
     int                 m_generation;               // 用以标记码流变化
 
-    int                 m_frameCnt;                 // 当前缓存的 DecFrame 数目
-    DecFrame*           m_frameCache[kCacheSize];
-    int                 m_colMvCnt;                 // 当前缓存的 BDColMvs 数目
-    BDColMvs*           m_colMvCache[kCacheSize];
-    int                 m_decStateCnt;              // 当前缓存的 DecodingState 数目
-    DecodingState*      m_decStateCache[kCacheSize];
+    int                 m_cacheSize;                // 各缓存的最大数目
+    irk::Vector<DecFrame*>      m_frameCache;       // 缓存的 DecFrame
+    irk::Vector<BDColMvs*>      m_colMvCache;       // 缓存的 BDColMvs
+    irk::Vector<DecodingState*> m_decStateCache;    // 缓存的 DecodingState
     irk::Mutex          m_mutex;
     irk::MemSlots       m_pool;
 };
@@ -173,6 +241,11 @@ struct DecFrame : IrkAvsDecedPic
             factory->discard(this);
     }
 
+    uint8_t*        recPlane[3];        // 解码重建使用的 I420 图像, 输出格式为 I420 时与 plane 相同
+    int             recPitch[3];
+    uint8_t*        rowConverted;       // 输出格式不是 I420 时, 标记已转换的宏块行, 场图像的两场交替排列
+    uint8_t         sliceError;         // 有 slice 解码出错, 已转换的宏块行可能又被错误的 slice 覆盖
+    int             rowsNotified;       // 逐行通知时, 已通知用户的输出图像行数
     uint8_t         frameCoding;        // 0: 场编码, 1: 帧编码
     int32_t         poc;                // 显示顺序计数
     int16_t         denDistBD[2][4];    // 针对 B_Direct, 16384 / blockDistance
@@ -182,6 +255,7 @@ struct DecFrame : IrkAvsDecedPic
     volatile int    refCnt;             // 引用计数
     uint32_t        generation;         // 更改标记, 用于内存管理
     FrameFactory*   factory;            // 解码帧工厂
+    FrameArena*     arena;              // 帧内存所在的大页内存, nullptr 表示单独分配
 };
 
 //======================================================================================================================
@@ -231,6 +305,7 @@ struct FrmDecContext
     ~FrmDecContext();
 
     AvsContext*     avsCtx;             // 全局解码 context
+    const DecKernels* kernels;          // 像素处理函数表
     AvsPicHdr       picHdr;             // picture header
     DataVector      dataBuf;            // 内部缓存
     SliceVector     sliceVec;           // 分割出的 slice, 并行解码用
@@ -248,6 +323,7 @@ struct FrmDecContext
 
     uint8_t*        picPlane[3];        // current picture's buffer
     int             picPitch[3];        // current picture's pitch
+    int             resShift;           // 低分辨率解码时图像缩小倍数的 log2, 0: 原始分辨率, 1: 1/2, 2: 1/4
     int             mbColCnt;           // 水平宏块数
     int             mbRowCnt;           // 垂直宏块数
     int             maxRefIdx;          // 最大参考帧索引
@@ -287,13 +363,53 @@ struct FrmDecContext
     uint8_t*        mcBuff;             // 帧间预测临时, 大小 1024 字节
     const uint8_t*  invScan;            // 逆扫描矩阵
     uint8_t*        wqMatrix;           // weight quant matrix
-    int16_t*        coeff;              // 残差系数临时内存, 大小 128 字节  
+    int16_t*        coeff;              // 残差系数临时内存, 大小 256 字节, 可存放两个 8x8 块
     Rect            refRcLuma;          // 亮度分量的有效参考范围
     Rect            refRcCbcr;          // 色差分量的有效参考范围
-    RefDataReq      refRequest;         // 参考帧数据请求
     FrmDecTask*     decTask;            // 异步解码任务
+    ReconJob*       reconJob;           // 两级流水线或 wavefront 模式下的重建任务, 只有负责解析的帧解码 context 非空
+    int             profiling;          // 是否统计各阶段耗时
+    int             keyOnly;            // 是否只解码 I 帧, 此时解码完成立即输出
+    DecStats        stats;              // 当前帧的解码统计数据
 };
 
+// 等待参考帧解码到 line 行, 开启统计时记录等待耗时
+static inline void wait_ref_line(FrmDecContext* ctx, DecodingState* decState, int line)
+{
+    if (ctx->profiling)
+    {
+        const int64_t start = read_cycles();
+        decState->wait_line(line);
+        ctx->stats.cycles[STAGE_WAIT] += read_cycles() - start;
+    }
+    else
+    {
+        decState->wait_line(line);
+    }
+}
+
+// 检查参考帧数据是否已解码, 未解码等待
+// 使用 static, 避免与 AVX 编译的版本混淆
+static inline void check_ref_data(FrmDecContext* ctx, DecFrame* refFrame, int y)
+{
+    assert(refFrame->decState);
+
+    if (ctx->curFrame == refFrame) // 同一帧的第二场, 第一场数据总是已解码
+    {
+        assert(ctx->fieldIdx == 1);
+        return;
+    }
+
+    int refLine = y * (2 - ctx->frameCoding);   // 可能存在帧场自适应编码, 全部转化为帧的刻度
+    if (refLine <= irk::atomic_load(&refFrame->decState->m_lineReady))
+    {
+        return;
+    }
+
+    // 等待参考帧, +32 是为了让参考帧多解码一些
+    wait_ref_line(ctx, refFrame->decState, refLine + 32);
+}
+
 // 管理 FrmDecContext
 class FrmCtxFactory
 {
@@ -307,10 +423,13 @@ public:
     // 丢弃单帧解码 context
     void discard(FrmDecContext* frmCtx);
 
+    // 设置缓存的最大数目, 应不小于同时解码的帧数
+    void set_cache_size(int cacheSize) { m_cacheSize = cacheSize; }
+
 private:
-    static const int kCacheSize = MAX_THEAD_CNT;
-    int             m_ctxCnt;
-    FrmDecContext*  m_ctxCache[kCacheSize];
+    static const int kDefCacheSize = 16;
+    int                         m_cacheSize;    // 缓存的最大数目
+    irk::Vector<FrmDecContext*> m_ctxCache;
 };
 
 //======================================================================================================================
@@ -321,8 +440,137 @@ typedef void(*PFN_IntraPred)(uint8_t* dst, int pitch, NBUsable);
 // slice 解码函数原型
 typedef void(*PFN_DecodeSlice)(FrmDecContext*, const uint8_t* data, int size);
 
-// macroblock 解码函数原型
-typedef void(*PFN_DecodeMB)(FrmDecContext*, int mx, int my);
+// 8x8 反变换并叠加到预测值的函数原型, 两个块一起变换时 src 依次存放 128 个系数
+typedef void(*PFN_IDCT8x8Add)(const int16_t src[64], uint8_t* dst, int dstPitch);
+
+// 宏块行环路滤波函数原型
+typedef void(*PFN_LoopFilter)(FrmDecContext*, int my);
+
+// 输出格式转换, 交织一行 Cb, Cr 为 NV12 的 CbCr, width 为色差宽度
+typedef void(*PFN_InterleaveCbCr)(uint8_t* dst, const uint8_t* srcCb, const uint8_t* srcCr, int width);
+
+// 输出格式转换, 打包一行 Y, Cb, Cr 为 UYVY, width 为亮度宽度
+typedef void(*PFN_PackUYVY)(uint8_t* dst, const uint8_t* srcY, const uint8_t* srcCb, const uint8_t* srcCr, int width);
+
+// 像素处理函数表, 根据 CPU 特性选择优化函数
+// 两级流水线模式下, 解析线程使用 g_RecordKernels, 只记录像素处理命令, 由重建线程回放
+struct DecKernels
+{
+    PFN_IntraPred               pfnLumaIPred[5];        // 亮度分量帧内预测函数
+    PFN_IntraPred               pfnCbCrIPred[4];        // 色差分量帧内预测函数
+    PFN_LumaInterPred           pfnLumaMC16x16;         // 16x16 亮度分量帧间预测
+    PFN_LumaInterPred           pfnLumaMC16x8;          // 16x8 亮度分量帧间预测
+    PFN_LumaInterPred           pfnLumaMC8x16;          // 8x16 亮度分量帧间预测
+    PFN_LumaInterPred           pfnLumaMC8x8;           // 8x8 亮度分量帧间预测
+    PFN_ChromaInterPred         pfnChromaMC8x8;         // 8x8 色差分量帧间预测
+    PFN_ChromaInterPred         pfnChromaMC8x4;         // 8x4 色差分量帧间预测
+    PFN_ChromaInterPred         pfnChromaMC4x8;         // 4x8 色差分量帧间预测
+    PFN_ChromaInterPred         pfnChromaMC4x4;         // 4x4 色差分量帧间预测
+    PFN_LumaInterPredBlend      pfnLumaMCBlend16x16;    // 16x16 亮度分量帧间预测, 同时加权及取平均
+    PFN_LumaInterPredBlend      pfnLumaMCBlend16x8;     // 16x8 亮度分量帧间预测, 同时加权及取平均
+    PFN_LumaInterPredBlend      pfnLumaMCBlend8x16;     // 8x16 亮度分量帧间预测, 同时加权及取平均
+    PFN_LumaInterPredBlend      pfnLumaMCBlend8x8;      // 8x8 亮度分量帧间预测, 同时加权及取平均
+    PFN_ChromaInterPredBlend    pfnChromaMCBlend8x8;    // 8x8 色差分量帧间预测, 同时加权及取平均
+    PFN_ChromaInterPredBlend    pfnChromaMCBlend8x4;    // 8x4 色差分量帧间预测, 同时加权及取平均
+    PFN_ChromaInterPredBlend    pfnChromaMCBlend4x8;    // 4x8 色差分量帧间预测, 同时加权及取平均
+    PFN_ChromaInterPredBlend    pfnChromaMCBlend4x4;    // 4x4 色差分量帧间预测, 同时加权及取平均
+    PFN_IDCT8x8Add              pfnIdct8x8Add;          // 8x8 反变换
+    PFN_IDCT8x8Add              pfnIdct8x8AddDC;        // 8x8 反变换, 只有 DC 系数, 只读取 src[0]
+    PFN_IDCT8x8Add              pfnIdct8x8Add4x4;       // 8x8 反变换, 非零系数都在左上角 4x4 内, 只读取前 32 个系数
+    PFN_IDCT8x8Add              pfnIdct16x8Add;         // 水平相邻的两个 8x8 块反变换, 第二个块位于 dst + 块宽度
+    PFN_LoopFilter              pfnLoopFilterI;         // I 帧环路滤波
+    PFN_LoopFilter              pfnLoopFilterPB;        // P/B 帧环路滤波
+};
+
+// 两级流水线模式下解析线程使用的函数表, 只记录像素处理命令
+extern const DecKernels g_RecordKernels;
+
+// 开启统计时使用的函数表, 调用 AvsContext::kernels 中的函数并统计耗时
+extern const DecKernels g_ProfKernels;
+
+// 低分辨率解码使用的函数表, 分别以 1/2 和 1/4 宽高重建宏块
+extern const DecKernels g_HalfResKernels;
+extern const DecKernels g_QuarterResKernels;
+
+// 设置当前线程统计数据的归属 context, 返回之前的设置
+FrmDecContext* set_prof_context(FrmDecContext* ctx);
+
+// 两级流水线或 wavefront 模式下的重建命令缓存块
+struct ReconChunk
+{
+    ReconChunk*     next;               // 下一缓存块
+    uint8_t*        data;               // 命令数据, 16 字节对齐
+};
+
+// 两级流水线模式, 解析与重建由不同线程同时进行
+// 解析线程完成熵解码, 运动矢量预测等, 把像素处理命令(帧内预测模式, 运动补偿位置, 反量化后的残差系数,
+// 环路滤波参数等)按解码顺序写入命令缓存, 每解析完一个宏块行, 该行的命令即可被重建线程领取回放
+// wavefront 模式下多个重建线程同时回放不同的宏块行, 帧内预测需要读取上方和右上方宏块的像素,
+// 所以每一行的重建至少落后上一行 2 个宏块; 环路滤波, 边界填充和进度发布则按宏块行顺序逐行进行
+struct ReconJob
+{
+    // workerCnt 为重建线程数, 两级流水线模式为 1
+    ReconJob(FrmDecContext* ctx, int workerCnt);
+    ~ReconJob();
+
+    // 开始解析帧/场, 启动重建任务, 必须在解析线程调用, 重建 context 的帧/场参数应已设置
+    void start();
+
+    // 解析结束, 当前线程参与重建, 等待重建完成
+    void finish();
+
+    // 逐一领取已解析完成的宏块行并回放其命令, 直到解析结束并且所有宏块行都已领取
+    void replay(FrmDecContext* ctx);
+
+    // 分配命令空间, payload 为命令之后附加数据的字节数
+    ReconCmd* alloc_cmd(int op, int func, int payload);
+
+    // 记录宏块开始, 每个宏块行的第一个宏块开始一个新的宏块行
+    void record_mb(int mx, int my);
+
+    // 记录边界填充, 解码进度
+    void record_padding(int my);
+    void record_progress(int line);
+
+    // 重建宏块行的进度, mbCnt 为已完成的宏块数, INT32_MAX 表示该行所有命令都已回放
+    void set_row_progress(ReconRow* row, int mbCnt);
+    void wait_row_progress(const ReconRow* row, int mbCnt);
+
+    FrmDecContext*  mainCtx;            // 负责解析的帧解码 context
+    ReconChunk*     chunkList;          // 命令缓存块链表
+    ReconChunk*     writeChunk;         // 当前写入的缓存块
+    int             writePos;           // 当前缓存块内的写入位置
+    int             readyCnt;           // 已解析完成可以领取的宏块行数
+    int             nextRow;            // 下一个待领取的宏块行索引
+    int             idleCnt;            // 等待领取宏块行的重建线程数
+    bool            finished;           // 解析是否已结束
+    volatile int    progWaiters;        // 等待其他宏块行重建进度的线程数
+    irk::Mutex      mutex;              // 保护 rows, readyCnt, nextRow, idleCnt, finished
+    irk::CondVar    dataCond;           // 有新的宏块行可以领取
+    irk::CondVar    progCond;           // 宏块行重建进度更新
+    irk::CounterEvent           doneEvt;    // 所有已开始运行的重建任务结束
+    irk::Vector<ReconRow*>      rows;       // 各宏块行命令的开始位置, 按解析顺序排列
+    irk::Vector<FrmDecContext*> workers;    // 重建任务使用的 context
+    irk::Vector<ReconTask*>     tasks;      // 重建任务
+};
+
+// 两级流水线或 wavefront 模式下的重建任务
+class ReconTask : public irk::IAsyncTask
+{
+public:
+    ReconTask(ReconJob* job, FrmDecContext* ctx) : m_state(0), m_job(job), m_ctx(ctx) {}
+    void work() override;
+
+    // 取消尚未开始运行的任务, 返回 false 表示任务已开始运行
+    bool cancel()
+    {
+        return irk::atomic_compare_swap(&m_state, 0, 2) == 0;
+    }
+private:
+    volatile int    m_state;            // 0: 等待运行, 1: 已开始运行, 2: 已取消
+    ReconJob*       m_job;
+    FrmDecContext*  m_ctx;
+};
 
 // 解码器状态
 #define AVS_SEQ_HDR_PARSED  1   // sequence header parsed
@@ -344,19 +592,24 @@ struct AvsContext : IrkAvsDecoder
     PFN_CodecNotify pfnNotify;              // 解码回调函数
     void*           notifyParam;            // 解码回调函数用户私有数据
 
-    PFN_IntraPred   pfnLumaIPred[5];        // 亮度分量帧内预测函数
-    PFN_IntraPred   pfnCbCrIPred[4];        // 色差分量帧内预测函数
-    PFN_DecodeMB    pfnDecMbP[5];           // P 宏块解码函数
-    PFN_DecodeMB    pfnDecMbB[24];          // B 宏块解码函数
-    PFN_DecodeMB    pfnDecMbP_AEC[5];       // P 宏块解码函数, 针对高级熵编码
-    PFN_DecodeMB    pfnDecMbB_AEC[24];      // B 宏块解码函数, 针对高级熵编码
+    DecKernels      kernels;                // 根据 CPU 特性选择的像素处理函数
+    DecStats        stats;                  // 累计的解码统计数据
 
     int             threadCnt;              // 解码使用的线程数
     int             status;                 // 解码器状态
     AvsSeqHdr       seqHdr;                 // sequence header
     int             frameWidth;             // 视频帧宽度, 进位到宏块的整数倍
     int             frameHeight;            // 视频帧高度, 进位到宏块的整数倍
-    int             skipNonRef;             // 是否跳过非参考帧
+    int             skipMode;               // 跳帧模式, IRK_AVS_DEC_SKIP_XXX
+    bool            randomAccess;           // 从随机访问点开始解码, 跳过缺少参考帧的 P/B 帧
+    int             resShift;               // 低分辨率解码时图像缩小倍数的 log2
+    int             outFormat;              // 输出格式, IRK_AVS_OUTPUT_XXX
+    bool            rowConvert;             // 宏块行重建完成后立即转换输出格式, 缩略图模式在缩小后整帧转换
+    bool            edgePadding;            // 是否填充参考帧左右边界, 否则超出图像的参考块都按需扩展
+    bool            rowNotify;              // 解码过程中通知用户已完成的图像行, 缩略图模式不通知
+    PFN_InterleaveCbCr  pfnInterleaveCbCr;  // NV12 输出格式转换函数
+    PFN_PackUYVY    pfnPackUYVY;            // UYVY 输出格式转换函数
+    PFN_FindScCandidate pfnFindSc;          // 查找起始码和伪起始码的函数
     DecFrame*       refFrames[2];           // 全局最新参考帧
     DecFrame*       outFrame;               // 待输出上一个参考帧
 
@@ -364,7 +617,10 @@ struct AvsContext : IrkAvsDecoder
     FrmCtxFactory   ctxFactory;             // 解码 context 工厂
 
     irk::SyncedQueue<FrmDecContext*>        workingQueue;   // 正在解码的 picture context
-    irk::ThreadPool                         threadPool;     // 并行解码线程池
+    irk::WaitableQueue<DecFrame*>           outQueue;       // 拉取模式下待用户取走的解码帧, nullptr 为码流结束标记
+    volatile int                            receiveCnt;     // 正在 irk_avs_decoder_receive_frame 中的调用数
+    irk::ThreadPool*                        threadPool;     // 并行解码线程池, 指向 ownPool 或外部共享线程池
+    irk::ThreadPool                         ownPool;        // 解码器自有线程池
 };
 
 }   // namespace irk_avs_dec
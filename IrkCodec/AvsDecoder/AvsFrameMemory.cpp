@@ -0,0 +1,206 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+#include "AvsDecoder.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdio.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+namespace irk_avs_dec {
+
+static const size_t kHugePageSize = 2 * 1024 * 1024;
+
+#ifdef _WIN32
+
+// 分配大页内存, numaNode < 0 表示不指定 NUMA 节点, 返回实际分配的大小
+// 需要 SeLockMemoryPrivilege 权限才能使用大页, 否则退化为普通页
+void* alloc_huge_pages(size_t size, int numaNode, size_t* allocSize)
+{
+    const DWORD node = (numaNode >= 0) ? (DWORD)numaNode : NUMA_NO_PREFERRED_NODE;
+    void* pbuf = nullptr;
+
+    const SIZE_T largeSize = ::GetLargePageMinimum();
+    if (largeSize > 0)
+    {
+        *allocSize = (size + largeSize - 1) & ~(largeSize - 1);
+        pbuf = ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, *allocSize,
+                                    MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+    }
+    if (!pbuf)
+    {
+        *allocSize = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        pbuf = ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, *allocSize,
+                                    MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+    }
+    return pbuf;
+}
+
+void free_huge_pages(void* pbuf, size_t)
+{
+    ::VirtualFree(pbuf, 0, MEM_RELEASE);
+}
+
+// 新建的线程只运行在 NUMA 节点 numaNode 的 CPU 上, 暂不支持
+void* bind_new_threads(int)
+{
+    return nullptr;
+}
+void restore_new_threads(void*)
+{
+}
+
+#else
+
+#ifdef __linux__
+// 将内存绑定到 NUMA 节点, 节点内存不足时允许使用其他节点(MPOL_PREFERRED)
+// 直接使用系统调用, 不依赖 libnuma
+static void bind_numa_node(void* pbuf, size_t size, int numaNode)
+{
+#ifdef SYS_mbind
+    const int kMPolPreferred = 1;
+    unsigned long nodeMask[16] = {};
+    if (numaNode < (int)(sizeof(nodeMask) * 8))
+    {
+        nodeMask[numaNode / (sizeof(long) * 8)] = 1UL << (numaNode % (sizeof(long) * 8));
+        ::syscall(SYS_mbind, pbuf, size, kMPolPreferred, nodeMask, sizeof(nodeMask) * 8 + 1, 0);
+    }
+#endif
+}
+#endif
+
+// 分配 2M 大页内存, numaNode < 0 表示不指定 NUMA 节点, 返回实际分配的大小
+// 优先使用系统预留的大页(MAP_HUGETLB), 失败则按 2M 对齐分配普通内存并建议内核使用透明大页
+// NOTE: 内存在返回前已全部写入一次, 避免解码时缺页, 未绑定节点时位于当前线程所在节点
+void* alloc_huge_pages(size_t size, int numaNode, size_t* allocSize)
+{
+    const size_t mapSize = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    uint8_t* pbuf = (uint8_t*)MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    pbuf = (uint8_t*)::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (pbuf == (uint8_t*)MAP_FAILED)
+    {
+        // 多映射 2M 以便对齐, 然后释放首尾多余的部分
+        uint8_t* base = (uint8_t*)::mmap(nullptr, mapSize + kHugePageSize, PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == (uint8_t*)MAP_FAILED)
+            return nullptr;
+        pbuf = (uint8_t*)(((uintptr_t)base + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1));
+        if (pbuf > base)
+            ::munmap(base, pbuf - base);
+        if (base + kHugePageSize > pbuf)
+            ::munmap(pbuf + mapSize, base + kHugePageSize - pbuf);
+#ifdef MADV_HUGEPAGE
+        ::madvise(pbuf, mapSize, MADV_HUGEPAGE);
+#endif
+    }
+
+#ifdef __linux__
+    if (numaNode >= 0)
+        bind_numa_node(pbuf, mapSize, numaNode);
+#endif
+
+    // 预先写入, 按照绑定策略分配物理内存
+    const size_t pageSize = (size_t)::sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < mapSize; offset += pageSize)
+        pbuf[offset] = 0;
+
+    *allocSize = mapSize;
+    return pbuf;
+}
+
+void free_huge_pages(void* pbuf, size_t allocSize)
+{
+    ::munmap(pbuf, allocSize);
+}
+
+#ifdef __linux__
+
+// 新建的线程只运行在 NUMA 节点 numaNode 的 CPU 上, 返回之前的设置, 失败返回 nullptr
+// 新线程继承创建者的 CPU 亲和性, 因此临时修改当前线程的亲和性, 创建线程后再调用 restore_new_threads 恢复
+void* bind_new_threads(int numaNode)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", numaNode);
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return nullptr;
+
+    // 格式如 "0-15,32-47"
+    cpu_set_t nodeSet;
+    CPU_ZERO(&nodeSet);
+    int first = 0, last = 0;
+    char sep = 0;
+    while (fscanf(fp, "%d", &first) == 1)
+    {
+        last = first;
+        if (fscanf(fp, "%c", &sep) == 1 && sep == '-')
+        {
+            if (fscanf(fp, "%d", &last) != 1)
+                break;
+            sep = 0;
+            if (fscanf(fp, "%c", &sep) != 1)
+                sep = 0;
+        }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &nodeSet);
+        if (sep != ',')
+            break;
+    }
+    fclose(fp);
+    if (CPU_COUNT(&nodeSet) == 0)
+        return nullptr;
+
+    cpu_set_t* oldSet = new cpu_set_t;
+    if (::sched_getaffinity(0, sizeof(cpu_set_t), oldSet) != 0 ||
+        ::sched_setaffinity(0, sizeof(cpu_set_t), &nodeSet) != 0)
+    {
+        delete oldSet;
+        return nullptr;
+    }
+    return oldSet;
+}
+
+void restore_new_threads(void* oldSet)
+{
+    if (oldSet)
+    {
+        ::sched_setaffinity(0, sizeof(cpu_set_t), (cpu_set_t*)oldSet);
+        delete (cpu_set_t*)oldSet;
+    }
+}
+
+#else
+
+void* bind_new_threads(int)
+{
+    return nullptr;
+}
+void restore_new_threads(void*)
+{
+}
+
+#endif
+#endif
+
+}   // namespace irk_avs_dec
@@ -75,6 +75,51 @@ alignas(16) const int16_t s_RndRow[8] = {64, 64, 64, 64, 64, 64, 64, 64};
     x4 = _mm_adds_epi16( x4, t3 );   /* r2 = e2 + o2 */     \
     x6 = _mm_adds_epi16( x6, t7 );   /* r3 = e3 + o3 */
 
+// 一维 DCT 变换, 输入只有 x0, x1, x2, x3 非零, x4 ~ x7 只用于输出, z 为全 0 寄存器
+// 与 AVS_IDCT_1D 的运算顺序相同, 只是省去了与 0 的运算, 结果完全一致
+#define AVS_IDCT_1D_4(x0, x1, x2, x3, x4, x5, x6, x7, t1, t3, t5, t7, z) \
+    t1 = _mm_adds_epi16( x1, x1 );   /* s1*2 */             \
+    t3 = _mm_adds_epi16( x3, x3 );   /* s3*2 */             \
+    x1 = _mm_adds_epi16( x1, t1 );   /* s1*3 */             \
+    x3 = _mm_adds_epi16( x3, t3 );   /* s3*3 */             \
+    t5 = x3;                         /* s3*3 */             \
+    x5 = _mm_subs_epi16( z, t3 );    /* -s3*2 */            \
+    t7 = _mm_subs_epi16( x1, t1 );   /* s1*1 */             \
+    t3 = _mm_subs_epi16( x5, t5 );   /* -s3*5 */            \
+    x7 = _mm_adds_epi16( x1, t1 );   /* s1*5 */             \
+    x3 = _mm_adds_epi16( x5, t5 );   /* s3*1 */             \
+    x7 = _mm_adds_epi16( x7, t5 );  \
+    t7 = _mm_adds_epi16( t7, x5 );  \
+    x7 = _mm_adds_epi16( x7, x7 );  \
+    t7 = _mm_adds_epi16( t7, t7 );  \
+    t5 = _mm_adds_epi16( t5, x7 );   /* o0 = s1*10 + s3*9 */    \
+    t7 = _mm_adds_epi16( t7, x5 );   /* o3 = s1*2 - s3*6 */     \
+    t3 = _mm_adds_epi16( t3, t1 );  \
+    x3 = _mm_subs_epi16( x1, x3 );  \
+    t3 = _mm_adds_epi16( t3, t3 );  \
+    x3 = _mm_adds_epi16( x3, x3 );  \
+    t3 = _mm_adds_epi16( t3, t1 );   /* o2 = s1*6 - s3*10 */    \
+    t1 = _mm_adds_epi16( x3, x1 );   /* o1 = s1*9 - s3*2 */     \
+    x2 = _mm_adds_epi16( x2, x2 );  \
+    x1 = _mm_slli_epi16( x2, 2 );   \
+    x1 = _mm_adds_epi16( x1, x2 );   /* s2*10 */            \
+    x2 = _mm_adds_epi16( x2, x2 );   /* s2*4 */             \
+    x5 = _mm_subs_epi16( z, x2 );    /* -s2*4 */            \
+    x0 = _mm_slli_epi16( x0, 3 );    /* s0*8 */             \
+    x2 = x0;                        \
+    x4 = _mm_adds_epi16( x2, x5 );   /* e2 */               \
+    x2 = _mm_subs_epi16( x2, x5 );   /* e1 */               \
+    x6 = _mm_subs_epi16( x0, x1 );   /* e3 */               \
+    x0 = _mm_adds_epi16( x0, x1 );   /* e0 */               \
+    x1 = _mm_subs_epi16( x6, t7 );   /* r4 = e3 - o3 */     \
+    x3 = _mm_subs_epi16( x4, t3 );   /* r5 = e2 - o2 */     \
+    x5 = _mm_subs_epi16( x2, t1 );   /* r6 = e1 - o1 */     \
+    x7 = _mm_subs_epi16( x0, t5 );   /* r7 = e0 - o0 */     \
+    x0 = _mm_adds_epi16( x0, t5 );   /* r0 = e0 + o0 */     \
+    x2 = _mm_adds_epi16( x2, t1 );   /* r1 = e1 + o1 */     \
+    x4 = _mm_adds_epi16( x4, t3 );   /* r2 = e2 + o2 */     \
+    x6 = _mm_adds_epi16( x6, t7 );   /* r3 = e3 + o3 */
+
 // 8x8 转置, t1 为临时寄存器
 // 结果依次为: x0, x1, x5, x4, x7, x2, x6, x3
 #define TRANSPOSE_8x8(x0, x1, x2, x3, x4, x5, x6, x7, t1) \
@@ -204,6 +249,127 @@ void IDCT_8x8_add_sse4(const int16_t src[64], uint8_t* dst, int dstPitch)
     _mm_storel_epi64((__m128i*)(dst + dstPitch), tm3);
 }
 
+// 与一行 8 个预测值相加
+static inline void add_residual_8(uint8_t* dst, __m128i res)
+{
+    __m128i xm0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*)dst));
+    xm0 = _mm_adds_epi16(xm0, res);
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(xm0, xm0));
+}
+
+// 非零系数都在左上角 4x4 内, 只读取前 32 个系数
+// 列变换只有 4 个输入, 其结果只有前 4 列非零, 因此行变换也只有 4 个输入
+void IDCT_8x8_add_4x4_sse4(const int16_t src[64], uint8_t* dst, int dstPitch)
+{
+    assert(((uintptr_t)src & 15) == 0);
+    const __m128i xmz = _mm_setzero_si128();
+    __m128i tm1, tm3, tm5, tm7;
+    __m128i xm0 = _mm_load_si128((__m128i*)(src + 8 * 0));
+    __m128i xm1 = _mm_load_si128((__m128i*)(src + 8 * 1));
+    __m128i xm2 = _mm_load_si128((__m128i*)(src + 8 * 2));
+    __m128i xm3 = _mm_load_si128((__m128i*)(src + 8 * 3));
+    __m128i xm4, xm5, xm6, xm7;
+
+    // 列变换, 结果在 xm0, xm2, xm4, xm6, xm1, xm3, xm5, xm7, 每个寄存器只有低 4 个值非零
+    AVS_IDCT_1D_4(xm0, xm1, xm2, xm3, xm4, xm5, xm6, xm7, tm1, tm3, tm5, tm7, xmz);
+
+    // (x + 4) >> 3
+    tm5 = _mm_load_si128((__m128i*)s_RndCol);
+    ROUND_SHIFT(xm0, xm2, xm4, xm6, xm1, xm3, xm5, xm7, tm5, 3);
+
+    // 只转置低 4 列, 结果在 xm0, xm2, xm4, xm6
+    tm1 = _mm_unpacklo_epi16(xm0, xm2);
+    tm3 = _mm_unpacklo_epi16(xm4, xm6);
+    tm5 = _mm_unpacklo_epi16(xm1, xm3);
+    tm7 = _mm_unpacklo_epi16(xm5, xm7);
+    xm1 = _mm_unpacklo_epi32(tm1, tm3);
+    xm3 = _mm_unpackhi_epi32(tm1, tm3);
+    xm5 = _mm_unpacklo_epi32(tm5, tm7);
+    xm7 = _mm_unpackhi_epi32(tm5, tm7);
+    xm0 = _mm_unpacklo_epi64(xm1, xm5);
+    xm2 = _mm_unpackhi_epi64(xm1, xm5);
+    xm4 = _mm_unpacklo_epi64(xm3, xm7);
+    xm6 = _mm_unpackhi_epi64(xm3, xm7);
+
+    // 行变换, 结果依次在 xm0, xm4, xm1, xm5, xm2, xm6, xm3, xm7
+    AVS_IDCT_1D_4(xm0, xm2, xm4, xm6, xm1, xm3, xm5, xm7, tm1, tm3, tm5, tm7, xmz);
+
+    // (x + 64) >> 7
+    tm5 = _mm_load_si128((__m128i*)s_RndRow);
+    ROUND_SHIFT(xm0, xm2, xm4, xm6, xm1, xm3, xm5, xm7, tm5, 7);
+
+    // 与预测值相加
+    add_residual_8(dst + dstPitch * 0, xm0);
+    add_residual_8(dst + dstPitch * 1, xm4);
+    add_residual_8(dst + dstPitch * 2, xm1);
+    add_residual_8(dst + dstPitch * 3, xm5);
+    add_residual_8(dst + dstPitch * 4, xm2);
+    add_residual_8(dst + dstPitch * 5, xm6);
+    add_residual_8(dst + dstPitch * 6, xm3);
+    add_residual_8(dst + dstPitch * 7, xm7);
+}
+
+// 只有 DC 系数的反变换, 只读取 src[0], 缩略图模式也用于所有 8x8 块
+// 列变换后为 (DC * 8 + 4) >> 3, 行变换后为 (x * 8 + 64) >> 7
+// 按与完整变换相同的 16 位运算计算, 系数超出正常范围时结果也保持一致
+void IDCT_8x8_add_1x1_sse4(const int16_t src[64], uint8_t* dst, int dstPitch)
+{
+    __m128i dc = _mm_set1_epi16(src[0]);
+    dc = _mm_slli_epi16(dc, 3);
+    dc = _mm_srai_epi16(_mm_adds_epi16(dc, _mm_load_si128((__m128i*)s_RndCol)), 3);
+    dc = _mm_slli_epi16(dc, 3);
+    dc = _mm_srai_epi16(_mm_adds_epi16(dc, _mm_load_si128((__m128i*)s_RndRow)), 7);
+    for (int i = 0; i < 8; i++)
+    {
+        add_residual_8(dst, dc);
+        dst += dstPitch;
+    }
+}
+
+// 水平相邻的两个 8x8 块, 系数依次存放
+void IDCT_16x8_add_sse4(const int16_t src[128], uint8_t* dst, int dstPitch)
+{
+    IDCT_8x8_add_sse4(src, dst, dstPitch);
+    IDCT_8x8_add_sse4(src + 64, dst + 8, dstPitch);
+}
+
+// 缩略图模式, 水平相邻的两个 8x8 块都只使用 DC 系数
+void IDCT_16x8_add_dc_sse4(const int16_t src[128], uint8_t* dst, int dstPitch)
+{
+    IDCT_8x8_add_1x1_sse4(src, dst, dstPitch);
+    IDCT_8x8_add_1x1_sse4(src + 64, dst + 8, dstPitch);
+}
+
+// 缩略图模式, 每个 8x8 块取平均值作为一个像素, 结果按原 pitch 存放在 plane 左上角
+// NOTE: 按光栅顺序处理, 写入的像素所在的块都已处理过, 因此可以原地缩小
+// NOTE: 按 16 字节读取两个块, 需要宽高进位到 8 的整数倍后的区域可读, 以及右边 8 字节的填充
+void downscale_8x8_sse4(uint8_t* plane, int pitch, int width, int height)
+{
+    const int dstWidth = (width + 7) >> 3;
+    const int dstHeight = (height + 7) >> 3;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rnd = _mm_set1_epi32(32);
+    uint8_t* dst = plane;
+
+    for (int y = 0; y < dstHeight; y++)
+    {
+        const uint8_t* src = plane + pitch * 8 * y;
+        for (int x = 0; x < dstWidth; x += 2)
+        {
+            // 两个块的像素和分别在低 64 位和高 64 位
+            __m128i sum = _mm_sad_epu8(_mm_loadu_si128((__m128i*)(src + 8 * x)), zero);
+            for (int i = 1; i < 8; i++)
+                sum = _mm_add_epi32(sum, _mm_sad_epu8(_mm_loadu_si128((__m128i*)(src + 8 * x + pitch * i)), zero));
+            sum = _mm_srli_epi32(_mm_add_epi32(sum, rnd), 6);
+
+            dst[x] = (uint8_t)_mm_cvtsi128_si32(sum);
+            if (x + 1 < dstWidth)
+                dst[x + 1] = (uint8_t)_mm_extract_epi16(sum, 4);
+        }
+        dst += pitch;
+    }
+}
+
 //======================================================================================================================
 // 标准 C 实现, 用作参考
 
@@ -0,0 +1,195 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+// 本文件单独使用 AVX2 编译选项, 只能被运行时检测到 AVX2 支持后调用
+// 注意: 不要在本文件中调用头文件中的非 static inline 函数, 避免链接时与 SSE 版本混淆
+
+#include <immintrin.h>      // AVX2
+#include <assert.h>
+#include <stdint.h>
+
+// 与 AvsIdct.cpp 相同的运算, 低 128 位为左边的块, 高 128 位为右边的块
+
+// 一维 DCT 变换, t1, t3, t5, t7 为临时寄存器
+// 结果依次为 x0, x2, x4, x6, x1, x3, x5, x7
+#define AVS_IDCT_1D(x0, x1, x2, x3, x4, x5, x6, x7, t1, t3, t5, t7) \
+    t1 = _mm256_adds_epi16( x1, x1 );   /* s1*2 */          \
+    t7 = _mm256_adds_epi16( x7, x7 );   /* s7*2 */          \
+    t3 = _mm256_adds_epi16( x3, x3 );   /* s3*2 */          \
+    t5 = _mm256_adds_epi16( x5, x5 );   /* s5*2 */          \
+    x1 = _mm256_adds_epi16( x1, t1 );   /* s1*3 */          \
+    x7 = _mm256_adds_epi16( x7, t7 );   /* s7*3 */          \
+    x3 = _mm256_adds_epi16( x3, t3 );   /* s3*3 */          \
+    x5 = _mm256_adds_epi16( x5, t5 );   /* s5*3 */          \
+    t1 = _mm256_adds_epi16( t1, x7 );   /* s1*2 + s7*3 */   \
+    t5 = _mm256_adds_epi16( t5, x3 );   /* s5*2 + s3*3 */   \
+    x1 = _mm256_subs_epi16( x1, t7 );   /* s1*3 - s7*2 */   \
+    x5 = _mm256_subs_epi16( x5, t3 );   /* s5*3 - s3*2 */   \
+    t7 = _mm256_subs_epi16( x1, t1 );   /* s1*1 - s7*5 */   \
+    t3 = _mm256_subs_epi16( x5, t5 );   /* s5*1 - s3*5 */   \
+    x7 = _mm256_adds_epi16( x1, t1 );   /* s1*5 + s7*1 */   \
+    x3 = _mm256_adds_epi16( x5, t5 );   /* s5*5 + s3*1 */   \
+    x7 = _mm256_adds_epi16( x7, t5 );  \
+    t7 = _mm256_adds_epi16( t7, x5 );  \
+    x7 = _mm256_adds_epi16( x7, x7 );  \
+    t7 = _mm256_adds_epi16( t7, t7 );  \
+    t5 = _mm256_adds_epi16( t5, x7 );   /* o0 = s1*10 + s3*9 + s5*6 + s7*2 */  \
+    t7 = _mm256_adds_epi16( t7, x5 );   /* o3 = s1*2 - s3*6 + s5*9 - s7*10 */  \
+    t3 = _mm256_adds_epi16( t3, t1 );  \
+    x3 = _mm256_subs_epi16( x1, x3 );  \
+    t3 = _mm256_adds_epi16( t3, t3 );  \
+    x3 = _mm256_adds_epi16( x3, x3 );  \
+    t3 = _mm256_adds_epi16( t3, t1 );   /* o2 = s1*6 - s2*10 + s5*2 + s7*9 */  \
+    t1 = _mm256_adds_epi16( x3, x1 );   /* o1 = s1*9 - s3*2 - s5*10 - s7*6 */  \
+    x2 = _mm256_adds_epi16( x2, x2 );  \
+    x6 = _mm256_adds_epi16( x6, x6 );  \
+    x1 = _mm256_slli_epi16( x2, 2 );   \
+    x5 = _mm256_slli_epi16( x6, 2 );   \
+    x1 = _mm256_adds_epi16( x1, x2 );   /* s2*10 */ \
+    x5 = _mm256_adds_epi16( x5, x6 );   /* s6*10 */ \
+    x6 = _mm256_adds_epi16( x6, x6 );   /* s6*4 */  \
+    x2 = _mm256_adds_epi16( x2, x2 );   /* s2*4 */  \
+    x1 = _mm256_adds_epi16( x1, x6 );   /* s2*10 + s6*4 */  \
+    x5 = _mm256_subs_epi16( x5, x2 );   /* s6*10 - s2*4 */  \
+    x2 = _mm256_subs_epi16( x0, x4 );  \
+    x0 = _mm256_adds_epi16( x0, x4 );  \
+    x2 = _mm256_slli_epi16( x2, 3 );    /* (s0 - s4)*8 */   \
+    x0 = _mm256_slli_epi16( x0, 3 );    /* (s0 + s4)*8 */   \
+    x4 = _mm256_adds_epi16( x2, x5 );   /* e2 */            \
+    x2 = _mm256_subs_epi16( x2, x5 );   /* e1 */            \
+    x6 = _mm256_subs_epi16( x0, x1 );   /* e3 */            \
+    x0 = _mm256_adds_epi16( x0, x1 );   /* e0 */            \
+    x1 = _mm256_subs_epi16( x6, t7 );   /* r4 = e3 - o3 */  \
+    x3 = _mm256_subs_epi16( x4, t3 );   /* r5 = e2 - o2 */  \
+    x5 = _mm256_subs_epi16( x2, t1 );   /* r6 = e1 - o1 */  \
+    x7 = _mm256_subs_epi16( x0, t5 );   /* r7 = e0 - o0 */  \
+    x0 = _mm256_adds_epi16( x0, t5 );   /* r0 = e0 + o0 */  \
+    x2 = _mm256_adds_epi16( x2, t1 );   /* r1 = e1 + o1 */  \
+    x4 = _mm256_adds_epi16( x4, t3 );   /* r2 = e2 + o2 */  \
+    x6 = _mm256_adds_epi16( x6, t7 );   /* r3 = e3 + o3 */
+
+// 8x8 转置, t1 为临时寄存器, 高低 128 位分别转置
+// 结果依次为: x0, x1, x5, x4, x7, x2, x6, x3
+#define TRANSPOSE_8x8(x0, x1, x2, x3, x4, x5, x6, x7, t1) \
+    t1 = x7;    \
+    x7 = _mm256_unpackhi_epi16( x0, x1 );  \
+    x0 = _mm256_unpacklo_epi16( x0, x1 );  \
+    x1 = _mm256_unpackhi_epi16( x2, x3 );  \
+    x2 = _mm256_unpacklo_epi16( x2, x3 );  \
+    x3 = _mm256_unpackhi_epi16( x4, x5 );  \
+    x4 = _mm256_unpacklo_epi16( x4, x5 );  \
+    x5 = _mm256_unpackhi_epi16( x6, t1 );  \
+    x6 = _mm256_unpacklo_epi16( x6, t1 );  \
+    t1 = x5;    \
+    x5 = _mm256_unpackhi_epi32( x0, x2 );  \
+    x0 = _mm256_unpacklo_epi32( x0, x2 );  \
+    x2 = _mm256_unpackhi_epi32( x4, x6 );  \
+    x4 = _mm256_unpacklo_epi32( x4, x6 );  \
+    x6 = _mm256_unpackhi_epi32( x7, x1 );  \
+    x7 = _mm256_unpacklo_epi32( x7, x1 );  \
+    x1 = _mm256_unpackhi_epi32( x3, t1 );  \
+    x3 = _mm256_unpacklo_epi32( x3, t1 );  \
+    t1 = x1;    \
+    x1 = _mm256_unpackhi_epi64( x0, x4 );  \
+    x0 = _mm256_unpacklo_epi64( x0, x4 );  \
+    x4 = _mm256_unpackhi_epi64( x5, x2 );  \
+    x5 = _mm256_unpacklo_epi64( x5, x2 );  \
+    x2 = _mm256_unpackhi_epi64( x7, x3 );  \
+    x7 = _mm256_unpacklo_epi64( x7, x3 );  \
+    x3 = _mm256_unpackhi_epi64( x6, t1 );  \
+    x6 = _mm256_unpacklo_epi64( x6, t1 );
+
+// (x + rnd) >> shf
+#define ROUND_SHIFT(x0, x1, x2, x3, x4, x5, x6, x7, rnd, shf) \
+    x0 = _mm256_adds_epi16( x0, rnd ); \
+    x1 = _mm256_adds_epi16( x1, rnd ); \
+    x2 = _mm256_adds_epi16( x2, rnd ); \
+    x3 = _mm256_adds_epi16( x3, rnd ); \
+    x0 = _mm256_srai_epi16( x0, shf ); \
+    x1 = _mm256_srai_epi16( x1, shf ); \
+    x2 = _mm256_srai_epi16( x2, shf ); \
+    x3 = _mm256_srai_epi16( x3, shf ); \
+    x4 = _mm256_adds_epi16( x4, rnd ); \
+    x5 = _mm256_adds_epi16( x5, rnd ); \
+    x6 = _mm256_adds_epi16( x6, rnd ); \
+    x7 = _mm256_adds_epi16( x7, rnd ); \
+    x4 = _mm256_srai_epi16( x4, shf ); \
+    x5 = _mm256_srai_epi16( x5, shf ); \
+    x6 = _mm256_srai_epi16( x6, shf ); \
+    x7 = _mm256_srai_epi16( x7, shf );
+
+namespace irk_avs_dec {
+
+// 加载两个块的同一行系数, 低 128 位为左边的块
+static inline __m256i load_coeff_pair(const int16_t* src, int row)
+{
+    __m128i lo = _mm_load_si128((const __m128i*)(src + 8 * row));
+    __m128i hi = _mm_load_si128((const __m128i*)(src + 64 + 8 * row));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// 两行 16 个像素与预测值相加
+static inline void add_residual_16x2(uint8_t* dst, int dstPitch, __m256i res0, __m256i res1)
+{
+    __m256i ym0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)dst));
+    __m256i ym1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(dst + dstPitch)));
+    ym0 = _mm256_adds_epi16(ym0, res0);
+    ym1 = _mm256_adds_epi16(ym1, res1);
+    ym0 = _mm256_packus_epi16(ym0, ym1);
+    ym0 = _mm256_permute4x64_epi64(ym0, 0xD8);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(ym0));
+    _mm_storeu_si128((__m128i*)(dst + dstPitch), _mm256_extracti128_si256(ym0, 1));
+}
+
+// 水平相邻的两个 8x8 块一起反变换, 系数依次存放, 每个块为列主序
+void IDCT_16x8_add_avx2(const int16_t src[128], uint8_t* dst, int dstPitch)
+{
+    assert(((uintptr_t)src & 15) == 0);
+    __m256i tm1, tm3, tm5, tm7;
+    __m256i ym0 = load_coeff_pair(src, 0);
+    __m256i ym1 = load_coeff_pair(src, 1);
+    __m256i ym2 = load_coeff_pair(src, 2);
+    __m256i ym3 = load_coeff_pair(src, 3);
+    __m256i ym4 = load_coeff_pair(src, 4);
+    __m256i ym5 = load_coeff_pair(src, 5);
+    __m256i ym6 = load_coeff_pair(src, 6);
+    __m256i ym7 = load_coeff_pair(src, 7);
+
+    // 列变换, 结果在 ym0, ym2, ym4, ym6, ym1, ym3, ym5, ym7
+    AVS_IDCT_1D(ym0, ym1, ym2, ym3, ym4, ym5, ym6, ym7, tm1, tm3, tm5, tm7);
+
+    // (x + 4) >> 3
+    tm5 = _mm256_set1_epi16(4);
+    ROUND_SHIFT(ym0, ym2, ym4, ym6, ym1, ym3, ym5, ym7, tm5, 3);
+
+    // 8x8 转置, 结果在 ym0, ym2, ym3, ym1, ym7, ym4, ym5, ym6
+    TRANSPOSE_8x8(ym0, ym2, ym4, ym6, ym1, ym3, ym5, ym7, tm5);
+
+    // 行变换, 结果在 ym0, ym3, ym7, ym5, ym2, ym1, ym4, ym6
+    AVS_IDCT_1D(ym0, ym2, ym3, ym1, ym7, ym4, ym5, ym6, tm1, tm3, tm5, tm7);
+
+    // (x + 64) >> 7
+    tm5 = _mm256_set1_epi16(64);
+    ROUND_SHIFT(ym0, ym3, ym7, ym5, ym2, ym1, ym4, ym6, tm5, 7);
+
+    // 与预测值相加
+    add_residual_16x2(dst, dstPitch, ym0, ym3);
+    dst += dstPitch * 2;
+    add_residual_16x2(dst, dstPitch, ym7, ym5);
+    dst += dstPitch * 2;
+    add_residual_16x2(dst, dstPitch, ym2, ym1);
+    dst += dstPitch * 2;
+    add_residual_16x2(dst, dstPitch, ym4, ym6);
+}
+
+}   // namespace irk_avs_dec
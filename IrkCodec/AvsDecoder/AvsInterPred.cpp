@@ -85,37 +85,30 @@ MvUnion get_mv_pred2(const MvInfo abcMVS[3], int refDist)
 //======================================================================================================================
 // AVS 标准允许指向参考帧有效范围外, 此时需填充
 
-struct McExtRect
-{
-    int         x;
-    int         y;
-    int         height;
-    int         picWidth;
-    int         picHeight;
-    uint8_t*    buf;
-};
-
 static void MC_extend_32(const uint8_t* src, int pitch, int x, int height, int maxX, uint8_t* dst)
 {
-    // 边界有填充, 且 x86 支持非对齐读写
+    // x86 支持非对齐读写, 但图像左右边界可能没有填充, 不能读取图像外的数据
     if (x < 0)                     // left
     {
+        const int x4 = (-x + 3) & ~3;   // mulitple of 4 >= -x
         for (int i = 0; i < height; i++)
         {
             __m128i xm0 = _mm_set1_epi8(src[0]);
             _mm_store_si128((__m128i*)dst, xm0);
             _mm_store_si128((__m128i*)(dst + 16), xm0);
-            for (int j = (-x & ~3); j < 24; j += 4)
+            for (int j = -x; j < x4 && j < 24; j++)
+                dst[j] = src[j + x];
+            for (int j = x4; j < 24; j += 4)
                 *(uint32_as*)(dst + j) = *(uint32_as*)(src + j + x);
 
             dst += 32;
             src += pitch;
         }
     }
-    else if (maxX - x < 24)         // right
+    else if (maxX - x < 32)         // right
     {
-        int xx = maxX - x;
-        int x4 = (xx + 3) & ~3;     // mulitple of 4 >= xx
+        const int xx = maxX - x;
+        const int x4 = xx & ~3;     // mulitple of 4 <= xx
         src += maxX;
         for (int i = 0; i < height; ++i)
         {
@@ -124,6 +117,8 @@ static void MC_extend_32(const uint8_t* src, int pitch, int x, int height, int m
             _mm_store_si128((__m128i*)(dst + 16), xm0);
             for (int j = 0; j < x4; j += 4)
                 *(uint32_as*)(dst + j) = *(uint32_as*)(src + j - xx);
+            for (int j = (x4 > 0 ? x4 : 0); j < xx; j++)
+                dst[j] = src[j - xx];
 
             dst += 32;
             src += pitch;
@@ -146,14 +141,17 @@ static void MC_extend_32(const uint8_t* src, int pitch, int x, int height, int m
 
 static void MC_extend_16(const uint8_t* src, int pitch, int x, int height, int maxX, uint8_t* dst)
 {
-    // 边界有填充, 且 x86 支持非对齐读写
+    // x86 支持非对齐读写, 但图像左右边界可能没有填充, 不能读取图像外的数据
     if (x < 0)  // left
     {
+        const int x4 = (-x + 3) & ~3;   // mulitple of 4 >= -x
         for (int i = 0; i < height; i++)
         {
             __m128i xm0 = _mm_set1_epi8(src[0]);
             _mm_store_si128((__m128i*)dst, xm0);
-            for (int j = (-x & ~3); j < 16; j += 4)
+            for (int j = -x; j < x4 && j < 16; j++)
+                dst[j] = src[j + x];
+            for (int j = x4; j < 16; j += 4)
                 *(uint32_as*)(dst + j) = *(uint32_as*)(src + j + x);
 
             dst += 16;
@@ -162,8 +160,8 @@ static void MC_extend_16(const uint8_t* src, int pitch, int x, int height, int m
     }
     else if (maxX - x < 16)         // right
     {
-        int xx = maxX - x;
-        int x4 = (xx + 3) & ~3;     // mulitple of 4 >= xx
+        const int xx = maxX - x;
+        const int x4 = xx & ~3;     // mulitple of 4 <= xx
         src += maxX;
         for (int i = 0; i < height; ++i)
         {
@@ -171,6 +169,8 @@ static void MC_extend_16(const uint8_t* src, int pitch, int x, int height, int m
             _mm_store_si128((__m128i*)dst, xm0);
             for (int j = 0; j < x4; j += 4)
                 *(uint32_as*)(dst + j) = *(uint32_as*)(src + j - xx);
+            for (int j = (x4 > 0 ? x4 : 0); j < xx; j++)
+                dst[j] = src[j - xx];
 
             dst += 16;
             src += pitch;
@@ -191,7 +191,7 @@ static void MC_extend_16(const uint8_t* src, int pitch, int x, int height, int m
 
 static void MC_extend_8(const uint8_t* src, int pitch, int x, int height, int maxX, uint8_t* dst)
 {
-    if (x < -8)         // left
+    if (x <= -8)        // left
     {
         for (int i = 0; i < height; i++)
         {
@@ -202,7 +202,7 @@ static void MC_extend_8(const uint8_t* src, int pitch, int x, int height, int ma
             src += pitch;
         }
     }
-    else if (x > maxX)  // right
+    else if (x >= maxX) // right
     {
         src += maxX - 1;
         for (int i = 0; i < height; i++)
@@ -214,6 +214,16 @@ static void MC_extend_8(const uint8_t* src, int pitch, int x, int height, int ma
             src += pitch;
         }
     }
+    else if (x < 0 || maxX - x < 8)     // 跨越左右边界, 图像左右边界可能没有填充, 逐点限制到图像内
+    {
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < 8; j++)
+                dst[j] = src[clip3(x + j, 0, maxX - 1)];
+            dst += 8;
+            src += pitch;
+        }
+    }
     else
     {
         src += x;
@@ -228,7 +238,7 @@ static void MC_extend_8(const uint8_t* src, int pitch, int x, int height, int ma
 }
 
 // 得到 32xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 32
-static void get_ref_data_32xN(const uint8_t* src, int pitch, const McExtRect& rc)
+void get_ref_data_32xN(const uint8_t* src, int pitch, const McExtRect& rc)
 {
     uint8_t* dst = rc.buf;
     assert(((uintptr_t)dst & 15) == 0);
@@ -280,7 +290,7 @@ static void get_ref_data_32xN(const uint8_t* src, int pitch, const McExtRect& rc
 }
 
 // 得到 16xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 16
-static void get_ref_data_16xN(const uint8_t* src, int pitch, const McExtRect& rc)
+void get_ref_data_16xN(const uint8_t* src, int pitch, const McExtRect& rc)
 {
     uint8_t* dst = rc.buf;
     assert(((uintptr_t)dst & 15) == 0);
@@ -328,7 +338,7 @@ static void get_ref_data_16xN(const uint8_t* src, int pitch, const McExtRect& rc
 }
 
 // 得到 8xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 8
-static void get_ref_data_8xN(const uint8_t* src, int pitch, const McExtRect& rc)
+void get_ref_data_8xN(const uint8_t* src, int pitch, const McExtRect& rc)
 {
     assert(((uintptr_t)rc.buf & 15) == 0);
     uint8_t* dst = rc.buf;
@@ -1389,37 +1399,6 @@ static void MC_luma_8xN_x2y3(const int16_t* src, uint8_t* dst, int dstPitch, int
 
 //======================================================================================================================
 
-// 判断 rc1 是否包含在 rc2 中
-static inline bool in_rect_of(const Rect* rc1, const Rect* rc2)
-{
-    __m128i xm0 = _mm_loadu_si128((__m128i*)rc1);
-    __m128i xm1 = _mm_loadu_si128((__m128i*)rc2);
-    const int mask = _mm_movemask_epi8(_mm_cmpgt_epi32(xm0, xm1));
-    return mask == 0xFF;
-}
-
-// 检查参考帧数据是否已解码, 未解码等待
-static inline void check_ref_data(FrmDecContext* ctx, DecFrame* refFrame, int y)
-{
-    assert(refFrame->decState);
-
-    if (ctx->curFrame == refFrame) // 同一帧的第二场, 第一场数据总是已解码
-    {
-        assert(ctx->fieldIdx == 1);
-        return;
-    }
-
-    int refLine = y * (2 - ctx->frameCoding);   // 可能存在帧场自适应编码, 全部转化为帧的刻度
-    if (refLine <= refFrame->decState->m_lineReady)
-    {
-        return;
-    }
-
-    // 等待参考帧, +32 是为了让参考帧多解码一些
-    ctx->refRequest.m_refLine = refLine + 32;
-    refFrame->decState->wait_request(&ctx->refRequest);
-}
-
 // 16x16 亮度分量帧间预测
 void luma_inter_pred_16x16(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch, int x, int y)
 {
@@ -2625,4 +2604,110 @@ void MC_avg_4xN(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, in
     }
 }
 
+//======================================================================================================================
+// 帧间预测同时加权及取平均, 先预测到临时缓存, 再依次加权及取平均
+
+template<PFN_LumaInterPred MC, PFN_WeightPred WP, PFN_MCAvg AVG, int N>
+static void luma_inter_pred_blend(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    if (blend->mode & MC_BLEND_AVG)
+    {
+        uint8_t* mcBuf = ctx->mcBuff;
+        (*MC)(ctx, refpic, mcBuf, 16, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+            (*WP)(mcBuf, 16, blend->scale, blend->delta, N);
+        (*AVG)(mcBuf, 16, dst, dstPitch, N);
+    }
+    else
+    {
+        (*MC)(ctx, refpic, dst, dstPitch, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+            (*WP)(dst, dstPitch, blend->scale, blend->delta, N);
+    }
+}
+
+template<PFN_ChromaInterPred MC, PFN_WeightPred WP, PFN_MCAvg AVG, int N>
+static void chroma_inter_pred_blend(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    if (blend->mode & MC_BLEND_AVG)
+    {
+        uint8_t* mcBuf[2] = {ctx->mcBuff, ctx->mcBuff + 256};
+        (*MC)(ctx, refpic, mcBuf[0], mcBuf[1], 16, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+        {
+            (*WP)(mcBuf[0], 16, blend->scale, blend->delta, N);
+            (*WP)(mcBuf[1], 16, blend->scale, blend->delta, N);
+        }
+        (*AVG)(mcBuf[0], 16, dstCb, dstPitch, N);
+        (*AVG)(mcBuf[1], 16, dstCr, dstPitch, N);
+    }
+    else
+    {
+        (*MC)(ctx, refpic, dstCb, dstCr, dstPitch, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+        {
+            (*WP)(dstCb, dstPitch, blend->scale, blend->delta, N);
+            (*WP)(dstCr, dstPitch, blend->scale, blend->delta, N);
+        }
+    }
+}
+
+void luma_inter_pred_blend_16x16(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend<&luma_inter_pred_16x16, &weight_pred_16xN, &MC_avg_16xN, 16>(
+        ctx, refpic, dst, dstPitch, x, y, blend);
+}
+
+void luma_inter_pred_blend_16x8(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend<&luma_inter_pred_16x8, &weight_pred_16xN, &MC_avg_16xN, 8>(
+        ctx, refpic, dst, dstPitch, x, y, blend);
+}
+
+void luma_inter_pred_blend_8x16(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend<&luma_inter_pred_8x16, &weight_pred_8xN, &MC_avg_8xN, 16>(
+        ctx, refpic, dst, dstPitch, x, y, blend);
+}
+
+void luma_inter_pred_blend_8x8(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend<&luma_inter_pred_8x8, &weight_pred_8xN, &MC_avg_8xN, 8>(
+        ctx, refpic, dst, dstPitch, x, y, blend);
+}
+
+void chroma_inter_pred_blend_8x8(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend<&chroma_inter_pred_8x8, &weight_pred_8xN, &MC_avg_8xN, 8>(
+        ctx, refpic, dstCb, dstCr, dstPitch, x, y, blend);
+}
+
+void chroma_inter_pred_blend_8x4(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend<&chroma_inter_pred_8x4, &weight_pred_8xN, &MC_avg_8xN, 4>(
+        ctx, refpic, dstCb, dstCr, dstPitch, x, y, blend);
+}
+
+void chroma_inter_pred_blend_4x8(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend<&chroma_inter_pred_4x8, &weight_pred_4xN, &MC_avg_4xN, 8>(
+        ctx, refpic, dstCb, dstCr, dstPitch, x, y, blend);
+}
+
+void chroma_inter_pred_blend_4x4(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend<&chroma_inter_pred_4x4, &weight_pred_4xN, &MC_avg_4xN, 4>(
+        ctx, refpic, dstCb, dstCr, dstPitch, x, y, blend);
+}
+
 }   // namespace irk_avs_dec
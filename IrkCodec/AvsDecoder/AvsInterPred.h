@@ -14,6 +14,7 @@
 #ifndef _AVS_INTERPRED_H_
 #define _AVS_INTERPRED_H_
 
+#include <emmintrin.h>  // SSE-2
 #include <stdint.h>
 
 namespace irk_avs_dec {
@@ -61,6 +62,51 @@ struct Rect
     int     y2;
 };
 
+// 判断 rc1 是否包含在 rc2 中
+// 使用 static, 避免与 AVX 编译的版本混淆
+static inline bool in_rect_of(const Rect* rc1, const Rect* rc2)
+{
+    __m128i xm0 = _mm_loadu_si128((__m128i*)rc1);
+    __m128i xm1 = _mm_loadu_si128((__m128i*)rc2);
+    const int mask = _mm_movemask_epi8(_mm_cmpgt_epi32(xm0, xm1));
+    return mask == 0xFF;
+}
+
+// 超出参考帧有效范围的参考数据
+struct McExtRect
+{
+    int         x;
+    int         y;
+    int         height;
+    int         picWidth;
+    int         picHeight;
+    uint8_t*    buf;
+};
+
+// 加权预测及双向预测取平均的处理方式
+enum
+{
+    MC_BLEND_WEIGHT = 1,        // 加权预测
+    MC_BLEND_AVG = 2,           // 与目标位置已有的预测值取平均, 用于双向预测的后向预测
+};
+
+// 加权预测及双向预测取平均在帧间预测写入目标位置时一并完成, 避免预测块的额外读写
+struct McBlend
+{
+    int         mode;           // MC_BLEND_WEIGHT, MC_BLEND_AVG 的组合
+    int         scale;          // 加权预测系数
+    int         delta;          // 加权预测偏移
+};
+
+// 得到 32xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 32
+void get_ref_data_32xN(const uint8_t* src, int pitch, const McExtRect& rc);
+
+// 得到 16xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 16
+void get_ref_data_16xN(const uint8_t* src, int pitch, const McExtRect& rc);
+
+// 得到 8xN 大小的参考图像, 如果超出原始图像范围, 用边界点填充, 结果的行宽为 8
+void get_ref_data_8xN(const uint8_t* src, int pitch, const McExtRect& rc);
+
 // 得到运动矢量预测
 // abcMVS: 周边 block 的参考帧, 运动矢量等信息
 // refDist: 当前 block 参考距离
@@ -98,6 +144,38 @@ void chroma_inter_pred_4x8(FrmDecContext*, const RefPicture*,
 void chroma_inter_pred_4x4(FrmDecContext*, const RefPicture*,
     uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
 
+// 16x16 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x16(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 16x8 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x8(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 8x16 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_8x16(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 8x8 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_8x8(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 8x8 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_8x8(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 8x4 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_8x4(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 4x8 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_4x8(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 4x4 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_4x4(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
 // 加权预测, 16x16, 16x8
 void weight_pred_16xN(uint8_t* dst, int pitch, int scale, int delta, int N);
 
@@ -116,5 +194,77 @@ void MC_avg_8xN(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, in
 // 取平均, 4x8, 4x4
 void MC_avg_4xN(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N);
 
+//======================================================================================================================
+// AVX2 优化版本, 需运行时检测 CPU 支持
+
+// 16x16 亮度分量帧间预测
+void luma_inter_pred_16x16_avx2(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y);
+
+// 16x8 亮度分量帧间预测
+void luma_inter_pred_16x8_avx2(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y);
+
+// 8x8 色差分量帧间预测, Cb/Cr 同时处理
+void chroma_inter_pred_8x8_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
+
+// 8x4 色差分量帧间预测, Cb/Cr 同时处理
+void chroma_inter_pred_8x4_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
+
+// 4x8 色差分量帧间预测, Cb/Cr 同时处理
+void chroma_inter_pred_4x8_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
+
+// 4x4 色差分量帧间预测, Cb/Cr 同时处理
+void chroma_inter_pred_4x4_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
+
+// 16x16 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x16_avx2(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 16x8 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x8_avx2(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 8x8 色差分量帧间预测, 同时加权及取平均, Cb/Cr 同时处理
+void chroma_inter_pred_blend_8x8_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 8x4 色差分量帧间预测, 同时加权及取平均, Cb/Cr 同时处理
+void chroma_inter_pred_blend_8x4_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 4x8 色差分量帧间预测, 同时加权及取平均, Cb/Cr 同时处理
+void chroma_inter_pred_blend_4x8_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+// 4x4 色差分量帧间预测, 同时加权及取平均, Cb/Cr 同时处理
+void chroma_inter_pred_blend_4x4_avx2(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
+//======================================================================================================================
+
+// 亮度分量帧间预测函数原型
+typedef void(*PFN_LumaInterPred)(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y);
+
+// 色差分量帧间预测函数原型
+typedef void(*PFN_ChromaInterPred)(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y);
+
+// 加权预测函数原型
+typedef void(*PFN_WeightPred)(uint8_t* dst, int pitch, int scale, int delta, int N);
+
+// 取平均函数原型
+typedef void(*PFN_MCAvg)(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N);
+
+// 亮度分量帧间预测, 同时加权及取平均的函数原型
+typedef void(*PFN_LumaInterPredBlend)(FrmDecContext*, const RefPicture*, uint8_t* dst, int dstPitch, int x, int y,
+    const McBlend* blend);
+
+// 色差分量帧间预测, 同时加权及取平均的函数原型
+typedef void(*PFN_ChromaInterPredBlend)(FrmDecContext*, const RefPicture*,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend);
+
 }   // namespace irk_avs_dec
 #endif
@@ -0,0 +1,1111 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+// 本文件单独使用 AVX2 编译选项, 只能被运行时检测到 AVX2 支持后调用
+// 注意: 不要在本文件中调用头文件中的非 static inline 函数, 避免链接时与 SSE 版本混淆
+
+#include <immintrin.h>      // AVX2
+#include "AvsDecoder.h"
+
+namespace irk_avs_dec {
+
+//======================================================================================================================
+// 预测值写入目标位置, 同时完成加权预测及与目标位置已有的预测值取平均, 预测块只需写入一次
+// MODE 为 MC_BLEND_WEIGHT, MC_BLEND_AVG 的组合, 运算顺序与单独加权及取平均相同, 保证结果一致
+
+template<int MODE>
+struct McStore
+{
+    __m256i     smm;    // 加权预测系数
+    __m256i     dmm;    // 加权预测偏移
+    __m256i     amm;    // 舍入值
+
+    explicit McStore(const McBlend* blend)
+    {
+        if (MODE & MC_BLEND_WEIGHT)
+        {
+            smm = _mm256_set1_epi16(blend->scale);
+            dmm = _mm256_set1_epi16(blend->delta);
+            amm = _mm256_set1_epi16(16);
+        }
+    }
+
+    // 加权预测, 输入输出均为 int16
+    __m256i weight(__m256i ym) const
+    {
+        ym = _mm256_mullo_epi16(ym, smm);
+        ym = _mm256_adds_epi16(ym, amm);
+        ym = _mm256_srai_epi16(ym, 5);
+        return _mm256_adds_epi16(ym, dmm);
+    }
+
+    // 存储一行 16 个像素, xm 为 uint8
+    void pel_16x1(uint8_t* dst, __m128i xm) const
+    {
+        if (MODE & MC_BLEND_WEIGHT)
+        {
+            __m256i ym = weight(_mm256_cvtepu8_epi16(xm));
+            xm = _mm_packus_epi16(_mm256_castsi256_si128(ym), _mm256_extracti128_si256(ym, 1));
+        }
+        if (MODE & MC_BLEND_AVG)
+            xm = _mm_avg_epu8(xm, _mm_loadu_si128((__m128i*)dst));
+        _mm_storeu_si128((__m128i*)dst, xm);
+    }
+
+    // 存储一行 16 个像素, ym 为 int16, 先饱和转换为 uint8
+    void row_16x1(uint8_t* dst, __m256i ym) const
+    {
+        pel_16x1(dst, _mm_packus_epi16(_mm256_castsi256_si128(ym), _mm256_extracti128_si256(ym, 1)));
+    }
+
+    // 存储 Cb/Cr 两行各 8 个像素, ym 为 uint8, 低 128 位为 Cb, 高 128 位为 Cr
+    void cbcr_8x2(uint8_t* dstCb, uint8_t* dstCr, int dstPitch, __m256i ym) const
+    {
+        if (MODE & MC_BLEND_WEIGHT)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i ym0 = weight(_mm256_unpacklo_epi8(ym, zero));
+            __m256i ym1 = weight(_mm256_unpackhi_epi8(ym, zero));
+            ym = _mm256_packus_epi16(ym0, ym1);
+        }
+        if (MODE & MC_BLEND_AVG)
+        {
+            __m128i xm0 = _mm_loadl_epi64((__m128i*)dstCb);
+            __m128i xm1 = _mm_loadl_epi64((__m128i*)dstCr);
+            xm0 = _mm_castps_si128(_mm_loadh_pi(_mm_castsi128_ps(xm0), (__m64*)(dstCb + dstPitch)));
+            xm1 = _mm_castps_si128(_mm_loadh_pi(_mm_castsi128_ps(xm1), (__m64*)(dstCr + dstPitch)));
+            ym = _mm256_avg_epu8(ym, _mm256_inserti128_si256(_mm256_castsi128_si256(xm0), xm1, 1));
+        }
+        __m128i xm0 = _mm256_castsi256_si128(ym);
+        __m128i xm1 = _mm256_extracti128_si256(ym, 1);
+        _mm_storel_epi64((__m128i*)dstCb, xm0);
+        _mm_storel_epi64((__m128i*)dstCr, xm1);
+        _mm_storeh_pi((__m64*)(dstCb + dstPitch), _mm_castsi128_ps(xm0));
+        _mm_storeh_pi((__m64*)(dstCr + dstPitch), _mm_castsi128_ps(xm1));
+    }
+
+    // 存储 Cb/Cr 两行各 4 个像素, ym 为 uint8, 低 128 位为第一行 Cb/Cr, 高 128 位为第二行 Cb/Cr
+    void cbcr_4x2(uint8_t* dstCb, uint8_t* dstCr, int dstPitch, __m256i ym) const
+    {
+        if (MODE & MC_BLEND_WEIGHT)
+        {
+            ym = weight(_mm256_unpacklo_epi8(ym, _mm256_setzero_si256()));
+            ym = _mm256_packus_epi16(ym, ym);
+        }
+        if (MODE & MC_BLEND_AVG)
+        {
+            ym = _mm256_avg_epu8(ym, _mm256_setr_epi32(*(int32_as*)dstCb, *(int32_as*)dstCr, 0, 0,
+                *(int32_as*)(dstCb + dstPitch), *(int32_as*)(dstCr + dstPitch), 0, 0));
+        }
+        __m128i xm0 = _mm256_castsi256_si128(ym);
+        __m128i xm1 = _mm256_extracti128_si256(ym, 1);
+        *(int32_as*)dstCb = _mm_cvtsi128_si32(xm0);
+        *(int32_as*)dstCr = _mm_extract_epi32(xm0, 1);
+        *(int32_as*)(dstCb + dstPitch) = _mm_cvtsi128_si32(xm1);
+        *(int32_as*)(dstCr + dstPitch) = _mm_extract_epi32(xm1, 1);
+    }
+};
+
+//======================================================================================================================
+// 亮度分量帧间预测, 每个 ymm 寄存器处理一行 16 个像素
+
+// 读取 16 个像素并转换为 int16
+#define loadzx_16x1( addr ) _mm256_cvtepu8_epi16( _mm_loadu_si128( (__m128i*)(addr) ) )
+
+// 读取一行 16+8 个像素, x0 为第 0~15 个像素, x8 为第 8~23 个像素
+// 之后用 _mm256_alignr_epi8( x8, x0, 2*k ) 得到第 k~k+15 个像素
+#define LOAD_ROW_16P8( src, x0, x8 ) \
+    x0 = loadzx_16x1( src );        \
+    x8 = loadzx_16x1( (src) + 8 );
+
+// 半像素点滤波 [-1, 5, 5 -1]
+// x0~x3 为输入, y0 为输出, t0, t1 为临时寄存器
+#define HP_FILTER_Y( x0, x1, x2, x3, t0, t1, y0 ) \
+    t0 = _mm256_adds_epi16( x0, x3 );       \
+    t1 = _mm256_adds_epi16( x1, x2 );       \
+    y0 = _mm256_subs_epi16( t1, t0 );       \
+    t1 = _mm256_slli_epi16( t1, 2 );        \
+    y0 = _mm256_adds_epi16( y0, t1 );
+
+// 1/4 像素滤波, [-1,-2,96,42,-7], 运算顺序与 SSE 版本相同, 保证结果一致
+// x0 ~ x4 输入, y0 输出, t0, t1 为临时寄存器
+#define QP_FILTER_Y( x0, x1, x2, x3, x4, t0, t1, y0 ) \
+    y0 = _mm256_slli_epi16( x2, 6 );  /* x2*64 */  \
+    t0 = _mm256_slli_epi16( x2, 5 );  /* x2*32 */  \
+    t1 = _mm256_adds_epi16( x1, x1 );              \
+    y0 = _mm256_adds_epi16( y0, t0 ); /* x2*96 */  \
+    t1 = _mm256_add_epi16( t1, x0 );  /* x1*2+x0*/ \
+    t0 = _mm256_slli_epi16( x4, 3 );  /* x4*8 */   \
+    y0 = _mm256_subs_epi16( y0, t1 );              \
+    t1 = _mm256_adds_epi16( x3, x3 ); /* x3*2 */   \
+    y0 = _mm256_subs_epi16( y0, t0 );              \
+    t0 = _mm256_slli_epi16( t1, 2 );  /* x3*8 */   \
+    y0 = _mm256_adds_epi16( y0, x4 );              \
+    t1 = _mm256_adds_epi16( t1, t0 ); /* x3*10 */  \
+    t0 = _mm256_slli_epi16( t0, 2 );  /* x3*32 */  \
+    y0 = _mm256_adds_epi16( y0, t1 );              \
+    y0 = _mm256_adds_epi16( y0, t0 );
+
+// 一行 16 个像素的半像素点水平滤波, 输入地址为 src - 1, 输出 y0
+#define HP_HOR_ROW16( src, y0 ) \
+    LOAD_ROW_16P8( src, xm0, xm4 );             \
+    xm1 = _mm256_alignr_epi8( xm4, xm0, 2 );    \
+    xm2 = _mm256_alignr_epi8( xm4, xm0, 4 );    \
+    xm3 = _mm256_alignr_epi8( xm4, xm0, 6 );    \
+    HP_FILTER_Y( xm0, xm1, xm2, xm3, tm0, tm1, y0 );
+
+// 整数点简单复制
+template<int MODE>
+static void MC_copy_16xN_avx2(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    if (MODE != 0)
+    {
+        const McStore<MODE> store(blend);
+        for (int i = 0; i < N; i++)
+        {
+            store.pel_16x1(dst, _mm_loadu_si128((__m128i*)src));
+            src += srcPitch;
+            dst += dstPitch;
+        }
+        return;
+    }
+
+    for (int i = 0; i < N; i += 2)
+    {
+        __m128i xm0 = _mm_loadu_si128((__m128i*)src);
+        __m128i xm1 = _mm_loadu_si128((__m128i*)(src + srcPitch));
+        _mm_storeu_si128((__m128i*)dst, xm0);
+        _mm_storeu_si128((__m128i*)(dst + dstPitch), xm1);
+        src += srcPitch * 2;
+        dst += dstPitch * 2;
+    }
+}
+
+// (0.5, 0)
+template<int MODE>
+static void MC_luma_16xN_x2y0(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(4);
+    const McStore<MODE> store(blend);
+
+    src -= 1;
+    for (int i = 0; i < N; i++)
+    {
+        HP_HOR_ROW16(src, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 3);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+    }
+}
+
+// (0, 0.5)
+template<int MODE>
+static void MC_luma_16xN_x0y2(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(4);
+    const McStore<MODE> store(blend);
+
+    xm0 = loadzx_16x1(src - srcPitch);
+    xm1 = loadzx_16x1(src);
+    xm2 = loadzx_16x1(src + srcPitch);
+    src += srcPitch * 2;
+
+    for (int i = 0; i < N; i++)
+    {
+        xm3 = loadzx_16x1(src);
+        HP_FILTER_Y(xm0, xm1, xm2, xm3, tm0, tm1, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 3);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+        xm0 = xm1;
+        xm1 = xm2;
+        xm2 = xm3;
+    }
+}
+
+// (0.5, 0.5)
+template<int MODE>
+static void MC_luma_16xN_x2y2(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1;
+    __m256i ym0, ym1, ym2, ym3, zm0;
+    __m256i rnd = _mm256_set1_epi16(32);
+    const McStore<MODE> store(blend);
+
+    src -= 1;
+    HP_HOR_ROW16(src - srcPitch, ym0);
+    HP_HOR_ROW16(src, ym1);
+    HP_HOR_ROW16(src + srcPitch, ym2);
+    src += srcPitch * 2;
+
+    for (int i = 0; i < N; i++)
+    {
+        HP_HOR_ROW16(src, ym3);                             // 水平滤波
+        HP_FILTER_Y(ym0, ym1, ym2, ym3, tm0, tm1, zm0);     // 垂直滤波
+        zm0 = _mm256_adds_epi16(zm0, rnd);
+        zm0 = _mm256_srai_epi16(zm0, 6);
+        store.row_16x1(dst, zm0);
+        src += srcPitch;
+        dst += dstPitch;
+        ym0 = ym1;
+        ym1 = ym2;
+        ym2 = ym3;
+    }
+}
+
+// (0.25, 0.25), (0.25, 0.75), (0.75, 0.25), (0.75, 0.75)
+// src2: 对应边角整数样本点
+template<int MODE>
+static void MC_luma_16xN_x1y1(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const uint8_t* src2,
+    const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1;
+    __m256i ym0, ym1, ym2, ym3, zm0;
+    __m256i rnd = _mm256_set1_epi16(64);
+    const McStore<MODE> store(blend);
+
+    src -= 1;
+    HP_HOR_ROW16(src - srcPitch, ym0);
+    HP_HOR_ROW16(src, ym1);
+    HP_HOR_ROW16(src + srcPitch, ym2);
+    src += srcPitch * 2;
+
+    for (int i = 0; i < N; i++)
+    {
+        HP_HOR_ROW16(src, ym3);                             // 水平滤波
+        HP_FILTER_Y(ym0, ym1, ym2, ym3, tm0, tm1, zm0);     // 垂直滤波
+        xm0 = loadzx_16x1(src2);
+        zm0 = _mm256_adds_epi16(zm0, rnd);
+        xm0 = _mm256_slli_epi16(xm0, 6);
+        zm0 = _mm256_adds_epi16(zm0, xm0);
+        zm0 = _mm256_srai_epi16(zm0, 7);
+        store.row_16x1(dst, zm0);
+        src += srcPitch;
+        dst += dstPitch;
+        src2 += srcPitch;
+        ym0 = ym1;
+        ym1 = ym2;
+        ym2 = ym3;
+    }
+}
+
+// (0.25, 0)
+template<int MODE>
+static void MC_luma_16xN_x1y0(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(64);
+    const McStore<MODE> store(blend);
+
+    src -= 2;
+    for (int i = 0; i < N; i++)
+    {
+        LOAD_ROW_16P8(src, xm0, xm4);
+        xm1 = _mm256_alignr_epi8(xm4, xm0, 2);
+        xm2 = _mm256_alignr_epi8(xm4, xm0, 4);
+        xm3 = _mm256_alignr_epi8(xm4, xm0, 6);
+        xm4 = _mm256_alignr_epi8(xm4, xm0, 8);
+        QP_FILTER_Y(xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 7);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+    }
+}
+
+// (0.75, 0)
+template<int MODE>
+static void MC_luma_16xN_x3y0(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(64);
+    const McStore<MODE> store(blend);
+
+    src -= 1;
+    for (int i = 0; i < N; i++)
+    {
+        LOAD_ROW_16P8(src, xm0, xm4);
+        xm1 = _mm256_alignr_epi8(xm4, xm0, 2);
+        xm2 = _mm256_alignr_epi8(xm4, xm0, 4);
+        xm3 = _mm256_alignr_epi8(xm4, xm0, 6);
+        xm4 = _mm256_alignr_epi8(xm4, xm0, 8);
+        QP_FILTER_Y(xm4, xm3, xm2, xm1, xm0, tm0, tm1, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 7);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+    }
+}
+
+// (0, 0.25)
+template<int MODE>
+static void MC_luma_16xN_x0y1(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(64);
+    const McStore<MODE> store(blend);
+
+    xm0 = loadzx_16x1(src - srcPitch * 2);
+    xm1 = loadzx_16x1(src - srcPitch);
+    xm2 = loadzx_16x1(src);
+    xm3 = loadzx_16x1(src + srcPitch);
+    src += srcPitch * 2;
+
+    for (int i = 0; i < N; i++)
+    {
+        xm4 = loadzx_16x1(src);
+        QP_FILTER_Y(xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 7);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+        xm0 = xm1;
+        xm1 = xm2;
+        xm2 = xm3;
+        xm3 = xm4;
+    }
+}
+
+// (0, 0.75)
+template<int MODE>
+static void MC_luma_16xN_x0y3(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+    __m256i rnd = _mm256_set1_epi16(64);
+    const McStore<MODE> store(blend);
+
+    xm0 = loadzx_16x1(src - srcPitch);
+    xm1 = loadzx_16x1(src);
+    xm2 = loadzx_16x1(src + srcPitch);
+    xm3 = loadzx_16x1(src + srcPitch * 2);
+    src += srcPitch * 3;
+
+    for (int i = 0; i < N; i++)
+    {
+        xm4 = loadzx_16x1(src);
+        QP_FILTER_Y(xm4, xm3, xm2, xm1, xm0, tm0, tm1, ym0);
+        ym0 = _mm256_adds_epi16(ym0, rnd);
+        ym0 = _mm256_srai_epi16(ym0, 7);
+        store.row_16x1(dst, ym0);
+        src += srcPitch;
+        dst += dstPitch;
+        xm0 = xm1;
+        xm1 = xm2;
+        xm2 = xm3;
+        xm3 = xm4;
+    }
+}
+
+// 半像素点水平滤波, 存储中间值, 目标行宽为 16 个像素
+static void MC_luma_16xN_hor_temp_avx2(const uint8_t* src, int srcPitch, int16_t* dst, int N)
+{
+    assert(((uintptr_t)dst & 31) == 0);
+    __m256i xm0, xm1, xm2, xm3, xm4, tm0, tm1, ym0;
+
+    src -= 1;
+    for (int i = 0; i < N; i++)
+    {
+        HP_HOR_ROW16(src, ym0);
+        _mm256_store_si256((__m256i*)dst, ym0);
+        src += srcPitch;
+        dst += 16;
+    }
+}
+
+// 半像素点垂直滤波, 存储中间值, 目标行宽为 24 个像素
+static void MC_luma_24xN_ver_temp_avx2(const uint8_t* src, int srcPitch, int16_t* dst, int N)
+{
+    __m256i xm0, xm1, xm2, xm3, tm0, tm1, sm0;
+    __m128i ym0, ym1, ym2, ym3, em0, em1, sm1;
+
+    xm0 = loadzx_16x1(src - srcPitch);
+    xm1 = loadzx_16x1(src);
+    xm2 = loadzx_16x1(src + srcPitch);
+    ym0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*)(src - srcPitch + 16)));
+    ym1 = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*)(src + 16)));
+    ym2 = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*)(src + srcPitch + 16)));
+    src += srcPitch * 2;
+
+    for (int i = 0; i < N; i++)
+    {
+        xm3 = loadzx_16x1(src);
+        ym3 = _mm_cvtepu8_epi16(_mm_loadl_epi64((__m128i*)(src + 16)));
+        HP_FILTER_Y(xm0, xm1, xm2, xm3, tm0, tm1, sm0);
+        em0 = _mm_adds_epi16(ym0, ym3);
+        em1 = _mm_adds_epi16(ym1, ym2);
+        sm1 = _mm_subs_epi16(em1, em0);
+        em1 = _mm_slli_epi16(em1, 2);
+        sm1 = _mm_adds_epi16(sm1, em1);
+        _mm256_storeu_si256((__m256i*)dst, sm0);
+        _mm_storeu_si128((__m128i*)(dst + 16), sm1);
+        src += srcPitch;
+        dst += 24;
+        xm0 = xm1;
+        xm1 = xm2;
+        xm2 = xm3;
+        ym0 = ym1;
+        ym1 = ym2;
+        ym2 = ym3;
+    }
+}
+
+// 由于输入数据最大可能为 255*8, 后续运算可能溢出, 分为高低两部分分别处理
+#define SPLIT_TEMP( xm, tm )            \
+    tm = _mm256_and_si256( xm, msk );   \
+    xm = _mm256_srai_epi16( xm, 4 );
+
+// 合并高低两部分滤波结果
+#define MERGE_TEMP( ym0, ym1 )              \
+    ym1 = _mm256_srai_epi16( ym1, 4 );      \
+    ym0 = _mm256_adds_epi16( ym0, ym1 );    \
+    ym0 = _mm256_adds_epi16( ym0, rnd );    \
+    ym0 = _mm256_srai_epi16( ym0, 6 );
+
+// (0.25, 0.5), (0.75, 0.5), 输入数据行宽为 24 像素
+template<int MODE, bool kRight>
+static void MC_luma_16xN_xqy2(const int16_t* src, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    __m256i xm0, xm1, xm2, xm3, xm4, ym0;
+    __m256i tm0, tm1, tm2, tm3, tm4, ym1;
+    __m256i em0, em1;
+    __m256i rnd = _mm256_set1_epi16(32);
+    __m256i msk = _mm256_set1_epi16(15);
+    const McStore<MODE> store(blend);
+
+    for (int i = 0; i < N; i++)
+    {
+        xm0 = _mm256_loadu_si256((__m256i*)src);
+        xm4 = _mm256_loadu_si256((__m256i*)(src + 8));
+        xm1 = _mm256_alignr_epi8(xm4, xm0, 2);
+        xm2 = _mm256_alignr_epi8(xm4, xm0, 4);
+        xm3 = _mm256_alignr_epi8(xm4, xm0, 6);
+        xm4 = _mm256_alignr_epi8(xm4, xm0, 8);
+
+        SPLIT_TEMP(xm0, tm0);
+        SPLIT_TEMP(xm1, tm1);
+        SPLIT_TEMP(xm2, tm2);
+        SPLIT_TEMP(xm3, tm3);
+        SPLIT_TEMP(xm4, tm4);
+        if (kRight)
+        {
+            QP_FILTER_Y(tm4, tm3, tm2, tm1, tm0, em0, em1, ym1);
+            QP_FILTER_Y(xm4, xm3, xm2, xm1, xm0, em0, em1, ym0);
+        }
+        else
+        {
+            QP_FILTER_Y(tm0, tm1, tm2, tm3, tm4, em0, em1, ym1);
+            QP_FILTER_Y(xm0, xm1, xm2, xm3, xm4, em0, em1, ym0);
+        }
+        MERGE_TEMP(ym0, ym1);
+        store.row_16x1(dst, ym0);
+
+        src += 24;
+        dst += dstPitch;
+    }
+}
+
+// (0.5, 0.25), (0.5, 0.75), 输入数据行宽为 16 像素
+template<int MODE, bool kBottom>
+static void MC_luma_16xN_x2yq(const int16_t* src, uint8_t* dst, int dstPitch, int N, const McBlend* blend)
+{
+    assert(((uintptr_t)src & 31) == 0);
+    __m256i xm0, xm1, xm2, xm3, xm4, ym0;
+    __m256i tm0, tm1, tm2, tm3, tm4, ym1;
+    __m256i em0, em1;
+    __m256i rnd = _mm256_set1_epi16(32);
+    __m256i msk = _mm256_set1_epi16(15);
+    const McStore<MODE> store(blend);
+
+    xm0 = _mm256_load_si256((__m256i*)src);
+    xm1 = _mm256_load_si256((__m256i*)(src + 16));
+    xm2 = _mm256_load_si256((__m256i*)(src + 32));
+    xm3 = _mm256_load_si256((__m256i*)(src + 48));
+    src += 64;
+    SPLIT_TEMP(xm0, tm0);
+    SPLIT_TEMP(xm1, tm1);
+    SPLIT_TEMP(xm2, tm2);
+    SPLIT_TEMP(xm3, tm3);
+
+    for (int i = 0; i < N; i++)
+    {
+        xm4 = _mm256_load_si256((__m256i*)src);
+        SPLIT_TEMP(xm4, tm4);
+        if (kBottom)
+        {
+            QP_FILTER_Y(tm4, tm3, tm2, tm1, tm0, em0, em1, ym1);
+            QP_FILTER_Y(xm4, xm3, xm2, xm1, xm0, em0, em1, ym0);
+        }
+        else
+        {
+            QP_FILTER_Y(tm0, tm1, tm2, tm3, tm4, em0, em1, ym1);
+            QP_FILTER_Y(xm0, xm1, xm2, xm3, xm4, em0, em1, ym0);
+        }
+        MERGE_TEMP(ym0, ym1);
+        store.row_16x1(dst, ym0);
+
+        src += 16;
+        dst += dstPitch;
+        tm0 = tm1;
+        tm1 = tm2;
+        tm2 = tm3;
+        tm3 = tm4;
+        xm0 = xm1;
+        xm1 = xm2;
+        xm2 = xm3;
+        xm3 = xm4;
+    }
+}
+
+#undef SPLIT_TEMP
+#undef MERGE_TEMP
+
+// 16xN 亮度分量帧间预测
+template<int MODE>
+static void luma_inter_pred_16xN_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dst, int dstPitch, int x, int y, int N, const McBlend* blend)
+{
+    const int xInt = x >> 2;
+    const int yInt = y >> 2;
+    const int xy = ((y & 3) << 2) | (x & 3);
+    int srcPitch = ctx->picPitch[0];
+    const uint8_t* src = nullptr;
+
+    // 检查参考帧数据是否已解码, 未可用则等待
+    check_ref_data(ctx, refpic->pframe, yInt + N + 3);
+
+    Rect rc1 = {xInt - 2, yInt - 2, xInt + 19, yInt + N + 3};
+    if (in_rect_of(&rc1, &ctx->refRcLuma))
+    {
+        // 在参考帧实际图像范围内
+        src = refpic->plane[0] + yInt * srcPitch + xInt;
+    }
+    else
+    {
+        // 对参考帧边界进行扩展, 得到参考数据
+        McExtRect refRect;
+        refRect.x = xInt - 2;
+        refRect.y = yInt - 2;
+        refRect.height = N + 5;
+        refRect.picWidth = ctx->picWidth;
+        refRect.picHeight = ctx->picHeight;
+        refRect.buf = ctx->tempBuf;
+        get_ref_data_32xN(refpic->plane[0], srcPitch, refRect);
+        srcPitch = 32;
+        src = refRect.buf + 32 * 2 + 2;
+    }
+
+    int16_t* tmpBuf = (int16_t*)(ctx->tempBuf + 768);
+    switch (xy)
+    {
+    case 0:             // 0, 0
+        MC_copy_16xN_avx2<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 1:             // 0.25, 0
+        MC_luma_16xN_x1y0<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 2:             // 0.5, 0
+        MC_luma_16xN_x2y0<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 3:             // 0.75, 0
+        MC_luma_16xN_x3y0<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 4:             // 0, 0.25
+        MC_luma_16xN_x0y1<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 5:             // 0.25, 0.25
+        MC_luma_16xN_x1y1<MODE>(src, srcPitch, dst, dstPitch, N, src, blend);
+        break;
+    case 6:             // 0.5, 0.25
+        MC_luma_16xN_hor_temp_avx2(src - srcPitch * 2, srcPitch, tmpBuf, N + 4);
+        MC_luma_16xN_x2yq<MODE, false>(tmpBuf, dst, dstPitch, N, blend);
+        break;
+    case 7:             // 0.75, 0.25
+        MC_luma_16xN_x1y1<MODE>(src, srcPitch, dst, dstPitch, N, src + 1, blend);
+        break;
+    case 8:             // 0, 0.5
+        MC_luma_16xN_x0y2<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 9:             // 0.25, 0.5
+        MC_luma_24xN_ver_temp_avx2(src - 2, srcPitch, tmpBuf, N);
+        MC_luma_16xN_xqy2<MODE, false>(tmpBuf, dst, dstPitch, N, blend);
+        break;
+    case 10:            // 0.5, 0.5
+        MC_luma_16xN_x2y2<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 11:            // 0.75, 0.5
+        MC_luma_24xN_ver_temp_avx2(src - 1, srcPitch, tmpBuf, N);
+        MC_luma_16xN_xqy2<MODE, true>(tmpBuf, dst, dstPitch, N, blend);
+        break;
+    case 12:            // 0, 0.75
+        MC_luma_16xN_x0y3<MODE>(src, srcPitch, dst, dstPitch, N, blend);
+        break;
+    case 13:            // 0.25, 0.75
+        MC_luma_16xN_x1y1<MODE>(src, srcPitch, dst, dstPitch, N, src + srcPitch, blend);
+        break;
+    case 14:            // 0.5, 0.75
+        MC_luma_16xN_hor_temp_avx2(src - srcPitch, srcPitch, tmpBuf, N + 4);
+        MC_luma_16xN_x2yq<MODE, true>(tmpBuf, dst, dstPitch, N, blend);
+        break;
+    case 15:            // 0.75, 0.75
+        MC_luma_16xN_x1y1<MODE>(src, srcPitch, dst, dstPitch, N, src + srcPitch + 1, blend);
+        break;
+    default:
+        assert(0);
+        break;
+    }
+}
+
+// 16x16 亮度分量帧间预测
+void luma_inter_pred_16x16_avx2(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch, int x, int y)
+{
+    luma_inter_pred_16xN_avx2<0>(ctx, refpic, dst, dstPitch, x, y, 16, nullptr);
+}
+
+// 16x8 亮度分量帧间预测
+void luma_inter_pred_16x8_avx2(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch, int x, int y)
+{
+    luma_inter_pred_16xN_avx2<0>(ctx, refpic, dst, dstPitch, x, y, 8, nullptr);
+}
+
+// 16xN 亮度分量帧间预测, 同时加权及取平均
+static void luma_inter_pred_blend_16xN_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dst, int dstPitch, int x, int y, int N, const McBlend* blend)
+{
+    switch (blend->mode)
+    {
+    case MC_BLEND_WEIGHT:
+        luma_inter_pred_16xN_avx2<MC_BLEND_WEIGHT>(ctx, refpic, dst, dstPitch, x, y, N, blend);
+        break;
+    case MC_BLEND_AVG:
+        luma_inter_pred_16xN_avx2<MC_BLEND_AVG>(ctx, refpic, dst, dstPitch, x, y, N, blend);
+        break;
+    case MC_BLEND_WEIGHT | MC_BLEND_AVG:
+        luma_inter_pred_16xN_avx2<MC_BLEND_WEIGHT | MC_BLEND_AVG>(ctx, refpic, dst, dstPitch, x, y, N, blend);
+        break;
+    default:
+        luma_inter_pred_16xN_avx2<0>(ctx, refpic, dst, dstPitch, x, y, N, blend);
+        break;
+    }
+}
+
+// 16x16 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x16_avx2(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend_16xN_avx2(ctx, refpic, dst, dstPitch, x, y, 16, blend);
+}
+
+// 16x8 亮度分量帧间预测, 同时加权及取平均
+void luma_inter_pred_blend_16x8_avx2(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    luma_inter_pred_blend_16xN_avx2(ctx, refpic, dst, dstPitch, x, y, 8, blend);
+}
+
+#undef HP_HOR_ROW16
+#undef QP_FILTER_Y
+#undef HP_FILTER_Y
+#undef LOAD_ROW_16P8
+
+//======================================================================================================================
+// 色差分量帧间预测, Cb/Cr 放在同一个 ymm 寄存器中同时处理
+
+// 读取 Cb/Cr 各 8 个像素, 低 128 位为 Cb, 高 128 位为 Cr
+#define LOAD_CBCR_8x1( cb, cr ) \
+    _mm256_cvtepu8_epi16( _mm_unpacklo_epi64( _mm_loadl_epi64( (__m128i*)(cb) ), _mm_loadl_epi64( (__m128i*)(cr) ) ) )
+
+// 读取 Cb/Cr 两行各 4 个像素, 低 128 位为第一行 Cb/Cr, 高 128 位为第二行 Cb/Cr
+#define LOAD_CBCR_4x2( cb, cr, pitch ) \
+    _mm256_cvtepu8_epi16( _mm_setr_epi32( *(int32_as*)(cb), *(int32_as*)(cr), \
+                                          *(int32_as*)((cb) + (pitch)), *(int32_as*)((cr) + (pitch)) ) )
+
+// 横向滤波, 输出为 vm0, tm1 为临时变量, dmx 为滤波系数
+#define CHROMA_HOR_8x1( cb, cr, vm0 ) \
+    vm0 = LOAD_CBCR_8x1( cb, cr );              \
+    tm1 = LOAD_CBCR_8x1( (cb) + 1, (cr) + 1 );  \
+    tm1 = _mm256_sub_epi16( tm1, vm0 );         \
+    vm0 = _mm256_slli_epi16( vm0, 3 );          \
+    tm1 = _mm256_mullo_epi16( tm1, dmx );       \
+    vm0 = _mm256_add_epi16( vm0, tm1 );
+
+// 同上, 处理两行 4 个像素
+#define CHROMA_HOR_4x2( cb, cr, pitch, vm0 ) \
+    vm0 = LOAD_CBCR_4x2( cb, cr, pitch );               \
+    tm1 = LOAD_CBCR_4x2( (cb) + 1, (cr) + 1, pitch );   \
+    tm1 = _mm256_sub_epi16( tm1, vm0 );                 \
+    vm0 = _mm256_slli_epi16( vm0, 3 );                  \
+    tm1 = _mm256_mullo_epi16( tm1, dmx );               \
+    vm0 = _mm256_add_epi16( vm0, tm1 );
+
+// 纵向滤波, 输入 vm0, vm1, 输出 vm0, tm1 为临时变量, dmy 为滤波系数
+#define CHROMA_VER_Y( vm0, vm1, add, shift ) \
+    tm1 = _mm256_sub_epi16( vm1, vm0 );         \
+    vm0 = _mm256_slli_epi16( vm0, 3 );          \
+    tm1 = _mm256_mullo_epi16( tm1, dmy );       \
+    vm0 = _mm256_add_epi16( vm0, tm1 );         \
+    vm0 = _mm256_add_epi16( vm0, add );         \
+    vm0 = _mm256_srai_epi16( vm0, shift );
+
+// 存储两行 8 个像素, vm0 为第一行, vm1 为第二行
+#define STORE_CBCR_8x2( vm0, vm1 ) \
+    vm0 = _mm256_packus_epi16( vm0, vm1 );          \
+    store.cbcr_8x2( dstCb, dstCr, dstPitch, vm0 );
+
+// 存储两行 4 个像素
+#define STORE_CBCR_4x2( vm0 ) \
+    vm0 = _mm256_packus_epi16( vm0, vm0 );          \
+    store.cbcr_4x2( dstCb, dstCr, dstPitch, vm0 );
+
+// 8x8, 8x4, 双线性插值, dx 或 dy 可以为 0
+template<int MODE>
+static void MC_chroma_8xN_avx2(const uint8_t* srcCb, const uint8_t* srcCr, int srcPitch,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int dx, int dy, int N, const McBlend* blend)
+{
+    assert((N & 1) == 0);
+    const McStore<MODE> store(blend);
+    __m256i dmx = _mm256_set1_epi16(dx);
+    __m256i dmy = _mm256_set1_epi16(dy);
+    __m256i ym0, ym1, ym2, tm1;
+
+    if (dx == 0)            // 只需要垂直滤波
+    {
+        __m256i c4 = _mm256_set1_epi16(4);
+        ym0 = LOAD_CBCR_8x1(srcCb, srcCr);
+        for (int i = 0; i < N; i += 2)
+        {
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            ym1 = LOAD_CBCR_8x1(srcCb, srcCr);
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            ym2 = LOAD_CBCR_8x1(srcCb, srcCr);
+            CHROMA_VER_Y(ym0, ym1, c4, 3);
+            CHROMA_VER_Y(ym1, ym2, c4, 3);
+            STORE_CBCR_8x2(ym0, ym1);
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+            ym0 = ym2;
+        }
+    }
+    else if (dy == 0)       // 只需要水平滤波
+    {
+        __m256i c4 = _mm256_set1_epi16(4);
+        for (int i = 0; i < N; i += 2)
+        {
+            CHROMA_HOR_8x1(srcCb, srcCr, ym0);
+            CHROMA_HOR_8x1(srcCb + srcPitch, srcCr + srcPitch, ym1);
+            ym0 = _mm256_add_epi16(ym0, c4);
+            ym1 = _mm256_add_epi16(ym1, c4);
+            ym0 = _mm256_srai_epi16(ym0, 3);
+            ym1 = _mm256_srai_epi16(ym1, 3);
+            STORE_CBCR_8x2(ym0, ym1);
+            srcCb += srcPitch * 2;
+            srcCr += srcPitch * 2;
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+        }
+    }
+    else
+    {
+        __m256i c32 = _mm256_set1_epi16(32);
+        CHROMA_HOR_8x1(srcCb, srcCr, ym0);
+        for (int i = 0; i < N; i += 2)
+        {
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            CHROMA_HOR_8x1(srcCb, srcCr, ym1);
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            CHROMA_HOR_8x1(srcCb, srcCr, ym2);
+            CHROMA_VER_Y(ym0, ym1, c32, 6);
+            CHROMA_VER_Y(ym1, ym2, c32, 6);
+            STORE_CBCR_8x2(ym0, ym1);
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+            ym0 = ym2;
+        }
+    }
+}
+
+// 4x8, 4x4, 双线性插值, dx 或 dy 可以为 0
+template<int MODE>
+static void MC_chroma_4xN_avx2(const uint8_t* srcCb, const uint8_t* srcCr, int srcPitch,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int dx, int dy, int N, const McBlend* blend)
+{
+    assert((N & 1) == 0);
+    const McStore<MODE> store(blend);
+    __m256i dmx = _mm256_set1_epi16(dx);
+    __m256i dmy = _mm256_set1_epi16(dy);
+    __m256i ym0, ym1, ym2, tm1;
+
+    if (dx == 0)            // 只需要垂直滤波
+    {
+        __m256i c4 = _mm256_set1_epi16(4);
+        ym0 = LOAD_CBCR_4x2(srcCb, srcCr, srcPitch);
+        for (int i = 0; i < N; i += 2)
+        {
+            srcCb += srcPitch * 2;
+            srcCr += srcPitch * 2;
+            // 最后一次只需读取一行
+            ym1 = LOAD_CBCR_4x2(srcCb, srcCr, (i + 2 < N) ? srcPitch : 0);
+            ym2 = _mm256_permute2x128_si256(ym0, ym1, 0x21);
+            CHROMA_VER_Y(ym0, ym2, c4, 3);
+            STORE_CBCR_4x2(ym0);
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+            ym0 = ym1;
+        }
+    }
+    else if (dy == 0)       // 只需要水平滤波
+    {
+        __m256i c4 = _mm256_set1_epi16(4);
+        for (int i = 0; i < N; i += 2)
+        {
+            CHROMA_HOR_4x2(srcCb, srcCr, srcPitch, ym0);
+            ym0 = _mm256_add_epi16(ym0, c4);
+            ym0 = _mm256_srai_epi16(ym0, 3);
+            STORE_CBCR_4x2(ym0);
+            srcCb += srcPitch * 2;
+            srcCr += srcPitch * 2;
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+        }
+    }
+    else
+    {
+        __m256i c32 = _mm256_set1_epi16(32);
+        CHROMA_HOR_4x2(srcCb, srcCr, srcPitch, ym0);
+        for (int i = 0; i < N; i += 2)
+        {
+            srcCb += srcPitch * 2;
+            srcCr += srcPitch * 2;
+            // 最后一次只需读取一行
+            CHROMA_HOR_4x2(srcCb, srcCr, (i + 2 < N) ? srcPitch : 0, ym1);
+            ym2 = _mm256_permute2x128_si256(ym0, ym1, 0x21);
+            CHROMA_VER_Y(ym0, ym2, c32, 6);
+            STORE_CBCR_4x2(ym0);
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+            ym0 = ym1;
+        }
+    }
+}
+
+#undef LOAD_CBCR_8x1
+#undef LOAD_CBCR_4x2
+#undef CHROMA_HOR_8x1
+#undef CHROMA_HOR_4x2
+#undef CHROMA_VER_Y
+#undef STORE_CBCR_8x2
+#undef STORE_CBCR_4x2
+
+// 整数点简单复制, Cb/Cr 同时处理
+template<int MODE>
+static void MC_copy_cbcr_avx2(const uint8_t* srcCb, const uint8_t* srcCr, int srcPitch,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int W, int N, const McBlend* blend)
+{
+    if (MODE != 0)
+    {
+        const McStore<MODE> store(blend);
+        __m128i xm0, xm1;
+        for (int i = 0; i < N; i += 2)
+        {
+            if (W == 8)
+            {
+                xm0 = _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i*)srcCb), _mm_loadl_epi64((__m128i*)(srcCb + srcPitch)));
+                xm1 = _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i*)srcCr), _mm_loadl_epi64((__m128i*)(srcCr + srcPitch)));
+                store.cbcr_8x2(dstCb, dstCr, dstPitch, _mm256_inserti128_si256(_mm256_castsi128_si256(xm0), xm1, 1));
+            }
+            else
+            {
+                store.cbcr_4x2(dstCb, dstCr, dstPitch, _mm256_setr_epi32(*(int32_as*)srcCb, *(int32_as*)srcCr, 0, 0,
+                    *(int32_as*)(srcCb + srcPitch), *(int32_as*)(srcCr + srcPitch), 0, 0));
+            }
+            srcCb += srcPitch * 2;
+            srcCr += srcPitch * 2;
+            dstCb += dstPitch * 2;
+            dstCr += dstPitch * 2;
+        }
+        return;
+    }
+
+    if (W == 8)
+    {
+        for (int i = 0; i < N; i++)
+        {
+            *(uint64_as*)dstCb = *(uint64_as*)srcCb;
+            *(uint64_as*)dstCr = *(uint64_as*)srcCr;
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            dstCb += dstPitch;
+            dstCr += dstPitch;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < N; i++)
+        {
+            *(uint32_as*)dstCb = *(uint32_as*)srcCb;
+            *(uint32_as*)dstCr = *(uint32_as*)srcCr;
+            srcCb += srcPitch;
+            srcCr += srcPitch;
+            dstCb += dstPitch;
+            dstCr += dstPitch;
+        }
+    }
+}
+
+// WxN 色差分量帧间预测, W = 8 或 4
+template<int MODE>
+static void chroma_inter_pred_WxN_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, int W, int N, const McBlend* blend)
+{
+    const int xInt = x >> 3;
+    const int yInt = y >> 3;
+    const int dx = x & 7;
+    const int dy = y & 7;
+    int srcPitch = ctx->picPitch[1];
+    const uint8_t* srcCb = nullptr;
+    const uint8_t* srcCr = nullptr;
+
+    Rect rc1 = {xInt, yInt, xInt + W + 1, yInt + N + 1};
+    if (in_rect_of(&rc1, &ctx->refRcCbcr))
+    {
+        // 在参考帧实际图像范围内
+        srcCb = refpic->plane[1] + yInt * srcPitch + xInt;
+        srcCr = refpic->plane[2] + yInt * srcPitch + xInt;
+    }
+    else
+    {
+        // 对参考帧边界进行扩展, 得到参考数据
+        McExtRect refRect;
+        refRect.x = xInt;
+        refRect.y = yInt;
+        refRect.height = N + 1;
+        refRect.picWidth = ctx->chromaWidth;
+        refRect.picHeight = ctx->chromaHeight;
+        refRect.buf = ctx->tempBuf;
+        if (W == 8)
+        {
+            get_ref_data_16xN(refpic->plane[1], srcPitch, refRect);
+            refRect.buf = ctx->tempBuf + 16 * 16;
+            get_ref_data_16xN(refpic->plane[2], srcPitch, refRect);
+            srcPitch = 16;
+        }
+        else
+        {
+            get_ref_data_8xN(refpic->plane[1], srcPitch, refRect);
+            refRect.buf = ctx->tempBuf + 16 * 16;
+            get_ref_data_8xN(refpic->plane[2], srcPitch, refRect);
+            srcPitch = 8;
+        }
+        srcCb = ctx->tempBuf;
+        srcCr = ctx->tempBuf + 16 * 16;
+    }
+
+    if ((dx | dy) == 0)
+        MC_copy_cbcr_avx2<MODE>(srcCb, srcCr, srcPitch, dstCb, dstCr, dstPitch, W, N, blend);
+    else if (W == 8)
+        MC_chroma_8xN_avx2<MODE>(srcCb, srcCr, srcPitch, dstCb, dstCr, dstPitch, dx, dy, N, blend);
+    else
+        MC_chroma_4xN_avx2<MODE>(srcCb, srcCr, srcPitch, dstCb, dstCr, dstPitch, dx, dy, N, blend);
+}
+
+// WxN 色差分量帧间预测, 同时加权及取平均
+static void chroma_inter_pred_blend_WxN_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, int W, int N, const McBlend* blend)
+{
+    switch (blend->mode)
+    {
+    case MC_BLEND_WEIGHT:
+        chroma_inter_pred_WxN_avx2<MC_BLEND_WEIGHT>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, W, N, blend);
+        break;
+    case MC_BLEND_AVG:
+        chroma_inter_pred_WxN_avx2<MC_BLEND_AVG>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, W, N, blend);
+        break;
+    case MC_BLEND_WEIGHT | MC_BLEND_AVG:
+        chroma_inter_pred_WxN_avx2<MC_BLEND_WEIGHT | MC_BLEND_AVG>(
+            ctx, refpic, dstCb, dstCr, dstPitch, x, y, W, N, blend);
+        break;
+    default:
+        chroma_inter_pred_WxN_avx2<0>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, W, N, blend);
+        break;
+    }
+}
+
+// 8x8 色差分量帧间预测
+void chroma_inter_pred_8x8_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    chroma_inter_pred_WxN_avx2<0>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 8, 8, nullptr);
+}
+
+// 8x4 色差分量帧间预测
+void chroma_inter_pred_8x4_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    chroma_inter_pred_WxN_avx2<0>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 8, 4, nullptr);
+}
+
+// 4x8 色差分量帧间预测
+void chroma_inter_pred_4x8_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    chroma_inter_pred_WxN_avx2<0>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 4, 8, nullptr);
+}
+
+// 4x4 色差分量帧间预测
+void chroma_inter_pred_4x4_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    chroma_inter_pred_WxN_avx2<0>(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 4, 4, nullptr);
+}
+
+// 8x8 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_8x8_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend_WxN_avx2(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 8, 8, blend);
+}
+
+// 8x4 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_8x4_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend_WxN_avx2(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 8, 4, blend);
+}
+
+// 4x8 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_4x8_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend_WxN_avx2(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 4, 8, blend);
+}
+
+// 4x4 色差分量帧间预测, 同时加权及取平均
+void chroma_inter_pred_blend_4x4_avx2(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    chroma_inter_pred_blend_WxN_avx2(ctx, refpic, dstCb, dstCr, dstPitch, x, y, 4, 4, blend);
+}
+
+}   // namespace irk_avs_dec
@@ -65,7 +65,8 @@ void intra_pred_hor(uint8_t* dst, int pitch, NBUsable)
     }
 }
 
-#define LOAD_LEFT_EDGE_X10( dst, src, pitch ) \
+// 左下 8x8 块不可用时不读取其像素, 该块可能属于下一宏块行, 在 wavefront 模式下正在被其他线程重建
+#define LOAD_LEFT_EDGE_X10( dst, src, pitch, leftDown ) \
     (dst)[0] = (src)[0-pitch];      \
     (dst)[1] = (src)[0];            \
     (dst)[2] = (src)[pitch];        \
@@ -75,7 +76,7 @@ void intra_pred_hor(uint8_t* dst, int pitch, NBUsable)
     (dst)[6] = (src)[pitch*5];      \
     (dst)[7] = (src)[pitch*6];      \
     (dst)[8] = (src)[pitch*7];      \
-    (dst)[9] = (src)[pitch*8];
+    (dst)[9] = (src)[pitch*(7+(leftDown))];
 
 // DC 预测
 void intra_pred_dc(uint8_t* dst, int pitch, NBUsable usable)
@@ -88,7 +89,7 @@ void intra_pred_dc(uint8_t* dst, int pitch, NBUsable usable)
         alignas(16) uint8_t buf[16];
         const uint8_t* left = dst - 1;
         const uint8_t* top = dst - pitch;
-        LOAD_LEFT_EDGE_X10(buf, left, pitch);
+        LOAD_LEFT_EDGE_X10(buf, left, pitch, flags[3]);
 
         xm6 = _mm_setzero_si128();
         xm6 = _mm_cmpeq_epi16(xm6, xm6);            // -1
@@ -195,7 +196,7 @@ void intra_pred_dc(uint8_t* dst, int pitch, NBUsable usable)
     {
         alignas(16) uint8_t buf[16];
         const uint8_t* left = dst - 1;
-        LOAD_LEFT_EDGE_X10(buf, left, pitch);
+        LOAD_LEFT_EDGE_X10(buf, left, pitch, flags[3]);
         xm1 = _mm_loadl_epi64((__m128i*)(buf + 1));
         xm3 = _mm_setzero_si128();              // 0
         xm1 = _mm_unpacklo_epi8(xm1, xm3);
@@ -1414,7 +1414,7 @@ static void LF_chroma_hor_bs1_sse4(uint8_t* data, int pitch, int16_t alpha, int1
 }
 
 //======================================================================================================================
-static const uint8_t s_AlphaTab[64 + 16] =
+extern const uint8_t g_LFAlphaTab[64 + 16] =
 {
     0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  2,  2,  2,  3,  3,
     4,  4,  5,  5,  6,  7,  8,  9,  10, 11, 12, 13, 15, 16, 18, 20,
@@ -1423,7 +1423,7 @@ static const uint8_t s_AlphaTab[64 + 16] =
     64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
 };
 
-static const uint8_t s_BetaTab[64 + 16] =
+extern const uint8_t g_LFBetaTab[64 + 16] =
 {
     0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,
     2,  2,  3,  3,  3,  3,  4,  4,  4,  4,  5,  5,  5,  5,  6,  6,
@@ -1432,7 +1432,7 @@ static const uint8_t s_BetaTab[64 + 16] =
     27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
 };
 
-static const uint8_t s_TcTab[64 + 16] =
+extern const uint8_t g_LFTcTab[64 + 16] =
 {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2,
@@ -1462,8 +1462,8 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         int idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_ver_bs2_sse4(dst, pitch, alpha, beta);
             LF_luma_ver_bs2_sse4(dst + 8 * pitch, pitch, alpha, beta);
         }
@@ -1473,8 +1473,8 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_ver_bs2_sse4(dst + 8, pitch, alpha, beta);
             LF_luma_ver_bs2_sse4(dst + 8 + 8 * pitch, pitch, alpha, beta);
         }
@@ -1485,8 +1485,8 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_hor_bs2_sse4(dst, pitch, alpha, beta);
             LF_luma_hor_bs2_sse4(dst + 8, pitch, alpha, beta);
         }
@@ -1496,8 +1496,8 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_hor_bs2_sse4(dst + 8 * pitch, pitch, alpha, beta);
             LF_luma_hor_bs2_sse4(dst + 8 * pitch + 8, pitch, alpha, beta);
         }
@@ -1518,7 +1518,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
     }
     for (int i = 1; i < mbCnt; i++)
@@ -1532,7 +1532,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_ver_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_ver_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
 
         // 水平边界
@@ -1543,7 +1543,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
             int idxB = g_ChromaQp[avQp] + betaOffset;
             if (idxA >= 6 && idxB >= 6)
             {
-                LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
             }
         }
     }
@@ -1560,7 +1560,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
     }
     for (int i = 1; i < mbCnt; i++)
@@ -1574,7 +1574,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_ver_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_ver_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
 
         // 水平边界
@@ -1585,7 +1585,7 @@ void loop_filterI_sse4(FrmDecContext* ctx, int my)
             int idxB = g_ChromaQp[avQp] + betaOffset;
             if (idxA >= 6 && idxB >= 6)
             {
-                LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
             }
         }
     }
@@ -1613,8 +1613,8 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
         int idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA)      // bs == 2
             {
                 LF_luma_ver_bs2_sse4(dst, pitch, alpha, beta);
@@ -1623,9 +1623,9 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x1)
-                    LF_luma_ver_bs1_sse4(dst, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_sse4(dst, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x4)
-                    LF_luma_ver_bs1_sse4(dst + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_sse4(dst + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -1634,8 +1634,8 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA0)      // bs == 2
             {
                 LF_luma_ver_bs2_sse4(dst + 8, pitch, alpha, beta);
@@ -1644,9 +1644,9 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x10)
-                    LF_luma_ver_bs1_sse4(dst + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_sse4(dst + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x40)
-                    LF_luma_ver_bs1_sse4(dst + 8 + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_sse4(dst + 8 + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -1656,8 +1656,8 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
         idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA00)        // bs == 2
             {
                 LF_luma_hor_bs2_sse4(dst, pitch, alpha, beta);
@@ -1666,9 +1666,9 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x100)
-                    LF_luma_hor_bs1_sse4(dst, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_sse4(dst, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x400)
-                    LF_luma_hor_bs1_sse4(dst + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_sse4(dst + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -1677,8 +1677,8 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA000)   // bs == 2
             {
                 LF_luma_hor_bs2_sse4(dst + 8 * pitch, pitch, alpha, beta);
@@ -1687,9 +1687,9 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x1000)
-                    LF_luma_hor_bs1_sse4(dst + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_sse4(dst + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x4000)
-                    LF_luma_hor_bs1_sse4(dst + 8 * pitch + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_sse4(dst + 8 * pitch + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -1716,14 +1716,14 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA)
                 {
-                    LF_chroma_ver_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_ver_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x5))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * (bs & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 2) & 1);
-                    LF_chroma_ver_bs1_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * (bs & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 2) & 1);
+                    LF_chroma_ver_bs1_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -1738,14 +1738,14 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA00)
                 {
-                    LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x500))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * ((bs >> 8) & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 10) & 1);
-                    LF_chroma_hor_bs1_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * ((bs >> 8) & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 10) & 1);
+                    LF_chroma_hor_bs1_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -1772,14 +1772,14 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA)
                 {
-                    LF_chroma_ver_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_ver_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x5))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * (bs & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 2) & 1);
-                    LF_chroma_ver_bs1_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * (bs & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 2) & 1);
+                    LF_chroma_ver_bs1_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -1794,14 +1794,14 @@ void loop_filterPB_sse4(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA00)
                 {
-                    LF_chroma_hor_bs2_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_hor_bs2_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x500))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * ((bs >> 8) & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 10) & 1);
-                    LF_chroma_hor_bs1_sse4(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * ((bs >> 8) & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 10) & 1);
+                    LF_chroma_hor_bs1_sse4(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -2104,8 +2104,8 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         int idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_ver_bs2_c(dst, pitch, alpha, beta);
             LF_luma_ver_bs2_c(dst + 8 * pitch, pitch, alpha, beta);
         }
@@ -2115,8 +2115,8 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_ver_bs2_c(dst + 8, pitch, alpha, beta);
             LF_luma_ver_bs2_c(dst + 8 + 8 * pitch, pitch, alpha, beta);
         }
@@ -2127,8 +2127,8 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_hor_bs2_c(dst, pitch, alpha, beta);
             LF_luma_hor_bs2_c(dst + 8, pitch, alpha, beta);
         }
@@ -2138,8 +2138,8 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             LF_luma_hor_bs2_c(dst + 8 * pitch, pitch, alpha, beta);
             LF_luma_hor_bs2_c(dst + 8 * pitch + 8, pitch, alpha, beta);
         }
@@ -2160,7 +2160,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
     }
     for (int i = 1; i < mbCnt; i++)
@@ -2174,7 +2174,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_ver_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_ver_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
 
         // 水平边界
@@ -2185,7 +2185,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
             int idxB = g_ChromaQp[avQp] + betaOffset;
             if (idxA >= 6 && idxB >= 6)
             {
-                LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
             }
         }
     }
@@ -2202,7 +2202,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
     }
     for (int i = 1; i < mbCnt; i++)
@@ -2216,7 +2216,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
         int idxB = g_ChromaQp[avQp] + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            LF_chroma_ver_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+            LF_chroma_ver_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
         }
 
         // 水平边界
@@ -2227,7 +2227,7 @@ void loop_filterI_c(FrmDecContext* ctx, int my)
             int idxB = g_ChromaQp[avQp] + betaOffset;
             if (idxA >= 6 && idxB >= 6)
             {
-                LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
             }
         }
     }
@@ -2255,8 +2255,8 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
         int idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA)      // bs == 2
             {
                 LF_luma_ver_bs2_c(dst, pitch, alpha, beta);
@@ -2265,9 +2265,9 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x1)
-                    LF_luma_ver_bs1_c(dst, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_c(dst, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x4)
-                    LF_luma_ver_bs1_c(dst + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_c(dst + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -2276,8 +2276,8 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA0)      // bs == 2
             {
                 LF_luma_ver_bs2_c(dst + 8, pitch, alpha, beta);
@@ -2286,9 +2286,9 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x10)
-                    LF_luma_ver_bs1_c(dst + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_c(dst + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x40)
-                    LF_luma_ver_bs1_c(dst + 8 + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_ver_bs1_c(dst + 8 + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -2298,8 +2298,8 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
         idxB = avQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA00)        // bs == 2
             {
                 LF_luma_hor_bs2_c(dst, pitch, alpha, beta);
@@ -2308,9 +2308,9 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x100)
-                    LF_luma_hor_bs1_c(dst, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_c(dst, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x400)
-                    LF_luma_hor_bs1_c(dst + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_c(dst + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -2319,8 +2319,8 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
         idxB = curQp + betaOffset;
         if (idxA >= 6 && idxB >= 6)
         {
-            int16_t alpha = s_AlphaTab[idxA];
-            int16_t beta = s_BetaTab[idxB];
+            int16_t alpha = g_LFAlphaTab[idxA];
+            int16_t beta = g_LFBetaTab[idxB];
             if (bs & 0xA000)   // bs == 2
             {
                 LF_luma_hor_bs2_c(dst + 8 * pitch, pitch, alpha, beta);
@@ -2329,9 +2329,9 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             else if (idxA >= 16)
             {
                 if (bs & 0x1000)
-                    LF_luma_hor_bs1_c(dst + 8 * pitch, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_c(dst + 8 * pitch, pitch, alpha, beta, g_LFTcTab[idxA]);
                 if (bs & 0x4000)
-                    LF_luma_hor_bs1_c(dst + 8 * pitch + 8, pitch, alpha, beta, s_TcTab[idxA]);
+                    LF_luma_hor_bs1_c(dst + 8 * pitch + 8, pitch, alpha, beta, g_LFTcTab[idxA]);
             }
         }
 
@@ -2358,14 +2358,14 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA)
                 {
-                    LF_chroma_ver_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_ver_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x5))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * (bs & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 2) & 1);
-                    LF_chroma_ver_bs1_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * (bs & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 2) & 1);
+                    LF_chroma_ver_bs1_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -2380,14 +2380,14 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA00)
                 {
-                    LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x500))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * ((bs >> 8) & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 10) & 1);
-                    LF_chroma_hor_bs1_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * ((bs >> 8) & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 10) & 1);
+                    LF_chroma_hor_bs1_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -2414,14 +2414,14 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA)
                 {
-                    LF_chroma_ver_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_ver_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x5))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * (bs & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 2) & 1);
-                    LF_chroma_ver_bs1_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * (bs & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 2) & 1);
+                    LF_chroma_ver_bs1_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -2436,14 +2436,14 @@ void loop_filterPB_c(FrmDecContext* ctx, int my)
             {
                 if (bs & 0xA00)
                 {
-                    LF_chroma_hor_bs2_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB]);
+                    LF_chroma_hor_bs2_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB]);
                 }
                 else if (idxA >= 16 && (bs & 0x500))
                 {
                     int16_t tc[2];
-                    tc[0] = s_TcTab[idxA] * ((bs >> 8) & 1);
-                    tc[1] = s_TcTab[idxA] * ((bs >> 10) & 1);
-                    LF_chroma_hor_bs1_c(dst, pitch, s_AlphaTab[idxA], s_BetaTab[idxB], tc);
+                    tc[0] = g_LFTcTab[idxA] * ((bs >> 8) & 1);
+                    tc[1] = g_LFTcTab[idxA] * ((bs >> 10) & 1);
+                    LF_chroma_hor_bs1_c(dst, pitch, g_LFAlphaTab[idxA], g_LFBetaTab[idxB], tc);
                 }
             }
         }
@@ -0,0 +1,532 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+// 本文件单独使用 AVX2 编译选项, 只能被运行时检测到 AVX2 支持后调用
+// 注意: 不要在本文件中调用头文件中的非 static inline 函数, 避免链接时与 SSE 版本混淆
+
+#include <immintrin.h>      // AVX2
+#include "AvsDecoder.h"
+
+namespace irk_avs_dec {
+
+extern const uint8_t g_LFAlphaTab[64 + 16];
+extern const uint8_t g_LFBetaTab[64 + 16];
+extern const uint8_t g_LFTcTab[64 + 16];
+
+// 与 SSE 版本的区别:
+// 1. 亮度一条边界的 16 个像素一次完成滤波, 不再拆分为两次 8 个像素
+// 2. Cb, Cr 同一位置的边界一起滤波, 低 128 位为 Cb, 高 128 位为 Cr
+// 3. 亮度和色度在同一次宏块循环中完成, 整个宏块行只遍历一次
+// 宏块之间的边界必须按照宏块顺序依次滤波(后一宏块的垂直边界会修改前一宏块水平边界滤波后的像素),
+// 因此不能将相邻两个宏块的边界合并处理, 否则结果与标准不一致
+
+// 低 8 个 int16 为 lo, 高 8 个 int16 为 hi
+static inline __m256i set2x8_epi16(int16_t lo, int16_t hi)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi16(lo)), _mm_set1_epi16(hi), 1);
+}
+
+// 读取 16 行, 每行 8 个像素, 前 8 行从 src0 开始, 后 8 行从 src1 开始
+// 转置后 col[k] 为第 k 列的 16 个像素, 转化为 int16
+static inline void load_transpose_8x16(const uint8_t* src0, const uint8_t* src1, int pitch, __m256i col[8])
+{
+    __m256i r0, r1, r2, r3, r4, r5, r6, r7;
+    __m256i t0, t1, t2, t3;
+    const __m256i zero = _mm256_setzero_si256();
+
+#define LOAD_2ROWS( k ) _mm256_inserti128_si256( _mm256_castsi128_si256( \
+    _mm_loadl_epi64((__m128i*)(src0 + (k) * pitch)) ), _mm_loadl_epi64((__m128i*)(src1 + (k) * pitch)), 1 )
+    r0 = LOAD_2ROWS(0);
+    r1 = LOAD_2ROWS(1);
+    r2 = LOAD_2ROWS(2);
+    r3 = LOAD_2ROWS(3);
+    r4 = LOAD_2ROWS(4);
+    r5 = LOAD_2ROWS(5);
+    r6 = LOAD_2ROWS(6);
+    r7 = LOAD_2ROWS(7);
+#undef LOAD_2ROWS
+
+    r0 = _mm256_unpacklo_epi8(r0, r1);
+    r2 = _mm256_unpacklo_epi8(r2, r3);
+    r4 = _mm256_unpacklo_epi8(r4, r5);
+    r6 = _mm256_unpacklo_epi8(r6, r7);
+    t0 = _mm256_unpacklo_epi16(r0, r2);     // 第 0~3 列, 第 0~3 行
+    t1 = _mm256_unpackhi_epi16(r0, r2);     // 第 4~7 列, 第 0~3 行
+    t2 = _mm256_unpacklo_epi16(r4, r6);     // 第 0~3 列, 第 4~7 行
+    t3 = _mm256_unpackhi_epi16(r4, r6);     // 第 4~7 列, 第 4~7 行
+    r0 = _mm256_unpacklo_epi32(t0, t2);     // 第 0, 1 列
+    r1 = _mm256_unpackhi_epi32(t0, t2);     // 第 2, 3 列
+    r2 = _mm256_unpacklo_epi32(t1, t3);     // 第 4, 5 列
+    r3 = _mm256_unpackhi_epi32(t1, t3);     // 第 6, 7 列
+    col[0] = _mm256_unpacklo_epi8(r0, zero);
+    col[1] = _mm256_unpackhi_epi8(r0, zero);
+    col[2] = _mm256_unpacklo_epi8(r1, zero);
+    col[3] = _mm256_unpackhi_epi8(r1, zero);
+    col[4] = _mm256_unpacklo_epi8(r2, zero);
+    col[5] = _mm256_unpackhi_epi8(r2, zero);
+    col[6] = _mm256_unpacklo_epi8(r3, zero);
+    col[7] = _mm256_unpackhi_epi8(r3, zero);
+}
+
+// 将垂直边界两侧各两列像素 p1, p0, q0, q1 转置后写回, dst0/dst1 分别对应前后 8 行
+static inline void store_transpose_4x16(uint8_t* dst0, uint8_t* dst1, int pitch,
+                                        __m256i p1, __m256i p0, __m256i q0, __m256i q1)
+{
+    alignas(32) uint8_t buf[64];
+    __m256i ym0 = _mm256_packus_epi16(p1, q0);
+    __m256i ym1 = _mm256_packus_epi16(p0, q1);
+    __m256i ym2 = _mm256_unpacklo_epi8(ym0, ym1);   // p1, p0
+    __m256i ym3 = _mm256_unpackhi_epi8(ym0, ym1);   // q0, q1
+    _mm256_store_si256((__m256i*)buf, _mm256_unpacklo_epi16(ym2, ym3));         // 第 0~3, 8~11 行
+    _mm256_store_si256((__m256i*)(buf + 32), _mm256_unpackhi_epi16(ym2, ym3));  // 第 4~7, 12~15 行
+    for (int k = 0; k < 4; k++)
+    {
+        *(int32_as*)(dst0 + k * pitch) = *(int32_as*)(buf + k * 4);
+        *(int32_as*)(dst0 + (k + 4) * pitch) = *(int32_as*)(buf + 32 + k * 4);
+        *(int32_as*)(dst1 + k * pitch) = *(int32_as*)(buf + 16 + k * 4);
+        *(int32_as*)(dst1 + (k + 4) * pitch) = *(int32_as*)(buf + 48 + k * 4);
+    }
+}
+
+// 将垂直边界两侧各一列像素 p0, q0 转置后写回, dst0/dst1 分别对应前后 8 行
+static inline void store_transpose_2x16(uint8_t* dst0, uint8_t* dst1, int pitch, __m256i p0, __m256i q0)
+{
+    alignas(32) uint8_t buf[32];
+    __m256i ym = _mm256_packus_epi16(p0, q0);
+    ym = _mm256_unpacklo_epi8(ym, _mm256_srli_si256(ym, 8));
+    _mm256_store_si256((__m256i*)buf, ym);
+    for (int k = 0; k < 8; k++)
+    {
+        *(uint16_as*)(dst0 + k * pitch) = *(uint16_as*)(buf + k * 2);
+        *(uint16_as*)(dst1 + k * pitch) = *(uint16_as*)(buf + 16 + k * 2);
+    }
+}
+
+// 读取一行 16 个亮度像素, 或者 Cb, Cr 各 8 个像素, 转化为 int16
+#define LOAD_LUMA_16( addr ) _mm256_cvtepu8_epi16( _mm_loadu_si128((__m128i*)(addr)) )
+#define LOAD_CBCR_16( cb, cr ) _mm256_cvtepu8_epi16( _mm_unpacklo_epi64( \
+    _mm_loadl_epi64((__m128i*)(cb)), _mm_loadl_epi64((__m128i*)(cr)) ) )
+
+// 写回一行 16 个亮度像素
+static inline void store_luma_16(uint8_t* dst, __m256i ym)
+{
+    ym = _mm256_packus_epi16(ym, ym);
+    ym = _mm256_permute4x64_epi64(ym, 0x08);
+    _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(ym));
+}
+
+// 写回 Cb, Cr 各 8 个像素
+static inline void store_cbcr_16(uint8_t* dstCb, uint8_t* dstCr, __m256i ym)
+{
+    ym = _mm256_packus_epi16(ym, ym);
+    _mm_storel_epi64((__m128i*)dstCb, _mm256_castsi256_si128(ym));
+    _mm_storel_epi64((__m128i*)dstCr, _mm256_extracti128_si256(ym, 1));
+}
+
+//======================================================================================================================
+// bs = 2 的滤波, 16 个像素, p0~q1 输入输出均为 int16, 返回 false 表示所有像素都不需要滤波
+
+static inline bool LF_luma_bs2(__m256i& p1, __m256i& p0, __m256i& q0, __m256i& q1, __m256i p2, __m256i q2,
+                               __m256i alpha, __m256i beta)
+{
+    const __m256i add2 = _mm256_set1_epi16(2);
+    __m256i m0, m1, m2, m3, x0, x1;
+
+    // 计算 mask
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p0, q0));    // abs(p0 - q0)
+    m3 = _mm256_srai_epi16(alpha, 2);
+    m3 = _mm256_add_epi16(m3, add2);                    // (alpha >> 2) + 2
+    m0 = _mm256_cmpgt_epi16(alpha, x0);                 // abs(p0 - q0) < alpha
+    m3 = _mm256_cmpgt_epi16(m3, x0);                    // abs(p0 - q0) < (alpha >> 2) + 2
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p1, p0));    // abs(p1 - p0)
+    x1 = _mm256_abs_epi16(_mm256_sub_epi16(q1, q0));    // abs(q1 - q0)
+    x0 = _mm256_cmpgt_epi16(beta, x0);                  // abs(p1 - p0) < beta
+    x1 = _mm256_cmpgt_epi16(beta, x1);                  // abs(q1 - q0) < beta
+    m0 = _mm256_and_si256(m0, x0);
+    m0 = _mm256_and_si256(m0, x1);      // abs(p0 - q0) < alpha && abs(p1 - p0) < beta && abs(q1 - q0) < beta
+    if (_mm256_testz_si256(m0, m0))
+        return false;
+
+    p2 = _mm256_abs_epi16(_mm256_sub_epi16(p2, p0));    // abs(p2 - p0)
+    q2 = _mm256_abs_epi16(_mm256_sub_epi16(q2, q0));    // abs(q2 - q0)
+    m1 = _mm256_cmpgt_epi16(beta, p2);                  // abs(p2 - p0) < beta
+    m2 = _mm256_cmpgt_epi16(beta, q2);                  // abs(q2 - q0) < beta
+    m1 = _mm256_and_si256(m1, m3);      // abs(p2 - p0) < beta && abs(p0 - q0) < (alpha >> 2) + 2
+    m2 = _mm256_and_si256(m2, m3);      // abs(q2 - q0) < beta && abs(p0 - q0) < (alpha >> 2) + 2
+
+    m3 = _mm256_add_epi16(p0, q0);
+    m3 = _mm256_add_epi16(m3, add2);                    // p0 + q0 + 2
+    x0 = _mm256_add_epi16(p1, p0);
+    x1 = _mm256_add_epi16(p1, p1);
+    x0 = _mm256_add_epi16(x0, m3);                      // p1 + 2*p0 + q0 + 2
+    x1 = _mm256_add_epi16(x1, m3);                      // 2*p1 + p0 + q0 + 2
+    x0 = _mm256_srai_epi16(x0, 2);
+    x1 = _mm256_srai_epi16(x1, 2);
+    x0 = _mm256_blendv_epi8(x1, x0, m1);                // select p0
+    m1 = _mm256_and_si256(m1, m0);
+    p0 = _mm256_blendv_epi8(p0, x0, m0);
+    p1 = _mm256_blendv_epi8(p1, x1, m1);
+    x0 = _mm256_add_epi16(q1, q0);
+    x1 = _mm256_add_epi16(q1, q1);
+    x0 = _mm256_add_epi16(x0, m3);                      // q1 + 2*q0 + p0 + 2
+    x1 = _mm256_add_epi16(x1, m3);                      // 2*q1 + q0 + p0 + 2
+    x0 = _mm256_srai_epi16(x0, 2);
+    x1 = _mm256_srai_epi16(x1, 2);
+    x0 = _mm256_blendv_epi8(x1, x0, m2);                // select q0
+    m2 = _mm256_and_si256(m2, m0);
+    q0 = _mm256_blendv_epi8(q0, x0, m0);
+    q1 = _mm256_blendv_epi8(q1, x1, m2);
+    return true;
+}
+
+static inline bool LF_chroma_bs2(__m256i& p0, __m256i& q0, __m256i p1, __m256i q1, __m256i p2, __m256i q2,
+                                 __m256i alpha, __m256i beta)
+{
+    const __m256i add2 = _mm256_set1_epi16(2);
+    __m256i m0, m1, m2, m3, x0, x1;
+
+    // 计算 mask
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p0, q0));    // abs(p0 - q0)
+    m3 = _mm256_srai_epi16(alpha, 2);
+    m3 = _mm256_add_epi16(m3, add2);                    // (alpha >> 2) + 2
+    m0 = _mm256_cmpgt_epi16(alpha, x0);                 // abs(p0 - q0) < alpha
+    m3 = _mm256_cmpgt_epi16(m3, x0);                    // abs(p0 - q0) < (alpha >> 2) + 2
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p1, p0));    // abs(p1 - p0)
+    x1 = _mm256_abs_epi16(_mm256_sub_epi16(q1, q0));    // abs(q1 - q0)
+    x0 = _mm256_cmpgt_epi16(beta, x0);                  // abs(p1 - p0) < beta
+    x1 = _mm256_cmpgt_epi16(beta, x1);                  // abs(q1 - q0) < beta
+    m0 = _mm256_and_si256(m0, x0);
+    m0 = _mm256_and_si256(m0, x1);      // abs(p0 - q0) < alpha && abs(p1 - p0) < beta && abs(q1 - q0) < beta
+    if (_mm256_testz_si256(m0, m0))
+        return false;
+
+    p2 = _mm256_abs_epi16(_mm256_sub_epi16(p2, p0));    // abs(p2 - p0)
+    q2 = _mm256_abs_epi16(_mm256_sub_epi16(q2, q0));    // abs(q2 - q0)
+    m1 = _mm256_cmpgt_epi16(beta, p2);                  // abs(p2 - p0) < beta
+    m2 = _mm256_cmpgt_epi16(beta, q2);                  // abs(q2 - q0) < beta
+    m1 = _mm256_and_si256(m1, m3);      // abs(p2 - p0) < beta && abs(p0 - q0) < (alpha >> 2) + 2
+    m2 = _mm256_and_si256(m2, m3);      // abs(q2 - q0) < beta && abs(p0 - q0) < (alpha >> 2) + 2
+
+    m3 = _mm256_add_epi16(p0, q0);
+    m3 = _mm256_add_epi16(m3, add2);                    // p0 + q0 + 2
+    x0 = _mm256_add_epi16(p1, p0);
+    x1 = _mm256_add_epi16(p1, p1);
+    x0 = _mm256_add_epi16(x0, m3);                      // p1 + 2*p0 + q0 + 2
+    x1 = _mm256_add_epi16(x1, m3);                      // 2*p1 + p0 + q0 + 2
+    x1 = _mm256_blendv_epi8(x1, x0, m1);                // select p0
+    x1 = _mm256_srai_epi16(x1, 2);
+    p0 = _mm256_blendv_epi8(p0, x1, m0);
+    x0 = _mm256_add_epi16(q1, q0);
+    x1 = _mm256_add_epi16(q1, q1);
+    x0 = _mm256_add_epi16(x0, m3);                      // q1 + 2*q0 + p0 + 2
+    x1 = _mm256_add_epi16(x1, m3);                      // 2*q1 + q0 + p0 + 2
+    x1 = _mm256_blendv_epi8(x1, x0, m2);                // select q0
+    x1 = _mm256_srai_epi16(x1, 2);
+    q0 = _mm256_blendv_epi8(q0, x1, m0);
+    return true;
+}
+
+// bs = 1 的滤波, tc 为 0 的像素保持不变
+static inline bool LF_luma_bs1(__m256i& p1, __m256i& p0, __m256i& q0, __m256i& q1, __m256i p2, __m256i q2,
+                               __m256i alpha, __m256i beta, __m256i tc)
+{
+    const __m256i add4 = _mm256_set1_epi16(4);
+    __m256i m0, m1, x0, x1, c0, c1;
+
+    // 计算 mask
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p0, q0));
+    m0 = _mm256_cmpgt_epi16(alpha, x0);                 // abs(p0 - q0) < alpha
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p1, p0));    // abs(p1 - p0)
+    x1 = _mm256_abs_epi16(_mm256_sub_epi16(q1, q0));    // abs(q1 - q0)
+    x0 = _mm256_cmpgt_epi16(beta, x0);                  // abs(p1 - p0) < beta
+    x1 = _mm256_cmpgt_epi16(beta, x1);                  // abs(q1 - q0) < beta
+    m0 = _mm256_and_si256(m0, x0);
+    m0 = _mm256_and_si256(m0, x1);      // abs(p0 - q0) < alpha && abs(p1 - p0) < beta && abs(q1 - q0) < beta
+    if (_mm256_testz_si256(m0, m0))
+        return false;
+
+    c0 = _mm256_and_si256(tc, m0);                      // tc
+    c1 = _mm256_sign_epi16(c0, m0);                     // -tc
+    m1 = _mm256_cmpgt_epi16(beta, _mm256_abs_epi16(_mm256_sub_epi16(q2, q0)));  // abs(q2 - q0) < beta
+    m0 = _mm256_cmpgt_epi16(beta, _mm256_abs_epi16(_mm256_sub_epi16(p2, p0)));  // abs(p2 - p0) < beta
+
+    x0 = _mm256_sub_epi16(q0, p0);                      // q0 - p0
+    x1 = _mm256_sub_epi16(p1, q1);                      // p1 - q1
+    x1 = _mm256_add_epi16(x1, x0);                      // (p1 - q1) + (q0 - p0)
+    x0 = _mm256_add_epi16(x0, x0);                      // (q0 - p0) * 2
+    x1 = _mm256_add_epi16(x1, x0);                      // (q0 - p0) * 3 + (p1 - q1)
+    x1 = _mm256_add_epi16(x1, add4);                    // (q0 - p0) * 3 + (p1 - q1) + 4
+    x1 = _mm256_srai_epi16(x1, 3);
+    x1 = _mm256_min_epi16(x1, c0);
+    x1 = _mm256_max_epi16(x1, c1);                      // delta
+    p0 = _mm256_add_epi16(p0, x1);                      // + delta
+    q0 = _mm256_sub_epi16(q0, x1);                      // - delta
+    x0 = _mm256_setzero_si256();
+    x1 = _mm256_set1_epi16(255);
+    p0 = _mm256_min_epi16(_mm256_max_epi16(p0, x0), x1);    // clip 0~255
+    q0 = _mm256_min_epi16(_mm256_max_epi16(q0, x0), x1);    // clip 0~255
+
+    x1 = _mm256_sub_epi16(p0, p1);                      // P0 - p1
+    p2 = _mm256_sub_epi16(p2, q0);                      // p2 - Q0
+    p2 = _mm256_add_epi16(p2, x1);                      // (P0 - p1) + (p2 - Q0)
+    x1 = _mm256_add_epi16(x1, x1);                      // (P0 - p1) * 2
+    x1 = _mm256_add_epi16(x1, p2);
+    x1 = _mm256_add_epi16(x1, add4);                    // (P0 - p1) * 3 + (p2 - Q0) + 4
+    x1 = _mm256_srai_epi16(x1, 3);
+    x1 = _mm256_min_epi16(x1, c0);
+    x1 = _mm256_max_epi16(x1, c1);
+    x1 = _mm256_and_si256(x1, m0);
+    p1 = _mm256_add_epi16(p1, x1);                      // p1 + delta
+
+    x1 = _mm256_sub_epi16(q1, q0);                      // q1 - Q0
+    x0 = _mm256_sub_epi16(p0, q2);                      // P0 - q2
+    x0 = _mm256_add_epi16(x0, x1);                      // (q1 - Q0) + (P0 - q2)
+    x1 = _mm256_add_epi16(x1, x1);                      // (q1 - Q0) * 2
+    x1 = _mm256_add_epi16(x1, x0);
+    x1 = _mm256_add_epi16(x1, add4);                    // (q1 - Q0) * 3 + (P0 - q2) + 4
+    x1 = _mm256_srai_epi16(x1, 3);
+    x1 = _mm256_min_epi16(x1, c0);
+    x1 = _mm256_max_epi16(x1, c1);
+    x1 = _mm256_and_si256(x1, m1);
+    q1 = _mm256_sub_epi16(q1, x1);                      // q1 - delta
+    return true;
+}
+
+static inline bool LF_chroma_bs1(__m256i& p0, __m256i& q0, __m256i p1, __m256i q1,
+                                 __m256i alpha, __m256i beta, __m256i tc)
+{
+    __m256i m0, x0, x1;
+
+    // 计算 mask
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p0, q0));
+    m0 = _mm256_cmpgt_epi16(alpha, x0);                 // abs(p0 - q0) < alpha
+    x0 = _mm256_abs_epi16(_mm256_sub_epi16(p1, p0));    // abs(p1 - p0)
+    x1 = _mm256_abs_epi16(_mm256_sub_epi16(q1, q0));    // abs(q1 - q0)
+    x0 = _mm256_cmpgt_epi16(beta, x0);                  // abs(p1 - p0) < beta
+    x1 = _mm256_cmpgt_epi16(beta, x1);                  // abs(q1 - q0) < beta
+    m0 = _mm256_and_si256(m0, x0);
+    m0 = _mm256_and_si256(m0, x1);      // abs(p0 - q0) < alpha && abs(p1 - p0) < beta && abs(q1 - q0) < beta
+    if (_mm256_testz_si256(m0, m0))
+        return false;
+
+    x0 = _mm256_sub_epi16(q0, p0);                      // q0 - p0
+    p1 = _mm256_sub_epi16(p1, q1);                      // p1 - q1
+    x0 = _mm256_sub_epi16(x0, m0);                      // (q0 - p0) + 1
+    p1 = _mm256_sub_epi16(p1, m0);                      // (p1 - q1) + 1
+    p1 = _mm256_add_epi16(p1, x0);                      // (p1 - q1) + (q0 - p0) + 2
+    x0 = _mm256_add_epi16(x0, x0);                      // (q0 - p0) * 2 + 2
+    p1 = _mm256_add_epi16(p1, x0);                      // (q0 - p0) * 3 + (p1 - q1) + 4
+    p1 = _mm256_srai_epi16(p1, 3);
+    x1 = _mm256_sign_epi16(tc, m0);                     // -tc
+    p1 = _mm256_min_epi16(p1, tc);
+    p1 = _mm256_max_epi16(p1, x1);                      // delta
+    p1 = _mm256_and_si256(p1, m0);
+    p0 = _mm256_add_epi16(p0, p1);                      // + delta
+    q0 = _mm256_sub_epi16(q0, p1);                      // - delta
+    return true;
+}
+
+//======================================================================================================================
+// 亮度边界, 16 个像素
+
+static void LF_luma_ver_avx2(uint8_t* data, int pitch, int bs, __m256i alpha, __m256i beta, __m256i tc)
+{
+    __m256i col[8];
+    load_transpose_8x16(data - 4, data - 4 + 8 * pitch, pitch, col);
+    bool filtered = (bs == 2) ? LF_luma_bs2(col[2], col[3], col[4], col[5], col[1], col[6], alpha, beta)
+                              : LF_luma_bs1(col[2], col[3], col[4], col[5], col[1], col[6], alpha, beta, tc);
+    if (filtered)
+        store_transpose_4x16(data - 2, data - 2 + 8 * pitch, pitch, col[2], col[3], col[4], col[5]);
+}
+
+static void LF_luma_hor_avx2(uint8_t* data, int pitch, int bs, __m256i alpha, __m256i beta, __m256i tc)
+{
+    __m256i p1 = LOAD_LUMA_16(data - pitch * 2);
+    __m256i p0 = LOAD_LUMA_16(data - pitch);
+    __m256i q0 = LOAD_LUMA_16(data);
+    __m256i q1 = LOAD_LUMA_16(data + pitch);
+    __m256i p2 = LOAD_LUMA_16(data - pitch * 3);
+    __m256i q2 = LOAD_LUMA_16(data + pitch * 2);
+    bool filtered = (bs == 2) ? LF_luma_bs2(p1, p0, q0, q1, p2, q2, alpha, beta)
+                              : LF_luma_bs1(p1, p0, q0, q1, p2, q2, alpha, beta, tc);
+    if (filtered)
+    {
+        store_luma_16(data - pitch * 2, p1);
+        store_luma_16(data - pitch, p0);
+        store_luma_16(data, q0);
+        store_luma_16(data + pitch, q1);
+    }
+}
+
+// 色度边界, Cb 和 Cr 各 8 个像素
+
+static void LF_cbcr_ver_avx2(uint8_t* dstCb, uint8_t* dstCr, int pitch, int bs, __m256i alpha, __m256i beta, __m256i tc)
+{
+    __m256i col[8];
+    load_transpose_8x16(dstCb - 4, dstCr - 4, pitch, col);
+    bool filtered = (bs == 2) ? LF_chroma_bs2(col[3], col[4], col[2], col[5], col[1], col[6], alpha, beta)
+                              : LF_chroma_bs1(col[3], col[4], col[2], col[5], alpha, beta, tc);
+    if (filtered)
+        store_transpose_2x16(dstCb - 1, dstCr - 1, pitch, col[3], col[4]);
+}
+
+static void LF_cbcr_hor_avx2(uint8_t* dstCb, uint8_t* dstCr, int pitch, int bs, __m256i alpha, __m256i beta, __m256i tc)
+{
+    __m256i p1 = LOAD_CBCR_16(dstCb - pitch * 2, dstCr - pitch * 2);
+    __m256i p0 = LOAD_CBCR_16(dstCb - pitch, dstCr - pitch);
+    __m256i q0 = LOAD_CBCR_16(dstCb, dstCr);
+    __m256i q1 = LOAD_CBCR_16(dstCb + pitch, dstCr + pitch);
+    bool filtered;
+    if (bs == 2)
+    {
+        __m256i p2 = LOAD_CBCR_16(dstCb - pitch * 3, dstCr - pitch * 3);
+        __m256i q2 = LOAD_CBCR_16(dstCb + pitch * 2, dstCr + pitch * 2);
+        filtered = LF_chroma_bs2(p0, q0, p1, q1, p2, q2, alpha, beta);
+    }
+    else
+    {
+        filtered = LF_chroma_bs1(p0, q0, p1, q1, alpha, beta, tc);
+    }
+    if (filtered)
+    {
+        store_cbcr_16(dstCb - pitch, dstCr - pitch, p0);
+        store_cbcr_16(dstCb, dstCr, q0);
+    }
+}
+
+#undef LOAD_LUMA_16
+#undef LOAD_CBCR_16
+
+//======================================================================================================================
+// 亮度边界滤波, bs 为边界两段(各 8 个像素)的强度, 每段 2 比特: 0x1/0x4 表示 bs = 1, 0x2/0x8 表示 bs = 2
+template<bool VER>
+static inline void luma_edge(uint8_t* data, int pitch, int qp, int alphaOffset, int betaOffset, uint32_t bs)
+{
+    const int idxA = qp + alphaOffset;
+    const int idxB = qp + betaOffset;
+    if (idxA >= 6 && idxB >= 6)
+    {
+        const __m256i alpha = _mm256_set1_epi16(g_LFAlphaTab[idxA]);
+        const __m256i beta = _mm256_set1_epi16(g_LFBetaTab[idxB]);
+        if (bs & 0xA)
+        {
+            VER ? LF_luma_ver_avx2(data, pitch, 2, alpha, beta, alpha) : LF_luma_hor_avx2(data, pitch, 2, alpha, beta, alpha);
+        }
+        else if (idxA >= 16 && (bs & 0x5))
+        {
+            const int16_t tc = g_LFTcTab[idxA];
+            const __m256i tcs = set2x8_epi16(tc * (bs & 1), tc * ((bs >> 2) & 1));
+            VER ? LF_luma_ver_avx2(data, pitch, 1, alpha, beta, tcs) : LF_luma_hor_avx2(data, pitch, 1, alpha, beta, tcs);
+        }
+    }
+}
+
+// 色度边界滤波, Cb 和 Cr 一起处理, nbQp 为相邻宏块的 qp, qpDelta[2] 为 Cb, Cr 的 qp 偏移
+// bs 定义同亮度, 两段各 4 个像素; 不满足滤波条件的分量 alpha 和 tc 置 0, 使其保持不变
+template<bool VER>
+static inline void cbcr_edge(uint8_t* dstCb, uint8_t* dstCr, int pitch, int nbQp, int curQp, const int qpDelta[2],
+                             int alphaOffset, int betaOffset, uint32_t bs)
+{
+    int16_t alpha[2] = {0, 0};
+    int16_t beta[2] = {0, 0};
+    int16_t tc[2] = {0, 0};
+    bool filtered = false;
+    for (int k = 0; k < 2; k++)
+    {
+        const int qp = g_ChromaQp[(nbQp + curQp + qpDelta[k]) >> 1];
+        const int idxA = qp + alphaOffset;
+        const int idxB = qp + betaOffset;
+        if (idxA >= 6 && idxB >= 6)
+        {
+            alpha[k] = g_LFAlphaTab[idxA];
+            beta[k] = g_LFBetaTab[idxB];
+            tc[k] = (idxA >= 16) ? g_LFTcTab[idxA] : 0;
+            filtered = true;
+        }
+    }
+    if (!filtered)
+        return;
+
+    const __m256i alphas = set2x8_epi16(alpha[0], alpha[1]);
+    const __m256i betas = set2x8_epi16(beta[0], beta[1]);
+    if (bs & 0xA)
+    {
+        VER ? LF_cbcr_ver_avx2(dstCb, dstCr, pitch, 2, alphas, betas, alphas)
+            : LF_cbcr_hor_avx2(dstCb, dstCr, pitch, 2, alphas, betas, alphas);
+    }
+    else if ((bs & 0x5) && (tc[0] | tc[1]))
+    {
+        const int64_t seg0 = (int64_t)(bs & 1) * 0x0001000100010001LL;
+        const int64_t seg1 = (int64_t)((bs >> 2) & 1) * 0x0001000100010001LL;
+        const __m256i tcs = _mm256_setr_epi64x(seg0 * tc[0], seg1 * tc[0], seg0 * tc[1], seg1 * tc[1]);
+        VER ? LF_cbcr_ver_avx2(dstCb, dstCr, pitch, 1, alphas, betas, tcs)
+            : LF_cbcr_hor_avx2(dstCb, dstCr, pitch, 1, alphas, betas, tcs);
+    }
+}
+
+// 一个宏块行的环路滤波, I 帧所有边界 bs = 2
+template<bool INTRA>
+static void loop_filter_avx2(FrmDecContext* ctx, int my)
+{
+    const MbContext* mbCtx = ctx->topMbBuf[(my & 1) ^ 1] + 1;
+    const int mbCnt = ctx->mbColCnt;
+    const int alphaOffset = ctx->picHdr.alpha_c_offset;
+    const int betaOffset = ctx->picHdr.beta_offset;
+    const int qpDelta[2] = {2 * ctx->picHdr.chroma_quant_delta_cb + 1, 2 * ctx->picHdr.chroma_quant_delta_cr + 1};
+    const bool bTopLine = (mbCtx[0].topQp >= 0);
+
+    const int lPitch = ctx->picPitch[0];
+    const int cPitch = ctx->picPitch[1];
+    assert(ctx->picPitch[2] == cPitch);
+    uint8_t* luma = ctx->picPlane[0] + my * lPitch * 16;
+    uint8_t* dstCb = ctx->picPlane[1] + my * cPitch * 8;
+    uint8_t* dstCr = ctx->picPlane[2] + my * cPitch * 8;
+
+    for (int i = 0; i < mbCnt; i++)
+    {
+        const int curQp = mbCtx[i].curQp;
+        const int leftQp = mbCtx[i].leftQp;
+        const int topQp = mbCtx[i].topQp;
+        const uint32_t bs = INTRA ? 0xAAAA : mbCtx[i].lfBS;
+
+        // 亮度: 垂直边界 1, 2, 水平边界 1, 2
+        luma_edge<true>(luma, lPitch, (leftQp + curQp + 1) >> 1, alphaOffset, betaOffset, bs);
+        luma_edge<true>(luma + 8, lPitch, curQp, alphaOffset, betaOffset, bs >> 4);
+        luma_edge<false>(luma, lPitch, (topQp + curQp + 1) >> 1, alphaOffset, betaOffset, bs >> 8);
+        luma_edge<false>(luma + 8 * lPitch, lPitch, curQp, alphaOffset, betaOffset, bs >> 12);
+
+        // 色度: 垂直边界, 水平边界
+        if (i > 0)
+            cbcr_edge<true>(dstCb, dstCr, cPitch, leftQp, curQp, qpDelta, alphaOffset, betaOffset, bs);
+        if (bTopLine)
+            cbcr_edge<false>(dstCb, dstCr, cPitch, topQp, curQp, qpDelta, alphaOffset, betaOffset, bs >> 8);
+
+        luma += 16;
+        dstCb += 8;
+        dstCr += 8;
+    }
+}
+
+// 针对 I 帧
+void loop_filterI_avx2(FrmDecContext* ctx, int my)
+{
+    loop_filter_avx2<true>(ctx, my);
+}
+
+// 针对 P 帧和 B 帧
+void loop_filterPB_avx2(FrmDecContext* ctx, int my)
+{
+    loop_filter_avx2<false>(ctx, my);
+}
+
+}   // namespace irk_avs_dec
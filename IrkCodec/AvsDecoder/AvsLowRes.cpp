@@ -0,0 +1,464 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+#include <algorithm>
+#include "AvsDecoder.h"
+
+/*
+* 低分辨率解码, 宏块直接以 1/2 或 1/4 宽高重建, RS 为缩小倍数的 log2
+* 熵解码和运动矢量仍按原始分辨率进行, 像素处理函数的参数与原始分辨率相同, 由函数内部换算
+* 参考帧本身也是缩小后的图像, 帧间预测存在误差累积(漂移), 直到下一个 I 帧
+*/
+
+namespace irk_avs_dec {
+
+//======================================================================================================================
+// 帧内预测, N x N 块, N = 8 >> RS, 与 8x8 块的预测方法相同
+
+// 垂直预测
+template<int RS>
+static void intra_pred_ver_lr(uint8_t* dst, int pitch, NBUsable)
+{
+    const int N = 8 >> RS;
+    const uint8_t* top = dst - pitch;
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+            dst[x] = top[x];
+        dst += pitch;
+    }
+}
+
+// 水平预测
+template<int RS>
+static void intra_pred_hor_lr(uint8_t* dst, int pitch, NBUsable)
+{
+    const int N = 8 >> RS;
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+            dst[x] = dst[-1];
+        dst += pitch;
+    }
+}
+
+// 对边界像素做 [1 2 1] 滤波, edge[-1] 和 edge[N] 为两端扩展的像素
+template<int N>
+static inline void filter_edge_lr(const int* edge, int* result)
+{
+    for (int i = 0; i < N; i++)
+        result[i] = (edge[i - 1] + edge[i] * 2 + edge[i + 1] + 2) >> 2;
+}
+
+// DC 预测
+template<int RS>
+static void intra_pred_dc_lr(uint8_t* dst, int pitch, NBUsable usable)
+{
+    const int N = 8 >> RS;
+    const int8_t* flags = usable.flags;
+    const uint8_t* top = dst - pitch;
+    const uint8_t* left = dst - 1;
+    int edge[N + 2];
+    int topf[N];
+    int leftf[N];
+
+    if (flags[0])   // 上边界可用
+    {
+        edge[0] = flags[2] ? top[-1] : top[0];
+        for (int i = 0; i < N; i++)
+            edge[i + 1] = top[i];
+        edge[N + 1] = top[N - 1 + flags[1]];
+        filter_edge_lr<N>(edge + 1, topf);
+    }
+    if (flags[2])   // 左边界可用
+    {
+        edge[0] = flags[0] ? top[-1] : left[0];
+        for (int i = 0; i < N; i++)
+            edge[i + 1] = left[pitch * i];
+        edge[N + 1] = left[pitch * (N - 1 + flags[3])];
+        filter_edge_lr<N>(edge + 1, leftf);
+    }
+
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+        {
+            if (flags[0] & flags[2])
+                dst[x] = (uint8_t)((topf[x] + leftf[y]) >> 1);
+            else if (flags[0])
+                dst[x] = (uint8_t)topf[x];
+            else if (flags[2])
+                dst[x] = (uint8_t)leftf[y];
+            else
+                dst[x] = 128;
+        }
+        dst += pitch;
+    }
+}
+
+// down-left 预测
+template<int RS>
+static void intra_pred_downleft_lr(uint8_t* dst, int pitch, NBUsable usable)
+{
+    const int N = 8 >> RS;
+    const uint8_t* top = dst - pitch;
+    const uint8_t* left = dst - 1;
+    int edge[N * 2 + 1];
+    int topf[N * 2 - 1];
+    int leftf[N * 2 - 1];
+
+    // 右上和左下的块不可用时, 使用最后一个像素扩展
+    for (int i = 0; i < N * 2; i++)
+        edge[i] = top[(i < N || usable.flags[1]) ? i : N - 1];
+    edge[N * 2] = edge[N * 2 - 1];
+    filter_edge_lr<N * 2 - 1>(edge + 1, topf);
+    for (int i = 0; i < N * 2; i++)
+        edge[i] = left[pitch * ((i < N || usable.flags[3]) ? i : N - 1)];
+    edge[N * 2] = edge[N * 2 - 1];
+    filter_edge_lr<N * 2 - 1>(edge + 1, leftf);
+
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+            dst[x] = (uint8_t)((topf[x + y] + leftf[x + y]) >> 1);
+        dst += pitch;
+    }
+}
+
+// down-right 预测
+template<int RS>
+static void intra_pred_downright_lr(uint8_t* dst, int pitch, NBUsable)
+{
+    const int N = 8 >> RS;
+    const uint8_t* top = dst - pitch;
+    const uint8_t* left = dst - 1;
+    int edge[N * 2 + 1];
+    int filtered[N * 2 - 1];
+
+    // 依次为左边界(从下到上), 左上角, 上边界
+    for (int i = 0; i < N; i++)
+        edge[i] = left[pitch * (N - 1 - i)];
+    edge[N] = top[-1];
+    for (int i = 0; i < N; i++)
+        edge[N + 1 + i] = top[i];
+    filter_edge_lr<N * 2 - 1>(edge + 1, filtered);
+
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+            dst[x] = (uint8_t)filtered[N - 1 - y + x];
+        dst += pitch;
+    }
+}
+
+// 色差分量 plane 预测, 梯度按块大小换算, 使其与 8x8 块的 (ih * 17 + 16) >> 5 一致
+template<int RS>
+static void intra_pred_plane_lr(uint8_t* dst, int pitch, NBUsable)
+{
+    const int N = 8 >> RS;
+    const int C = N / 2 - 1;
+    const int K = (RS == 0) ? 17 : ((RS == 1) ? 102 : 512);
+    const uint8_t* top = dst - pitch;
+    const uint8_t* left = dst - 1;
+
+    int ih = 0;
+    int iv = 0;
+    for (int i = 1; i <= N / 2; i++)
+    {
+        ih += i * (top[C + i] - top[C - i]);
+        iv += i * (left[pitch * (C + i)] - left[pitch * (C - i)]);
+    }
+    const int ia = ((top[N - 1] + left[pitch * (N - 1)]) << 4) + 16;
+    const int ib = (ih * K + 16) >> 5;
+    const int ic = (iv * K + 16) >> 5;
+
+    for (int y = 0; y < N; y++)
+    {
+        for (int x = 0; x < N; x++)
+            dst[x] = (uint8_t)clip3((ia + (x - C) * ib + (y - C) * ic) >> 5, 0, 255);
+        dst += pitch;
+    }
+}
+
+//======================================================================================================================
+// 反变换, 8x8 系数直接变换为 N x N 像素, 每个像素为原始分辨率下对应 2^RS x 2^RS 像素的平均值
+
+// 转置矩阵, 与 AvsIdct.cpp 相同
+static const int16_t s_TMatrixLR[64] =
+{
+    8,  10,  10,   9,   8,   6,   4,   2,
+    8,   9,   4,  -2,  -8, -10, -10,  -6,
+    8,   6,  -4, -10,  -8,   2,  10,   9,
+    8,   2, -10,  -6,   8,   9,  -4, -10,
+    8,  -2, -10,   6,   8,  -9,  -4,  10,
+    8,  -6,  -4,  10,  -8,  -2,  10,  -9,
+    8,  -9,   4,   2,  -8,  10, -10,   6,
+    8, -10,  10,  -9,   8,  -6,   4,  -2,
+};
+
+// 缩小后的变换矩阵, 每行为转置矩阵相邻 2^RS 行之和
+template<int RS>
+struct ScaledTMatrix
+{
+    int16_t m[(8 >> RS) * 8];
+
+    ScaledTMatrix()
+    {
+        for (int i = 0; i < (8 >> RS); i++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                int sum = 0;
+                for (int j = 0; j < (1 << RS); j++)
+                    sum += s_TMatrixLR[((i << RS) + j) * 8 + k];
+                m[i * 8 + k] = (int16_t)sum;
+            }
+        }
+    }
+};
+
+static const ScaledTMatrix<1> s_TMatrixHalf;
+static const ScaledTMatrix<2> s_TMatrixQuarter;
+
+// src: 列主序存储的 DCT 系数, 非零系数都在左上角 K x K 内, 只读取其中的系数
+template<int RS, int K>
+static void IDCT_8x8_add_lr(const int16_t src[64], uint8_t* dst, int dstPitch)
+{
+    const int N = 8 >> RS;
+    const int16_t* tm = (RS == 1) ? s_TMatrixHalf.m : s_TMatrixQuarter.m;
+    int16_t temp[8 * N];
+
+    // 列变换, 只计算缩小后的 N 列, 输出为列序
+    for (int j = 0; j < N; j++)
+    {
+        const int16_t* tmCol = tm + 8 * j;
+        for (int i = 0; i < K; i++)
+        {
+            int sum = 0;
+            for (int k = 0; k < K; k++)
+                sum += src[i + 8 * k] * tmCol[k];
+            temp[i + j * 8] = (int16_t)clip3((sum + (4 << RS)) >> (3 + RS), -32768, 32767);
+        }
+    }
+
+    // 行变换, 只计算缩小后的 N 行
+    for (int i = 0; i < N; i++)
+    {
+        uint8_t* dstRow = dst + dstPitch * i;
+        const int16_t* tmRow = tm + 8 * i;
+        for (int j = 0; j < N; j++)
+        {
+            int sum = 0;
+            for (int k = 0; k < K; k++)
+                sum += tmRow[k] * temp[8 * j + k];
+            sum = clip3((sum + (64 << RS)) >> (7 + RS), -32768, 32767);
+            dstRow[j] = (uint8_t)clip3(dstRow[j] + sum, 0, 255);
+        }
+    }
+}
+
+// 水平相邻的两个 8x8 块, 系数依次存放
+template<int RS>
+static void IDCT_16x8_add_lr(const int16_t src[128], uint8_t* dst, int dstPitch)
+{
+    IDCT_8x8_add_lr<RS, 8>(src, dst, dstPitch);
+    IDCT_8x8_add_lr<RS, 8>(src + 64, dst + (8 >> RS), dstPitch);
+}
+
+//======================================================================================================================
+// 帧间预测, 在缩小后的参考帧上做双线性插值
+// 参考坐标直接限制在图像范围内, 不需要参考帧的边界填充
+
+// 双线性插值, 输出 width x height 块, (x, y) 为 1/(2^FRAC) 像素精度的坐标
+template<int FRAC>
+static void MC_bilinear_lr(const uint8_t* ref, int refPitch, int picWidth, int picHeight,
+                           uint8_t* dst, int dstPitch, int width, int height, int x, int y)
+{
+    const int S = 1 << FRAC;
+    const int dx = x & (S - 1);
+    const int dy = y & (S - 1);
+    const int xInt = x >> FRAC;
+    const int yInt = y >> FRAC;
+    const int w00 = (S - dx) * (S - dy);
+    const int w01 = dx * (S - dy);
+    const int w10 = (S - dx) * dy;
+    const int w11 = dx * dy;
+
+    int xPos[2][16];
+    for (int j = 0; j < width; j++)
+    {
+        xPos[0][j] = clip3(xInt + j, 0, picWidth - 1);
+        xPos[1][j] = clip3(xInt + j + 1, 0, picWidth - 1);
+    }
+
+    for (int i = 0; i < height; i++)
+    {
+        const uint8_t* row0 = ref + clip3(yInt + i, 0, picHeight - 1) * refPitch;
+        const uint8_t* row1 = ref + clip3(yInt + i + 1, 0, picHeight - 1) * refPitch;
+        for (int j = 0; j < width; j++)
+        {
+            int sum = row0[xPos[0][j]] * w00 + row0[xPos[1][j]] * w01 + row1[xPos[0][j]] * w10 + row1[xPos[1][j]] * w11;
+            dst[j] = (uint8_t)((sum + S * S / 2) >> (FRAC * 2));
+        }
+        dst += dstPitch;
+    }
+}
+
+// 亮度分量, W x H 为原始分辨率下的块大小, (x, y) 为 1/4 像素精度的原始分辨率坐标
+template<int RS, int W, int H>
+static void luma_inter_pred_lr(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch, int x, int y)
+{
+    const int picWidth = ctx->picWidth >> RS;
+    const int picHeight = ctx->picHeight >> RS;
+
+    // 检查参考帧数据是否已解码, 未可用则等待, 需要的行数换算为原始分辨率
+    const int lastRow = std::min((y >> (2 + RS)) + (H >> RS), picHeight - 1);
+    check_ref_data(ctx, refpic->pframe, (lastRow + 1) << RS);
+
+    MC_bilinear_lr<2 + RS>(refpic->plane[0], ctx->picPitch[0], picWidth, picHeight,
+                           dst, dstPitch, W >> RS, H >> RS, x, y);
+}
+
+// 色差分量, W x H 为原始分辨率下的块大小, (x, y) 为 1/8 像素精度的原始分辨率坐标
+template<int RS, int W, int H>
+static void chroma_inter_pred_lr(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    const int picWidth = ctx->chromaWidth >> RS;
+    const int picHeight = ctx->chromaHeight >> RS;
+
+    const int lastRow = std::min((y >> (3 + RS)) + (H >> RS), picHeight - 1);
+    check_ref_data(ctx, refpic->pframe, (lastRow + 1) << (RS + 1));
+
+    MC_bilinear_lr<3 + RS>(refpic->plane[1], ctx->picPitch[1], picWidth, picHeight,
+                           dstCb, dstPitch, W >> RS, H >> RS, x, y);
+    MC_bilinear_lr<3 + RS>(refpic->plane[2], ctx->picPitch[2], picWidth, picHeight,
+                           dstCr, dstPitch, W >> RS, H >> RS, x, y);
+}
+
+// 加权预测, W x N 为原始分辨率下的块大小
+template<int RS, int W>
+static void weight_pred_lr(uint8_t* dst, int pitch, int scale, int delta, int N)
+{
+    for (int i = 0; i < (N >> RS); i++)
+    {
+        for (int j = 0; j < (W >> RS); j++)
+            dst[j] = (uint8_t)clip3(((dst[j] * scale + 16) >> 5) + delta, 0, 255);
+        dst += pitch;
+    }
+}
+
+// 取平均, W x N 为原始分辨率下的块大小
+template<int RS, int W>
+static void MC_avg_lr(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int N)
+{
+    for (int i = 0; i < (N >> RS); i++)
+    {
+        for (int j = 0; j < (W >> RS); j++)
+            dst[j] = (uint8_t)((src[j] + dst[j] + 1) >> 1);
+        src += srcPitch;
+        dst += dstPitch;
+    }
+}
+
+// 帧间预测同时加权及取平均, 取平均时先预测到临时缓存
+template<int RS, int W, int H>
+static void luma_inter_pred_blend_lr(FrmDecContext* ctx, const RefPicture* refpic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    if (blend->mode & MC_BLEND_AVG)
+    {
+        luma_inter_pred_lr<RS, W, H>(ctx, refpic, ctx->mcBuff, 16, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+            weight_pred_lr<RS, W>(ctx->mcBuff, 16, blend->scale, blend->delta, H);
+        MC_avg_lr<RS, W>(ctx->mcBuff, 16, dst, dstPitch, H);
+    }
+    else
+    {
+        luma_inter_pred_lr<RS, W, H>(ctx, refpic, dst, dstPitch, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+            weight_pred_lr<RS, W>(dst, dstPitch, blend->scale, blend->delta, H);
+    }
+}
+
+template<int RS, int W, int H>
+static void chroma_inter_pred_blend_lr(FrmDecContext* ctx, const RefPicture* refpic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    if (blend->mode & MC_BLEND_AVG)
+    {
+        uint8_t* mcBuf[2] = {ctx->mcBuff, ctx->mcBuff + 256};
+        chroma_inter_pred_lr<RS, W, H>(ctx, refpic, mcBuf[0], mcBuf[1], 16, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+        {
+            weight_pred_lr<RS, W>(mcBuf[0], 16, blend->scale, blend->delta, H);
+            weight_pred_lr<RS, W>(mcBuf[1], 16, blend->scale, blend->delta, H);
+        }
+        MC_avg_lr<RS, W>(mcBuf[0], 16, dstCb, dstPitch, H);
+        MC_avg_lr<RS, W>(mcBuf[1], 16, dstCr, dstPitch, H);
+    }
+    else
+    {
+        chroma_inter_pred_lr<RS, W, H>(ctx, refpic, dstCb, dstCr, dstPitch, x, y);
+        if (blend->mode & MC_BLEND_WEIGHT)
+        {
+            weight_pred_lr<RS, W>(dstCb, dstPitch, blend->scale, blend->delta, H);
+            weight_pred_lr<RS, W>(dstCr, dstPitch, blend->scale, blend->delta, H);
+        }
+    }
+}
+
+// 低分辨率解码时块边界与原始分辨率不对应, 不做环路滤波
+static void loop_filter_none(FrmDecContext*, int)
+{
+}
+
+//======================================================================================================================
+
+#define LOW_RES_KERNELS(RS)                                                                         \
+{                                                                                                   \
+    {                                                                                               \
+        &intra_pred_ver_lr<RS>, &intra_pred_hor_lr<RS>, &intra_pred_dc_lr<RS>,                      \
+        &intra_pred_downleft_lr<RS>, &intra_pred_downright_lr<RS>,                                  \
+    },                                                                                              \
+    {                                                                                               \
+        &intra_pred_dc_lr<RS>, &intra_pred_hor_lr<RS>, &intra_pred_ver_lr<RS>, &intra_pred_plane_lr<RS>, \
+    },                                                                                              \
+    &luma_inter_pred_lr<RS, 16, 16>,                                                                \
+    &luma_inter_pred_lr<RS, 16, 8>,                                                                 \
+    &luma_inter_pred_lr<RS, 8, 16>,                                                                 \
+    &luma_inter_pred_lr<RS, 8, 8>,                                                                  \
+    &chroma_inter_pred_lr<RS, 8, 8>,                                                                \
+    &chroma_inter_pred_lr<RS, 8, 4>,                                                                \
+    &chroma_inter_pred_lr<RS, 4, 8>,                                                                \
+    &chroma_inter_pred_lr<RS, 4, 4>,                                                                \
+    &luma_inter_pred_blend_lr<RS, 16, 16>,                                                          \
+    &luma_inter_pred_blend_lr<RS, 16, 8>,                                                           \
+    &luma_inter_pred_blend_lr<RS, 8, 16>,                                                           \
+    &luma_inter_pred_blend_lr<RS, 8, 8>,                                                            \
+    &chroma_inter_pred_blend_lr<RS, 8, 8>,                                                          \
+    &chroma_inter_pred_blend_lr<RS, 8, 4>,                                                          \
+    &chroma_inter_pred_blend_lr<RS, 4, 8>,                                                          \
+    &chroma_inter_pred_blend_lr<RS, 4, 4>,                                                          \
+    &IDCT_8x8_add_lr<RS, 8>,                                                                        \
+    &IDCT_8x8_add_lr<RS, 1>,                                                                        \
+    &IDCT_8x8_add_lr<RS, 4>,                                                                        \
+    &IDCT_16x8_add_lr<RS>,                                                                          \
+    &loop_filter_none,                                                                              \
+    &loop_filter_none,                                                                              \
+}
+
+const DecKernels g_HalfResKernels = LOW_RES_KERNELS(1);
+const DecKernels g_QuarterResKernels = LOW_RES_KERNELS(2);
+
+}   // namespace irk_avs_dec
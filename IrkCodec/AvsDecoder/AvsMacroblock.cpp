@@ -15,9 +15,6 @@
 
 namespace irk_avs_dec {
 
-extern void IDCT_8x8_add_sse4(const int16_t src[64], uint8_t* dst, int dstPitch);
-extern void IDCT_8x8_add_c(const int16_t src[64], uint8_t* dst, int dstPitch);
-
 // 标准表 42
 const uint8_t s_CBPTab[64][2] =
 {
@@ -31,6 +28,54 @@ const uint8_t s_CBPTab[64][2] =
     {34, 50}, {50, 56}, {52, 25}, {54, 22}, {41, 54}, {56, 57}, {38, 41}, {57, 38},
 };
 
+// 宏块在当前图像中的位置, 低分辨率解码时宏块按比例缩小
+static inline uint8_t* luma_mb_pos(const FrmDecContext* ctx, int mx, int my)
+{
+    return ctx->picPlane[0] + ((my * ctx->picPitch[0] + mx) << (4 - ctx->resShift));
+}
+
+static inline uint8_t* cbcr_mb_pos(const FrmDecContext* ctx, int plane, int mx, int my)
+{
+    return ctx->picPlane[plane] + ((my * ctx->picPitch[plane] + mx) << (3 - ctx->resShift));
+}
+
+// 加权预测及双向预测取平均的参数, blend[0] 用于亮度分量, blend[1] 用于色差分量
+static inline void get_mc_blend(const FrmDecContext* ctx, int refIdx, int mode, McBlend blend[2])
+{
+    blend[0].mode = mode;
+    blend[0].scale = ctx->lumaScale[refIdx];
+    blend[0].delta = ctx->lumaDelta[refIdx];
+    blend[1].mode = mode;
+    blend[1].scale = ctx->cbcrScale[refIdx];
+    blend[1].delta = ctx->cbcrDelta[refIdx];
+}
+
+// 根据非零系数的分布选择反变换函数, 系数全为 0 时不需要反变换
+static inline void idct_8x8_add(const DecKernels* kernels, int shape, const int16_t* coeff, uint8_t* dst, int pitch)
+{
+    if (shape == COEFF_8x8)
+        (*kernels->pfnIdct8x8Add)(coeff, dst, pitch);
+    else if (shape == COEFF_4x4)
+        (*kernels->pfnIdct8x8Add4x4)(coeff, dst, pitch);
+    else if (shape == COEFF_DC)
+        (*kernels->pfnIdct8x8AddDC)(coeff, dst, pitch);
+}
+
+// 水平相邻的两个 8x8 块, 系数依次存放在 coeff 中, 都需要完整的反变换时一起处理
+static inline void idct_16x8_add(const DecKernels* kernels, int shape0, int shape1, const int16_t* coeff,
+                                 uint8_t* dst, int pitch, int blkSize)
+{
+    if (shape0 == COEFF_8x8 && shape1 == COEFF_8x8)
+    {
+        (*kernels->pfnIdct16x8Add)(coeff, dst, pitch);
+    }
+    else
+    {
+        idct_8x8_add(kernels, shape0, coeff, dst, pitch);
+        idct_8x8_add(kernels, shape1, coeff + 64, dst + blkSize, pitch);
+    }
+}
+
 // 帧内预测宏块解码
 void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
 {
@@ -139,12 +184,13 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
         }
     }
 
-    AvsContext* avsCtx = ctx->avsCtx;
+    const DecKernels* kernels = ctx->kernels;
     AvsVlcParser* parser = ctx->vlcParser;
     const int dqScale = g_DequantScale[ctx->curQp];
     const int dqShift = g_DequantShift[ctx->curQp];
     const int lPitch = ctx->picPitch[0];
-    uint8_t* luma = ctx->picPlane[0] + (my * lPitch + mx) * 16;
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    uint8_t* luma = luma_mb_pos(ctx, mx, my);
     int16_t* coeff = ctx->coeff;    // 存储 DCT 系数的临时内存
     NBUsable usable;
 
@@ -153,16 +199,17 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = topMb[0].avail;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = leftMb[0].avail;
-    (*avsCtx->pfnLumaIPred[lumaPred[0]])(luma, lPitch, usable);   // 帧内预测
+    (*kernels->pfnLumaIPred[lumaPred[0]])(luma, lPitch, usable);   // 帧内预测
     if (cbpFlags & 0x1)
     {
-        if (!parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift))
+        const int shape = parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma, lPitch);
     }
 
     // decode luma block 1
@@ -170,34 +217,36 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = topMb[1].avail;
     usable.flags[2] = 1;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[1]])(luma + 8, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[1]])(luma + lBlk, lPitch, usable);
     if (cbpFlags & 0x2)
     {
-        if (!parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift))
+        const int shape = parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma + lBlk, lPitch);
     }
 
     // decode luma block 2
-    luma += 8 * lPitch;
+    luma += lBlk * lPitch;
     usable.flags[0] = 1;
     usable.flags[1] = 1;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[2]])(luma, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[2]])(luma, lPitch, usable);
     if (cbpFlags & 0x4)
     {
-        if (!parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift))
+        const int shape = parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma, lPitch);
     }
 
     // decode luma block 3
@@ -205,26 +254,27 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = 0;
     usable.flags[2] = 1;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[3]])(luma + 8, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[3]])(luma + lBlk, lPitch, usable);
     if (cbpFlags & 0x8)
     {
-        if (!parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift))
+        const int shape = parser->dec_intra_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma + lBlk, lPitch);
     }
 
     // decode Cb block
     const int cPitch = ctx->picPitch[1];
-    uint8_t* dstCb = ctx->picPlane[1] + (my * cPitch + mx) * 8;
+    uint8_t* dstCb = cbcr_mb_pos(ctx, 1, mx, my);
     usable.flags[0] = topMb[0].avail;
     usable.flags[1] = topMb[1].avail;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = 0;
-    (*avsCtx->pfnCbCrIPred[chromaPred])(dstCb, cPitch, usable);   // 帧内预测
+    (*kernels->pfnCbCrIPred[chromaPred])(dstCb, cPitch, usable);   // 帧内预测
     if (cbpFlags & 0x10)
     {
         int qp = ctx->curQp + ctx->picHdr.chroma_quant_delta_cb;
@@ -235,18 +285,19 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
         }
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, dstCb, cPitch);
+        idct_8x8_add(kernels, shape, coeff, dstCb, cPitch);
     }
 
     // decode Cr block
-    uint8_t* dstCr = ctx->picPlane[2] + (my * cPitch + mx) * 8;
-    (*avsCtx->pfnCbCrIPred[chromaPred])(dstCr, cPitch, usable);   // 帧内预测
+    uint8_t* dstCr = cbcr_mb_pos(ctx, 2, mx, my);
+    (*kernels->pfnCbCrIPred[chromaPred])(dstCr, cPitch, usable);   // 帧内预测
     if (cbpFlags & 0x20)
     {
         int qp = ctx->curQp + ctx->picHdr.chroma_quant_delta_cr;
@@ -257,13 +308,14 @@ void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my)
         }
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, dstCr, cPitch);
+        idct_8x8_add(kernels, shape, coeff, dstCr, cPitch);
     }
 
     // 当前宏块可供右侧和下一行宏块使用
@@ -314,40 +366,49 @@ static bool dec_mb_residual(FrmDecContext* ctx, int mx, int my, uint32_t cbpFlag
     const int dqScale = g_DequantScale[ctx->curQp];
     const int dqShift = g_DequantShift[ctx->curQp];
     const int lPitch = ctx->picPitch[0];
-    uint8_t* luma = ctx->picPlane[0] + (my * lPitch + mx) * 16;
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    uint8_t* luma = luma_mb_pos(ctx, mx, my);
 
-    // decode Luma block 0 
+    // decode Luma block 0, 1, 水平相邻的两个块解析完成后一起反变换
+    int shape0 = COEFF_ZERO;
+    int shape1 = COEFF_ZERO;
     if (cbpFlags & 0x1)
     {
-        if (!parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift))
+        shape0 = parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape0 == COEFF_ERROR)
             return false;
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
     }
-
-    // decode Luma block 1
     if (cbpFlags & 0x2)
     {
-        if (!parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift))
+        shape1 = parser->dec_inter_coeff_block(coeff + 64, bitsm, dqScale, dqShift);
+        if (shape1 == COEFF_ERROR)
+        {
+            idct_8x8_add(ctx->kernels, shape0, coeff, luma, lPitch);   // 与逐块处理一致, 出错前已解析的块仍然叠加
             return false;
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        }
     }
+    idct_16x8_add(ctx->kernels, shape0, shape1, coeff, luma, lPitch, lBlk);
 
-    // decode Luma block 2
-    luma += 8 * lPitch;
+    // decode Luma block 2, 3
+    luma += lBlk * lPitch;
+    shape0 = COEFF_ZERO;
+    shape1 = COEFF_ZERO;
     if (cbpFlags & 0x4)
     {
-        if (!parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift))
+        shape0 = parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift);
+        if (shape0 == COEFF_ERROR)
             return false;
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
     }
-
-    // decode Luma block 3
     if (cbpFlags & 0x8)
     {
-        if (!parser->dec_inter_coeff_block(coeff, bitsm, dqScale, dqShift))
+        shape1 = parser->dec_inter_coeff_block(coeff + 64, bitsm, dqScale, dqShift);
+        if (shape1 == COEFF_ERROR)
+        {
+            idct_8x8_add(ctx->kernels, shape0, coeff, luma, lPitch);   // 与逐块处理一致, 出错前已解析的块仍然叠加
             return false;
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        }
     }
+    idct_16x8_add(ctx->kernels, shape0, shape1, coeff, luma, lPitch, lBlk);
 
     // decode Cb block
     if (cbpFlags & 0x10)
@@ -357,12 +418,13 @@ static bool dec_mb_residual(FrmDecContext* ctx, int mx, int my, uint32_t cbpFlag
             return false;
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
             return false;
 
         const int cPitch = ctx->picPitch[1];
-        uint8_t* dstCb = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-        IDCT_8x8_add_sse4(coeff, dstCb, cPitch);
+        uint8_t* dstCb = cbcr_mb_pos(ctx, 1, mx, my);
+        idct_8x8_add(ctx->kernels, shape, coeff, dstCb, cPitch);
     }
 
     // decode Cr block
@@ -373,12 +435,13 @@ static bool dec_mb_residual(FrmDecContext* ctx, int mx, int my, uint32_t cbpFlag
             return false;
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_chroma_coeff_block(coeff, bitsm, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
             return false;
 
         const int cPitch = ctx->picPitch[2];
-        uint8_t* dstCr = ctx->picPlane[2] + (my * cPitch + mx) * 8;
-        IDCT_8x8_add_sse4(coeff, dstCr, cPitch);
+        uint8_t* dstCr = cbcr_mb_pos(ctx, 2, mx, my);
+        idct_8x8_add(ctx->kernels, shape, coeff, dstCr, cPitch);
     }
 
     return true;
@@ -419,19 +482,23 @@ static void MC_macroblock_P16x16(FrmDecContext* ctx, int mx, int my, int refIdx,
     const int lPitch = ctx->picPitch[0];
     const int cPitch = ctx->picPitch[1];
     uint8_t* mbPos[3];
-    mbPos[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    mbPos[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    mbPos[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    mbPos[0] = luma_mb_pos(ctx, mx, my);
+    mbPos[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    mbPos[2] = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMv.x;
     int y = (my << 6) + curMv.y;
     const RefPicture* refPic = ctx->refPics + refIdx;
-    luma_inter_pred_16x16(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_8x8(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)        // 加权预测
     {
-        weight_pred_16xN(mbPos[0], lPitch, ctx->lumaScale[refIdx], ctx->lumaDelta[refIdx], 16);
-        weight_pred_8xN(mbPos[1], cPitch, ctx->cbcrScale[refIdx], ctx->cbcrDelta[refIdx], 8);
-        weight_pred_8xN(mbPos[2], cPitch, ctx->cbcrScale[refIdx], ctx->cbcrDelta[refIdx], 8);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdx, MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x16)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC16x16)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     // 设置环路滤波相关参数
@@ -506,22 +573,27 @@ static void MC_macroblock_P16x8(FrmDecContext* ctx, int mx, int my, const int8_t
 
     // 帧间预测   
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     uint8_t* mbPos[3];
-    mbPos[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    mbPos[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    mbPos[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    mbPos[0] = luma_mb_pos(ctx, mx, my);
+    mbPos[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    mbPos[2] = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMvs[0].x;
     int y = (my << 6) + curMvs[0].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[0];
-    luma_inter_pred_16x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_8x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)    // 加权预测
     {
-        int k = refIdxs[0];
-        weight_pred_16xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_8xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_8xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[0], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC16x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     //------------------------------------------------------
@@ -549,20 +621,23 @@ static void MC_macroblock_P16x8(FrmDecContext* ctx, int mx, int my, const int8_t
     curMvs[1].y += mvDiff[1][1];
 
     // 帧间预测   
-    mbPos[0] += 8 * lPitch;
-    mbPos[1] += 4 * cPitch;
-    mbPos[2] += 4 * cPitch;
+    mbPos[0] += lBlk * lPitch;
+    mbPos[1] += cBlk * cPitch;
+    mbPos[2] += cBlk * cPitch;
     x = (mx << 6) + curMvs[1].x;
     y = (my << 6) + 32 + curMvs[1].y;
     refPic = ctx->refPics + refIdxs[1];
-    luma_inter_pred_16x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_8x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[1];
-        weight_pred_16xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_8xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_8xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC16x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     // 设置环路滤波相关参数
@@ -630,22 +705,27 @@ static void MC_macroblock_P8x16(FrmDecContext* ctx, int mx, int my, const int8_t
 
     // 帧间预测   
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     uint8_t* mbPos[3];
-    mbPos[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    mbPos[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    mbPos[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    mbPos[0] = luma_mb_pos(ctx, mx, my);
+    mbPos[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    mbPos[2] = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMvs[0].x;
     int y = (my << 6) + curMvs[0].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[0];
-    luma_inter_pred_8x16(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_4x8(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[0];
-        weight_pred_8xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-        weight_pred_4xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        weight_pred_4xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[0], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x16)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x16)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     //---------------------------------------------------------
@@ -700,14 +780,17 @@ static void MC_macroblock_P8x16(FrmDecContext* ctx, int mx, int my, const int8_t
     x = (mx << 6) + 32 + curMvs[1].x;
     y = (my << 6) + curMvs[1].y;
     refPic = ctx->refPics + refIdxs[1];
-    luma_inter_pred_8x16(ctx, refPic, mbPos[0] + 8, lPitch, x, y);
-    chroma_inter_pred_4x8(ctx, refPic, mbPos[1] + 4, mbPos[2] + 4, cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[1];
-        weight_pred_8xN(mbPos[0] + 8, lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-        weight_pred_4xN(mbPos[1] + 4, cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        weight_pred_4xN(mbPos[2] + 4, cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x16)(ctx, refPic, mbPos[0] + lBlk, lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x8)(ctx, refPic, mbPos[1] + cBlk, mbPos[2] + cBlk, cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x16)(ctx, refPic, mbPos[0] + lBlk, lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x8)(ctx, refPic, mbPos[1] + cBlk, mbPos[2] + cBlk, cPitch, x, y);
     }
 
     // 设置环路滤波相关参数
@@ -768,22 +851,27 @@ static void MC_macroblock_P8x8(FrmDecContext* ctx, int mx, int my, const int8_t
 
     // 帧间预测
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     uint8_t* mbPos[3];
-    mbPos[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    mbPos[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    mbPos[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    mbPos[0] = luma_mb_pos(ctx, mx, my);
+    mbPos[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    mbPos[2] = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMvs[0].x;
     int y = (my << 6) + curMvs[0].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[0];
-    luma_inter_pred_8x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[0];
-        weight_pred_8xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[0], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     //------------------ block 1 ---------------------
@@ -809,20 +897,23 @@ static void MC_macroblock_P8x8(FrmDecContext* ctx, int mx, int my, const int8_t
     curMvs[1].y += mvDiff[1][1];
 
     // 帧间预测
-    mbPos[0] += 8;
-    mbPos[1] += 4;
-    mbPos[2] += 4;
+    mbPos[0] += lBlk;
+    mbPos[1] += cBlk;
+    mbPos[2] += cBlk;
     x = (mx << 6) + 32 + curMvs[1].x;
     y = (my << 6) + curMvs[1].y;
     refPic = ctx->refPics + refIdxs[1];
-    luma_inter_pred_8x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[1];
-        weight_pred_8xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     //------------------ block 2 ---------------------
@@ -840,20 +931,23 @@ static void MC_macroblock_P8x8(FrmDecContext* ctx, int mx, int my, const int8_t
     curMvs[2].y += mvDiff[2][1];
 
     // 帧间预测
-    mbPos[0] += 8 * lPitch - 8;
-    mbPos[1] += 4 * cPitch - 4;
-    mbPos[2] += 4 * cPitch - 4;
+    mbPos[0] += lBlk * lPitch - lBlk;
+    mbPos[1] += cBlk * cPitch - cBlk;
+    mbPos[2] += cBlk * cPitch - cBlk;
     x = (mx << 6) + curMvs[2].x;
     y = (my << 6) + 32 + curMvs[2].y;
     refPic = ctx->refPics + refIdxs[2];
-    luma_inter_pred_8x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[2];
-        weight_pred_8xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[2], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     //------------------ block 3 ---------------------
@@ -871,20 +965,23 @@ static void MC_macroblock_P8x8(FrmDecContext* ctx, int mx, int my, const int8_t
     curMvs[3].y += mvDiff[3][1];
 
     // 帧间预测
-    mbPos[0] += 8;
-    mbPos[1] += 4;
-    mbPos[2] += 4;
+    mbPos[0] += lBlk;
+    mbPos[1] += cBlk;
+    mbPos[2] += cBlk;
     x = (mx << 6) + 32 + curMvs[3].x;
     y = (my << 6) + 32 + curMvs[3].y;
     refPic = ctx->refPics + refIdxs[3];
-    luma_inter_pred_8x8(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)            // 加权预测
     {
-        int k = refIdxs[3];
-        weight_pred_8xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[3], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     // 设置环路滤波相关参数
@@ -966,26 +1063,26 @@ void dec_macroblock_PSkip(FrmDecContext* ctx, int mx, int my)
         curMv = get_mv_pred(nbs, ctx->refDist[refIdx]);
     }
 
-    // 亮度分量帧间预测
+    // 帧间预测
     const RefPicture* refPic = ctx->refPics + refIdx;
     const int lPitch = ctx->picPitch[0];
-    uint8_t* luma = ctx->picPlane[0] + (my * lPitch + mx) * 16;
+    const int cPitch = ctx->picPitch[1];
+    uint8_t* luma = luma_mb_pos(ctx, mx, my);
+    uint8_t* dstCb = cbcr_mb_pos(ctx, 1, mx, my);
+    uint8_t* dstCr = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMv.x;
     int y = (my << 6) + curMv.y;
-    luma_inter_pred_16x16(ctx, refPic, luma, lPitch, x, y);
-
-    // 色差分量帧间预测
-    const int cPitch = ctx->picPitch[1];
-    uint8_t* dstCb = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    uint8_t* dstCr = ctx->picPlane[2] + (my * cPitch + mx) * 8;
-    chroma_inter_pred_8x8(ctx, refPic, dstCb, dstCr, cPitch, x, y);
-
-    // 加权预测
-    if (ctx->sliceWPFlag && !ctx->mbWPFlag)
+    if (ctx->sliceWPFlag && !ctx->mbWPFlag)     // 加权预测
+    {
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdx, MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x16)(ctx, refPic, luma, lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x8)(ctx, refPic, dstCb, dstCr, cPitch, x, y, blend + 1);
+    }
+    else
     {
-        weight_pred_16xN(luma, lPitch, ctx->lumaScale[refIdx], ctx->lumaDelta[refIdx], 16);
-        weight_pred_8xN(dstCb, cPitch, ctx->cbcrScale[refIdx], ctx->cbcrDelta[refIdx], 8);
-        weight_pred_8xN(dstCr, cPitch, ctx->cbcrScale[refIdx], ctx->cbcrDelta[refIdx], 8);
+        (*ctx->kernels->pfnLumaMC16x16)(ctx, refPic, luma, lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x8)(ctx, refPic, dstCb, dstCr, cPitch, x, y);
     }
 
     // 设置环路滤波相关参数
@@ -1403,8 +1500,7 @@ static inline void check_BD_col_mv(FrmDecContext* ctx, const DecFrame* colFrame,
 
     // 等待参考帧, +1 是为了让参考帧多解码一些
     assert(colFrame->decState);
-    ctx->refRequest.m_refLine = (my + 1) * 16 * (2 - ctx->frameCoding);  // 可能存在帧场自适应编码, 转化为帧的刻度
-    colFrame->decState->wait_request(&ctx->refRequest);
+    wait_ref_line(ctx, colFrame->decState, (my + 1) * 16 * (2 - ctx->frameCoding));  // 可能存在帧场自适应编码, 转化为帧的刻度
 }
 
 // 计算 BDirect 运动矢量, 针对 BfieldEnhanced == 1 的情形
@@ -1588,14 +1684,15 @@ static void get_BD_mv(FrmDecContext* ctx, int mx, int my, int blkIdx, int8_t ref
 static void MC_BDirect_16x16(FrmDecContext* ctx, int mx, int my, int wpFlag)
 {
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     uint8_t* mbPos[3] =
     {
-        ctx->picPlane[0] + (my * lPitch + mx) * 16,
-        ctx->picPlane[1] + (my * cPitch + mx) * 8,
-        ctx->picPlane[2] + (my * cPitch + mx) * 8,
+        luma_mb_pos(ctx, mx, my),
+        cbcr_mb_pos(ctx, 1, mx, my),
+        cbcr_mb_pos(ctx, 2, mx, my),
     };
-    uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
     uint8_t* blkDst[3];
     RefPicture* refPic = nullptr;
     int8_t refIdxs[4][2];
@@ -1607,9 +1704,9 @@ static void MC_BDirect_16x16(FrmDecContext* ctx, int mx, int my, int wpFlag)
         // 8x8 块的目标位置
         int blkX = (mx << 6) + (i & 1) * 32;
         int blkY = (my << 6) + (i & 2) * 16;
-        blkDst[0] = mbPos[0] + (i & 2) * 4 * lPitch + (i & 1) * 8;
-        blkDst[1] = mbPos[1] + (i & 2) * 2 * cPitch + (i & 1) * 4;
-        blkDst[2] = mbPos[2] + (i & 2) * 2 * cPitch + (i & 1) * 4;
+        blkDst[0] = mbPos[0] + (i >> 1) * lBlk * lPitch + (i & 1) * lBlk;
+        blkDst[1] = mbPos[1] + (i >> 1) * cBlk * cPitch + (i & 1) * cBlk;
+        blkDst[2] = mbPos[2] + (i >> 1) * cBlk * cPitch + (i & 1) * cBlk;
 
         // 得到 B_Direct 运动矢量
         get_BD_mv(ctx, mx, my, i, refIdxs[i], curMvs[i]);
@@ -1618,34 +1715,28 @@ static void MC_BDirect_16x16(FrmDecContext* ctx, int mx, int my, int wpFlag)
         int x = blkX + curMvs[i][0].x;
         int y = blkY + curMvs[i][0].y;
         refPic = ctx->refPics + refIdxs[i][0];
-        luma_inter_pred_8x8(ctx, refPic, blkDst[0], lPitch, x, y);
-        chroma_inter_pred_4x4(ctx, refPic, blkDst[1], blkDst[2], cPitch, x, y);
         if (wpFlag)    // 加权预测
         {
-            int k = refIdxs[i][0];
-            weight_pred_8xN(blkDst[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-            weight_pred_4xN(blkDst[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-            weight_pred_4xN(blkDst[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+            McBlend blend[2];
+            get_mc_blend(ctx, refIdxs[i][0], MC_BLEND_WEIGHT, blend);
+            (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blkDst[0], lPitch, x, y, blend);
+            (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blkDst[1], blkDst[2], cPitch, x, y, blend + 1);
+        }
+        else
+        {
+            (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, blkDst[0], lPitch, x, y);
+            (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, blkDst[1], blkDst[2], cPitch, x, y);
         }
 
         // 后向预测
         x = blkX + curMvs[i][1].x;
         y = blkY + curMvs[i][1].y;
         refPic = ctx->refPics + refIdxs[i][1];
-        luma_inter_pred_8x8(ctx, refPic, mcBuf[0], 16, x, y);
-        chroma_inter_pred_4x4(ctx, refPic, mcBuf[1], mcBuf[2], 8, x, y);
-        if (wpFlag)    // 加权预测
-        {
-            int k = refIdxs[i][1];
-            weight_pred_8xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-            weight_pred_4xN(mcBuf[1], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-            weight_pred_4xN(mcBuf[2], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        }
-
-        // 取前后预测平均值
-        MC_avg_8xN(mcBuf[0], 16, blkDst[0], lPitch, 8);
-        MC_avg_4xN(mcBuf[1], 8, blkDst[1], cPitch, 4);
-        MC_avg_4xN(mcBuf[2], 8, blkDst[2], cPitch, 4);
+        // 与前向预测取平均
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[i][1], wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blkDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blkDst[1], blkDst[2], cPitch, x, y, blend + 1);
     }
 
     // 设置环路滤波相关参数
@@ -1707,20 +1798,23 @@ static void MC_macroblock_B16x16(FrmDecContext* ctx, int mx, int my, int rawIdx,
     const int lPitch = ctx->picPitch[0];
     const int cPitch = ctx->picPitch[1];
     uint8_t* mbPos[3];
-    mbPos[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    mbPos[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    mbPos[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    mbPos[0] = luma_mb_pos(ctx, mx, my);
+    mbPos[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    mbPos[2] = cbcr_mb_pos(ctx, 2, mx, my);
     int x = (mx << 6) + curMvs[dir].x;
     int y = (my << 6) + curMvs[dir].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[dir];
-    luma_inter_pred_16x16(ctx, refPic, mbPos[0], lPitch, x, y);
-    chroma_inter_pred_8x8(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     if (wpFlag)        // 加权预测
     {
-        int k = refIdxs[dir];
-        weight_pred_16xN(mbPos[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-        weight_pred_8xN(mbPos[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        weight_pred_8xN(mbPos[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[dir], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x16)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC16x16)(ctx, refPic, mbPos[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y);
     }
 
     if (predFlag == PRED_SYM)      // 双向预测
@@ -1729,24 +1823,14 @@ static void MC_macroblock_B16x16(FrmDecContext* ctx, int mx, int my, int rawIdx,
         refIdxs[1] = refIdxs[0] ^ ctx->backIdxXor;
         curMvs[1] = sym_mv_scale(curMvs[0], ctx->backMvScale[refIdxs[0]]);
 
-        uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
         int x = (mx << 6) + curMvs[1].x;
         int y = (my << 6) + curMvs[1].y;
         const RefPicture* refPic = ctx->refPics + refIdxs[1];
-        luma_inter_pred_16x16(ctx, refPic, mcBuf[0], 16, x, y);
-        chroma_inter_pred_8x8(ctx, refPic, mcBuf[1], mcBuf[2], 16, x, y);
-        if (wpFlag)    // 加权预测
-        {
-            int k = refIdxs[1];
-            weight_pred_16xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-            weight_pred_8xN(mcBuf[1], 16, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-            weight_pred_8xN(mcBuf[2], 16, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        }
-
-        // 取前后预测平均值
-        MC_avg_16xN(mcBuf[0], 16, mbPos[0], lPitch, 16);
-        MC_avg_8xN(mcBuf[1], 16, mbPos[1], cPitch, 8);
-        MC_avg_8xN(mcBuf[2], 16, mbPos[2], cPitch, 8);
+        // 与前向预测取平均
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x16)(ctx, refPic, mbPos[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x8)(ctx, refPic, mbPos[1], mbPos[2], cPitch, x, y, blend + 1);
     }
     else
     {
@@ -1798,14 +1882,17 @@ static void MC_blockB_16x8(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t ref
     int x = blk.bx + curMvs[dir].x;
     int y = blk.by + curMvs[dir].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[dir];
-    luma_inter_pred_16x8(ctx, refPic, blk.mbDst[0], lPitch, x, y);
-    chroma_inter_pred_8x4(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     if (blk.wpFlag)           // 加权预测
     {
-        int k = refIdxs[dir];
-        weight_pred_16xN(blk.mbDst[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_8xN(blk.mbDst[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_8xN(blk.mbDst[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[dir], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC16x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC8x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     }
 
     // 双向预测
@@ -1815,24 +1902,14 @@ static void MC_blockB_16x8(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t ref
         refIdxs[1] = refIdxs[0] ^ ctx->backIdxXor;
         curMvs[1] = sym_mv_scale(curMvs[0], ctx->backMvScale[refIdxs[0]]);
 
-        uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
         int x = blk.bx + curMvs[1].x;
         int y = blk.by + curMvs[1].y;
         const RefPicture* refPic = ctx->refPics + refIdxs[1];
-        luma_inter_pred_16x8(ctx, refPic, mcBuf[0], 16, x, y);
-        chroma_inter_pred_8x4(ctx, refPic, mcBuf[1], mcBuf[2], 16, x, y);
-        if (blk.wpFlag)        // 加权预测
-        {
-            int k = refIdxs[1];
-            weight_pred_16xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-            weight_pred_8xN(mcBuf[1], 16, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-            weight_pred_8xN(mcBuf[2], 16, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        }
-
-        // 取前后预测平均值
-        MC_avg_16xN(mcBuf[0], 16, blk.mbDst[0], lPitch, 8);
-        MC_avg_8xN(mcBuf[1], 16, blk.mbDst[1], cPitch, 4);
-        MC_avg_8xN(mcBuf[2], 16, blk.mbDst[2], cPitch, 4);
+        // 与前向预测取平均
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], blk.wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+        (*ctx->kernels->pfnLumaMCBlend16x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend8x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
     }
     else
     {
@@ -1850,14 +1927,17 @@ static void MC_blockB_8x16(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t ref
     int x = blk.bx + curMvs[dir].x;
     int y = blk.by + curMvs[dir].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[dir];
-    luma_inter_pred_8x16(ctx, refPic, blk.mbDst[0], lPitch, x, y);
-    chroma_inter_pred_4x8(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     if (blk.wpFlag)           // 加权预测
     {
-        int k = refIdxs[dir];
-        weight_pred_8xN(blk.mbDst[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-        weight_pred_4xN(blk.mbDst[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        weight_pred_4xN(blk.mbDst[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[dir], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x16)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x8)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x16)(ctx, refPic, blk.mbDst[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x8)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     }
 
     // 双向预测
@@ -1867,24 +1947,14 @@ static void MC_blockB_8x16(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t ref
         refIdxs[1] = refIdxs[0] ^ ctx->backIdxXor;
         curMvs[1] = sym_mv_scale(curMvs[0], ctx->backMvScale[refIdxs[0]]);
 
-        uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
         int x = blk.bx + curMvs[1].x;
         int y = blk.by + curMvs[1].y;
         const RefPicture* refPic = ctx->refPics + refIdxs[1];
-        luma_inter_pred_8x16(ctx, refPic, mcBuf[0], 16, x, y);
-        chroma_inter_pred_4x8(ctx, refPic, mcBuf[1], mcBuf[2], 8, x, y);
-        if (blk.wpFlag)        // 加权预测
-        {
-            int k = refIdxs[1];
-            weight_pred_8xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 16);
-            weight_pred_4xN(mcBuf[1], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-            weight_pred_4xN(mcBuf[2], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 8);
-        }
-
-        // 取前后预测平均值
-        MC_avg_8xN(mcBuf[0], 16, blk.mbDst[0], lPitch, 16);
-        MC_avg_4xN(mcBuf[1], 8, blk.mbDst[1], cPitch, 8);
-        MC_avg_4xN(mcBuf[2], 8, blk.mbDst[2], cPitch, 8);
+        // 与前向预测取平均
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], blk.wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x16)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x8)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
     }
     else
     {
@@ -1903,14 +1973,17 @@ static void MC_blockB_8x8(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t refI
     int x = blk.bx + curMvs[dir].x;
     int y = blk.by + curMvs[dir].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[dir];
-    luma_inter_pred_8x8(ctx, refPic, blk.mbDst[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     if (blk.wpFlag)           // 加权预测
     {
-        int k = refIdxs[dir];
-        weight_pred_8xN(blk.mbDst[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(blk.mbDst[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(blk.mbDst[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[dir], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     }
 
     // 双向预测
@@ -1920,24 +1993,14 @@ static void MC_blockB_8x8(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t refI
         refIdxs[1] = refIdxs[0] ^ ctx->backIdxXor;
         curMvs[1] = sym_mv_scale(curMvs[0], ctx->backMvScale[refIdxs[0]]);
 
-        uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
         int x = blk.bx + curMvs[1].x;
         int y = blk.by + curMvs[1].y;
         const RefPicture* refPic = ctx->refPics + refIdxs[1];
-        luma_inter_pred_8x8(ctx, refPic, mcBuf[0], 16, x, y);
-        chroma_inter_pred_4x4(ctx, refPic, mcBuf[1], mcBuf[2], 8, x, y);
-        if (blk.wpFlag)        // 加权预测
-        {
-            int k = refIdxs[1];
-            weight_pred_8xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-            weight_pred_4xN(mcBuf[1], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-            weight_pred_4xN(mcBuf[2], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        }
-
-        // 取前后预测平均值
-        MC_avg_8xN(mcBuf[0], 16, blk.mbDst[0], lPitch, 8);
-        MC_avg_4xN(mcBuf[1], 8, blk.mbDst[1], cPitch, 4);
-        MC_avg_4xN(mcBuf[2], 8, blk.mbDst[2], cPitch, 4);
+        // 与前向预测取平均
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[1], blk.wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
     }
     else
     {
@@ -1961,34 +2024,27 @@ static void MC_BDirect_8x8(FrmDecContext* ctx, const BlkDecArgv& blk, int8_t ref
     int x = blk.bx + curMvs[0].x;
     int y = blk.by + curMvs[0].y;
     const RefPicture* refPic = ctx->refPics + refIdxs[0];
-    luma_inter_pred_8x8(ctx, refPic, blk.mbDst[0], lPitch, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     if (blk.wpFlag)    // 加权预测
     {
-        int k = refIdxs[0];
-        weight_pred_8xN(blk.mbDst[0], lPitch, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(blk.mbDst[1], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(blk.mbDst[2], cPitch, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
+        McBlend blend[2];
+        get_mc_blend(ctx, refIdxs[0], MC_BLEND_WEIGHT, blend);
+        (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+        (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
+    }
+    else
+    {
+        (*ctx->kernels->pfnLumaMC8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y);
+        (*ctx->kernels->pfnChromaMC4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y);
     }
 
-    uint8_t* mcBuf[3] = {ctx->mcBuff, ctx->mcBuff + 256, ctx->mcBuff + 512};
     x = blk.bx + curMvs[1].x;
     y = blk.by + curMvs[1].y;
     refPic = ctx->refPics + refIdxs[1];
-    luma_inter_pred_8x8(ctx, refPic, mcBuf[0], 16, x, y);
-    chroma_inter_pred_4x4(ctx, refPic, mcBuf[1], mcBuf[2], 8, x, y);
-    if (blk.wpFlag)    // 加权预测
-    {
-        int k = refIdxs[1];
-        weight_pred_8xN(mcBuf[0], 16, ctx->lumaScale[k], ctx->lumaDelta[k], 8);
-        weight_pred_4xN(mcBuf[1], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-        weight_pred_4xN(mcBuf[2], 8, ctx->cbcrScale[k], ctx->cbcrDelta[k], 4);
-    }
-
-    // 取前后预测平均值
-    MC_avg_8xN(mcBuf[0], 16, blk.mbDst[0], lPitch, 8);
-    MC_avg_4xN(mcBuf[1], 8, blk.mbDst[1], cPitch, 4);
-    MC_avg_4xN(mcBuf[2], 8, blk.mbDst[2], cPitch, 4);
+    // 与前向预测取平均
+    McBlend blend[2];
+    get_mc_blend(ctx, refIdxs[1], blk.wpFlag ? (MC_BLEND_WEIGHT | MC_BLEND_AVG) : MC_BLEND_AVG, blend);
+    (*ctx->kernels->pfnLumaMCBlend8x8)(ctx, refPic, blk.mbDst[0], lPitch, x, y, blend);
+    (*ctx->kernels->pfnChromaMCBlend4x4)(ctx, refPic, blk.mbDst[1], blk.mbDst[2], cPitch, x, y, blend + 1);
 }
 
 // B-Skip 宏块解码
@@ -2171,14 +2227,16 @@ void dec_macroblock_B16x8(FrmDecContext* ctx, int mx, int my)
 
     // 帧间预测
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
 
     blkArg.predFlag = predFlags[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     MC_blockB_16x8(ctx, blkArg, refIdxs[0], curMvs[0]);
 
     //------------------------------ block 1 ------------------------------
@@ -2211,9 +2269,9 @@ void dec_macroblock_B16x8(FrmDecContext* ctx, int mx, int my)
     // 帧间预测
     blkArg.predFlag = predFlags[1];
     blkArg.by += 32;
-    blkArg.mbDst[0] += 8 * lPitch;
-    blkArg.mbDst[1] += 4 * cPitch;
-    blkArg.mbDst[2] += 4 * cPitch;
+    blkArg.mbDst[0] += lBlk * lPitch;
+    blkArg.mbDst[1] += cBlk * cPitch;
+    blkArg.mbDst[2] += cBlk * cPitch;
     MC_blockB_16x8(ctx, blkArg, refIdxs[1], curMvs[1]);
 
     // 设置环路滤波相关参数
@@ -2335,9 +2393,9 @@ void dec_macroblock_B8x16(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = predFlags[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * ctx->picPitch[0] + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * ctx->picPitch[1] + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * ctx->picPitch[1] + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     MC_blockB_8x16(ctx, blkArg, refIdxs[0], curMvs[0]);
 
     //------------------------------ block 1 ------------------------------
@@ -2391,12 +2449,14 @@ void dec_macroblock_B8x16(FrmDecContext* ctx, int mx, int my)
     curMvs[1][dir].x += mvDiff[idx][0];
     curMvs[1][dir].y += mvDiff[idx][1];
 
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     // 帧间预测
     blkArg.predFlag = predFlags[1];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     MC_blockB_8x16(ctx, blkArg, refIdxs[1], curMvs[1]);
 
     // 设置环路滤波相关参数
@@ -2521,7 +2581,9 @@ void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my)
     }
 
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     MbContext* leftMb = &ctx->leftMb;
     MbContext* topMb = ctx->topLine + mx;
     MbContext* curMb = ctx->curLine + mx;
@@ -2534,9 +2596,9 @@ void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = partType[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     if (partType[0] != 0)
     {
         const int dir = (partType[0] & 1) ^ 1;          // 预测方向索引
@@ -2564,9 +2626,9 @@ void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my)
     //------------------------------- block 1 --------------------------------
     blkArg.predFlag = partType[1];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     if (partType[1] != 0)
     {
         const int dir = (partType[1] & 1) ^ 1;          // 预测方向索引
@@ -2603,9 +2665,9 @@ void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = partType[2];
     blkArg.bx -= 32;
     blkArg.by += 32;
-    blkArg.mbDst[0] += 8 * lPitch - 8;
-    blkArg.mbDst[1] += 4 * cPitch - 4;
-    blkArg.mbDst[2] += 4 * cPitch - 4;
+    blkArg.mbDst[0] += lBlk * lPitch - lBlk;
+    blkArg.mbDst[1] += cBlk * cPitch - cBlk;
+    blkArg.mbDst[2] += cBlk * cPitch - cBlk;
     if (partType[2] != 0)
     {
         const int dir = (partType[2] & 1) ^ 1;          // 预测方向索引
@@ -2633,9 +2695,9 @@ void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my)
     //------------------------------- block 3 --------------------------------
     blkArg.predFlag = partType[3];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     if (partType[3] != 0)
     {
         const int dir = (partType[3] & 1) ^ 1;          // 预测方向索引
@@ -2740,40 +2802,50 @@ static bool dec_mb_residual_AEC(FrmDecContext* ctx, int mx, int my, uint32_t cbp
     const int dqShift = g_DequantShift[ctx->curQp];
     int16_t* coeff = ctx->coeff;        // 存储 DCT 系数的临时内存
 
-    // decode Luma block 0
     const int lPitch = ctx->picPitch[0];
-    uint8_t* luma = ctx->picPlane[0] + (my * lPitch + mx) * 16;
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    uint8_t* luma = luma_mb_pos(ctx, mx, my);
+
+    // decode Luma block 0, 1, 水平相邻的两个块解析完成后一起反变换
+    int shape0 = COEFF_ZERO;
+    int shape1 = COEFF_ZERO;
     if (cbpFlags & 0x1)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        shape0 = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape0 == COEFF_ERROR)
             return false;
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
     }
-
-    // decode Luma block 1
     if (cbpFlags & 0x2)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        shape1 = parser->dec_coeff_block(coeff + 64, 58, dqScale, dqShift);
+        if (shape1 == COEFF_ERROR)
+        {
+            idct_8x8_add(ctx->kernels, shape0, coeff, luma, lPitch);   // 与逐块处理一致, 出错前已解析的块仍然叠加
             return false;
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        }
     }
+    idct_16x8_add(ctx->kernels, shape0, shape1, coeff, luma, lPitch, lBlk);
 
-    // decode Luma block 2
-    luma += 8 * lPitch;
+    // decode Luma block 2, 3
+    luma += lBlk * lPitch;
+    shape0 = COEFF_ZERO;
+    shape1 = COEFF_ZERO;
     if (cbpFlags & 0x4)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        shape0 = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape0 == COEFF_ERROR)
             return false;
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
     }
-
-    // decode Luma block 3
     if (cbpFlags & 0x8)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        shape1 = parser->dec_coeff_block(coeff + 64, 58, dqScale, dqShift);
+        if (shape1 == COEFF_ERROR)
+        {
+            idct_8x8_add(ctx->kernels, shape0, coeff, luma, lPitch);   // 与逐块处理一致, 出错前已解析的块仍然叠加
             return false;
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        }
     }
+    idct_16x8_add(ctx->kernels, shape0, shape1, coeff, luma, lPitch, lBlk);
 
     // decode Cb block
     const int cPitch = ctx->picPitch[1];
@@ -2784,11 +2856,12 @@ static bool dec_mb_residual_AEC(FrmDecContext* ctx, int mx, int my, uint32_t cbp
             return false;
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
             return false;
         const int cPitch = ctx->picPitch[1];
-        uint8_t* dstCb = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-        IDCT_8x8_add_sse4(coeff, dstCb, cPitch);
+        uint8_t* dstCb = cbcr_mb_pos(ctx, 1, mx, my);
+        idct_8x8_add(ctx->kernels, shape, coeff, dstCb, cPitch);
     }
 
     // decode Cr block
@@ -2799,11 +2872,12 @@ static bool dec_mb_residual_AEC(FrmDecContext* ctx, int mx, int my, uint32_t cbp
             return false;
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
             return false;
         const int cPitch = ctx->picPitch[2];
-        uint8_t* dstCr = ctx->picPlane[2] + (my * cPitch + mx) * 8;
-        IDCT_8x8_add_sse4(coeff, dstCr, cPitch);
+        uint8_t* dstCr = cbcr_mb_pos(ctx, 2, mx, my);
+        idct_8x8_add(ctx->kernels, shape, coeff, dstCr, cPitch);
     }
 
     return true;
@@ -2915,10 +2989,11 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
         ctx->prevQpDelta = 0;
     }
 
-    AvsContext* avsCtx = ctx->avsCtx;
+    const DecKernels* kernels = ctx->kernels;
     NBUsable usable;
     const int lPitch = ctx->picPitch[0];
-    uint8_t* luma = ctx->picPlane[0] + (my * lPitch + mx) * 16;
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    uint8_t* luma = luma_mb_pos(ctx, mx, my);
     int16_t* coeff = ctx->coeff;            // 存储 DCT 系数的临时内存
     int dqScale = g_DequantScale[ctx->curQp];
     int dqShift = g_DequantShift[ctx->curQp];
@@ -2928,15 +3003,16 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = topMb[0].avail;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = leftMb[0].avail;
-    (*avsCtx->pfnLumaIPred[lumaPred[0]])(luma, lPitch, usable);    // 帧内预测
+    (*kernels->pfnLumaIPred[lumaPred[0]])(luma, lPitch, usable);    // 帧内预测
     if (cbpFlags & 0x1)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        const int shape = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma, lPitch);
     }
 
     // decode luma block 1
@@ -2944,32 +3020,34 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = topMb[1].avail;
     usable.flags[2] = 1;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[1]])(luma + 8, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[1]])(luma + lBlk, lPitch, usable);
     if (cbpFlags & 0x2)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        const int shape = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma + lBlk, lPitch);
     }
 
     // decode luma block 2
-    luma += 8 * lPitch;
+    luma += lBlk * lPitch;
     usable.flags[0] = 1;
     usable.flags[1] = 1;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[2]])(luma, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[2]])(luma, lPitch, usable);
     if (cbpFlags & 0x4)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        const int shape = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
-        IDCT_8x8_add_sse4(coeff, luma, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma, lPitch);
     }
 
     // decode luma block 3
@@ -2977,25 +3055,26 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
     usable.flags[1] = 0;
     usable.flags[2] = 1;
     usable.flags[3] = 0;
-    (*avsCtx->pfnLumaIPred[lumaPred[3]])(luma + 8, lPitch, usable);
+    (*kernels->pfnLumaIPred[lumaPred[3]])(luma + lBlk, lPitch, usable);
     if (cbpFlags & 0x8)
     {
-        if (!parser->dec_coeff_block(coeff, 58, dqScale, dqShift))
+        const int shape = parser->dec_coeff_block(coeff, 58, dqScale, dqShift);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
-        IDCT_8x8_add_sse4(coeff, luma + 8, lPitch);
+        idct_8x8_add(kernels, shape, coeff, luma + lBlk, lPitch);
     }
 
     // decode Cb block
     const int cPitch = ctx->picPitch[1];
-    uint8_t* dstCb = ctx->picPlane[1] + (my * cPitch + mx) * 8;
+    uint8_t* dstCb = cbcr_mb_pos(ctx, 1, mx, my);
     usable.flags[0] = topMb[0].avail;
     usable.flags[1] = topMb[1].avail;
     usable.flags[2] = leftMb[0].avail;
     usable.flags[3] = 0;
-    (*avsCtx->pfnCbCrIPred[chromaPred])(dstCb, cPitch, usable);  // 帧内预测
+    (*kernels->pfnCbCrIPred[chromaPred])(dstCb, cPitch, usable);  // 帧内预测
     if (cbpFlags & 0x10)
     {
         int qp = ctx->curQp + ctx->picHdr.chroma_quant_delta_cb;
@@ -3006,18 +3085,19 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
         }
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, dstCb, cPitch);
+        idct_8x8_add(kernels, shape, coeff, dstCb, cPitch);
     }
 
     // decode Cr block
-    uint8_t* dstCr = ctx->picPlane[2] + (my * cPitch + mx) * 8;
-    (*avsCtx->pfnCbCrIPred[chromaPred])(dstCr, cPitch, usable);      // 帧内预测
+    uint8_t* dstCr = cbcr_mb_pos(ctx, 2, mx, my);
+    (*kernels->pfnCbCrIPred[chromaPred])(dstCr, cPitch, usable);      // 帧内预测
     if (cbpFlags & 0x20)
     {
         int qp = ctx->curQp + ctx->picHdr.chroma_quant_delta_cr;
@@ -3028,13 +3108,14 @@ void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my)
         }
         qp = g_ChromaQp[qp];
 
-        if (!parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]))
+        const int shape = parser->dec_coeff_block(coeff, 124, g_DequantScale[qp], g_DequantShift[qp]);
+        if (shape == COEFF_ERROR)
         {
             ctx->errCode = IRK_AVS_DEC_BAD_STREAM;
             return;
         }
 
-        IDCT_8x8_add_sse4(coeff, dstCr, cPitch);
+        idct_8x8_add(kernels, shape, coeff, dstCr, cPitch);
     }
 
     // 当前宏块可供右侧和下一行宏块使用
@@ -3611,13 +3692,15 @@ void dec_macroblock_B16x8_AEC(FrmDecContext* ctx, int mx, int my)
 
     // 帧间预测
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     blkArg.predFlag = predFlags[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     MC_blockB_16x8(ctx, blkArg, refIdxs[0], curMvs[0]);
 
     //------------------------------ block 1 ------------------------------
@@ -3649,9 +3732,9 @@ void dec_macroblock_B16x8_AEC(FrmDecContext* ctx, int mx, int my)
     // 帧间预测
     blkArg.predFlag = predFlags[1];
     blkArg.by += 32;
-    blkArg.mbDst[0] += 8 * lPitch;
-    blkArg.mbDst[1] += 4 * cPitch;
-    blkArg.mbDst[2] += 4 * cPitch;
+    blkArg.mbDst[0] += lBlk * lPitch;
+    blkArg.mbDst[1] += cBlk * cPitch;
+    blkArg.mbDst[2] += cBlk * cPitch;
     MC_blockB_16x8(ctx, blkArg, refIdxs[1], curMvs[1]);
 
     // 设置环路滤波相关参数
@@ -3843,9 +3926,9 @@ void dec_macroblock_B8x16_AEC(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = predFlags[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * ctx->picPitch[0] + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * ctx->picPitch[1] + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * ctx->picPitch[1] + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     MC_blockB_8x16(ctx, blkArg, refIdxs[0], curMvs[0]);
 
     //------------------------------ block 1 ------------------------------
@@ -3898,12 +3981,14 @@ void dec_macroblock_B8x16_AEC(FrmDecContext* ctx, int mx, int my)
     curMvs[1][dir].x += mvDiff[1][0];
     curMvs[1][dir].y += mvDiff[1][1];
 
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     // 帧间预测
     blkArg.predFlag = predFlags[1];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     MC_blockB_8x16(ctx, blkArg, refIdxs[1], curMvs[1]);
 
     // 设置环路滤波相关参数
@@ -4100,7 +4185,9 @@ void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my)
     }
 
     const int lPitch = ctx->picPitch[0];
+    const int lBlk = 8 >> ctx->resShift;       // 8x8 亮度块的大小, 低分辨率解码时按比例缩小
     const int cPitch = ctx->picPitch[1];
+    const int cBlk = 4 >> ctx->resShift;       // 4x4 色差块的大小
     const int* distDen = ctx->denDist;
     MvInfo nbs[3];
     int8_t refIdxs[4][2];
@@ -4110,9 +4197,9 @@ void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = partType[0];
     blkArg.bx = mx << 6;
     blkArg.by = my << 6;
-    blkArg.mbDst[0] = ctx->picPlane[0] + (my * lPitch + mx) * 16;
-    blkArg.mbDst[1] = ctx->picPlane[1] + (my * cPitch + mx) * 8;
-    blkArg.mbDst[2] = ctx->picPlane[2] + (my * cPitch + mx) * 8;
+    blkArg.mbDst[0] = luma_mb_pos(ctx, mx, my);
+    blkArg.mbDst[1] = cbcr_mb_pos(ctx, 1, mx, my);
+    blkArg.mbDst[2] = cbcr_mb_pos(ctx, 2, mx, my);
     if (partType[0] != 0)
     {
         const int dir = (partType[0] & 1) ^ 1;          // 预测方向索引
@@ -4140,9 +4227,9 @@ void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my)
     //------------------------------- block 1 --------------------------------
     blkArg.predFlag = partType[1];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     if (partType[1] != 0)
     {
         const int dir = (partType[1] & 1) ^ 1;          // 预测方向索引
@@ -4182,9 +4269,9 @@ void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my)
     blkArg.predFlag = partType[2];
     blkArg.bx -= 32;
     blkArg.by += 32;
-    blkArg.mbDst[0] += 8 * lPitch - 8;
-    blkArg.mbDst[1] += 4 * cPitch - 4;
-    blkArg.mbDst[2] += 4 * cPitch - 4;
+    blkArg.mbDst[0] += lBlk * lPitch - lBlk;
+    blkArg.mbDst[1] += cBlk * cPitch - cBlk;
+    blkArg.mbDst[2] += cBlk * cPitch - cBlk;
     if (partType[2] != 0)
     {
         const int dir = (partType[2] & 1) ^ 1;          // 预测方向索引
@@ -4214,9 +4301,9 @@ void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my)
     //------------------------------- block 3 --------------------------------
     blkArg.predFlag = partType[3];
     blkArg.bx += 32;
-    blkArg.mbDst[0] += 8;
-    blkArg.mbDst[1] += 4;
-    blkArg.mbDst[2] += 4;
+    blkArg.mbDst[0] += lBlk;
+    blkArg.mbDst[1] += cBlk;
+    blkArg.mbDst[2] += cBlk;
     if (partType[3] != 0)
     {
         const int dir = (partType[3] & 1) ^ 1;          // 预测方向索引
@@ -0,0 +1,144 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+
+// 输出格式转换, 将重建的 I420 图像转换为 NV12 或 UYVY
+
+#include <emmintrin.h>      // SSE2
+#include <algorithm>
+#include "AvsDecoder.h"
+
+namespace irk_avs_dec {
+
+// 交织一行 Cb, Cr 为 CbCr, 每次处理 16 个像素
+// NOTE: 读写可能超出 width, 调用者需保证行宽足够
+void interleave_cbcr_sse2(uint8_t* dst, const uint8_t* srcCb, const uint8_t* srcCr, int width)
+{
+    for (int i = 0; i < width; i += 16)
+    {
+        __m128i cb = _mm_loadu_si128((const __m128i*)(srcCb + i));
+        __m128i cr = _mm_loadu_si128((const __m128i*)(srcCr + i));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi8(cb, cr));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 16), _mm_unpackhi_epi8(cb, cr));
+    }
+}
+
+// 打包一行 Y, Cb, Cr 为 UYVY, width 为亮度宽度, 每次处理 32 个像素
+// NOTE: 读写可能超出 width, 调用者需保证行宽足够
+void pack_uyvy_sse2(uint8_t* dst, const uint8_t* srcY, const uint8_t* srcCb, const uint8_t* srcCr, int width)
+{
+    for (int i = 0; i < width; i += 32)
+    {
+        __m128i y0 = _mm_loadu_si128((const __m128i*)(srcY + i));
+        __m128i y1 = _mm_loadu_si128((const __m128i*)(srcY + i + 16));
+        __m128i cb = _mm_loadu_si128((const __m128i*)(srcCb + (i >> 1)));
+        __m128i cr = _mm_loadu_si128((const __m128i*)(srcCr + (i >> 1)));
+        __m128i uv0 = _mm_unpacklo_epi8(cb, cr);
+        __m128i uv1 = _mm_unpackhi_epi8(cb, cr);
+        _mm_storeu_si128((__m128i*)(dst + 2 * i), _mm_unpacklo_epi8(uv0, y0));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 16), _mm_unpackhi_epi8(uv0, y0));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 32), _mm_unpacklo_epi8(uv1, y1));
+        _mm_storeu_si128((__m128i*)(dst + 2 * i + 48), _mm_unpackhi_epi8(uv1, y1));
+    }
+}
+
+// 转换帧/场中的亮度行 [lineBeg, lineEnd) 及对应的色差行
+// 场图像隔行存储在帧中, 此时 step 为 2, parity 为场在帧中的起始行
+static void convert_lines(const AvsContext* avsCtx, DecFrame* frame, int lineBeg, int lineEnd, int step, int parity)
+{
+    if (avsCtx->outFormat == IRK_AVS_OUTPUT_NV12)
+    {
+        // 亮度平面与重建图像共用, 只需交织色差
+        const int srcPitch = frame->recPitch[1];
+        for (int i = (lineBeg >> 1); i < (lineEnd >> 1); i++)
+        {
+            const int y = i * step + parity;
+            if (y >= frame->height[1])
+                break;
+            (*avsCtx->pfnInterleaveCbCr)(frame->plane[1] + y * frame->pitch[1],
+                frame->recPlane[1] + y * srcPitch, frame->recPlane[2] + y * srcPitch, frame->width[1]);
+        }
+    }
+    else
+    {
+        // 4:2:0 转换为 4:2:2, 相邻两行亮度使用同一行色差
+        const int srcPitch = frame->recPitch[1];
+        for (int i = lineBeg; i < lineEnd; i++)
+        {
+            const int y = i * step + parity;
+            if (y >= frame->height[0])
+                break;
+            const int yc = (i >> 1) * step + parity;
+            (*avsCtx->pfnPackUYVY)(frame->plane[0] + y * frame->pitch[0], frame->recPlane[0] + y * frame->recPitch[0],
+                frame->recPlane[1] + yc * srcPitch, frame->recPlane[2] + yc * srcPitch, frame->width[0]);
+        }
+    }
+}
+
+// 宏块行 my 重建完成后转换为输出格式, 此时数据仍在缓存中
+void convert_mb_row(FrmDecContext* ctx, int my)
+{
+    const int64_t start = ctx->profiling ? read_cycles() : 0;
+
+    DecFrame* frame = ctx->curFrame;
+    const int step = ctx->picPitch[0] / frame->recPitch[0];     // 场图像为 2
+    const int parity = (int)((ctx->picPlane[0] - frame->recPlane[0]) / frame->recPitch[0]);
+    const int lines = 16 >> ctx->resShift;
+    convert_lines(ctx->avsCtx, frame, my * lines, (my + 1) * lines, step, parity);
+    frame->rowConverted[my * step + parity] = 1;
+
+    if (ctx->profiling)
+        ctx->stats.cycles[STAGE_PADDING] += read_cycles() - start;
+}
+
+// 整帧转换为输出格式, 场编码图像的两场分别转换
+void convert_frame(const AvsContext* avsCtx, DecFrame* frame, bool fieldCoding)
+{
+    // 色差行数可能多于亮度行数的一半, 超出图像的行不会转换
+    const int lineCnt = std::max(frame->height[0], frame->height[1] * 2);
+    if (fieldCoding)
+    {
+        convert_lines(avsCtx, frame, 0, lineCnt, 2, 0);
+        convert_lines(avsCtx, frame, 0, lineCnt, 2, 1);
+    }
+    else
+    {
+        convert_lines(avsCtx, frame, 0, lineCnt, 1, 0);
+    }
+}
+
+// 一帧解码结束后转换遗漏的宏块行
+// 码流错误导致 slice 提前结束, 或者缺少 slice 时, 部分宏块行没有重建和边界填充, 也就没有逐行转换,
+// 错误的 slice 还可能覆盖已转换的宏块行, 此时整帧重新转换
+void convert_missed_rows(FrmDecContext* ctx)
+{
+    DecFrame* frame = ctx->curFrame;
+    if (frame->sliceError)
+    {
+        convert_frame(ctx->avsCtx, frame, ctx->frameCoding == 0);
+        return;
+    }
+
+    const int step = ctx->frameCoding ? 1 : 2;
+    const int lines = 16 >> ctx->resShift;
+    for (int parity = 0; parity < step; parity++)
+    {
+        for (int my = 0; my < ctx->mbRowCnt; my++)
+        {
+            if (frame->rowConverted[my * step + parity] == 0)
+                convert_lines(ctx->avsCtx, frame, my * lines, (my + 1) * lines, step, parity);
+        }
+    }
+}
+
+}   // namespace irk_avs_dec
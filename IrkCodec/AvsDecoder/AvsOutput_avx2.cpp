@@ -0,0 +1,56 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+
+// 本文件单独使用 AVX2 编译选项, 只能被运行时检测到 AVX2 支持后调用
+// 注意: 不要在本文件中调用头文件中的非 static inline 函数, 避免链接时与 SSE 版本混淆
+
+#include <immintrin.h>      // AVX2
+#include <stdint.h>
+
+namespace irk_avs_dec {
+
+// 交织一行 Cb, Cr 为 CbCr, 每次处理 32 个像素
+// NOTE: 读写可能超出 width, 调用者需保证行宽足够
+void interleave_cbcr_avx2(uint8_t* dst, const uint8_t* srcCb, const uint8_t* srcCr, int width)
+{
+    for (int i = 0; i < width; i += 32)
+    {
+        __m256i cb = _mm256_loadu_si256((const __m256i*)(srcCb + i));
+        __m256i cr = _mm256_loadu_si256((const __m256i*)(srcCr + i));
+        __m256i lo = _mm256_unpacklo_epi8(cb, cr);      // 像素 0~7, 16~23
+        __m256i hi = _mm256_unpackhi_epi8(cb, cr);      // 像素 8~15, 24~31
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+}
+
+// 打包一行 Y, Cb, Cr 为 UYVY, width 为亮度宽度, 每次处理 32 个像素
+// NOTE: 读写可能超出 width, 调用者需保证行宽足够
+void pack_uyvy_avx2(uint8_t* dst, const uint8_t* srcY, const uint8_t* srcCb, const uint8_t* srcCr, int width)
+{
+    for (int i = 0; i < width; i += 32)
+    {
+        __m256i y = _mm256_loadu_si256((const __m256i*)(srcY + i));
+        __m128i cb = _mm_loadu_si128((const __m128i*)(srcCb + (i >> 1)));
+        __m128i cr = _mm_loadu_si128((const __m128i*)(srcCr + (i >> 1)));
+        __m256i uv = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(cb, cr)),
+                                             _mm_unpackhi_epi8(cb, cr), 1);
+        __m256i lo = _mm256_unpacklo_epi8(uv, y);       // 像素 0~7, 16~23
+        __m256i hi = _mm256_unpackhi_epi8(uv, y);       // 像素 8~15, 24~31
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+}
+
+}   // namespace irk_avs_dec
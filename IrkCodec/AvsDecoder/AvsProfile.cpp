@@ -0,0 +1,140 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+#include "AvsDecoder.h"
+
+namespace irk_avs_dec {
+
+// 当前线程统计数据的归属 context, 用于没有 FrmDecContext 参数的像素处理函数
+static thread_local FrmDecContext* s_ProfCtx = nullptr;
+
+// 设置当前线程统计数据的归属 context, 返回之前的设置
+FrmDecContext* set_prof_context(FrmDecContext* ctx)
+{
+    FrmDecContext* prev = s_ProfCtx;
+    s_ProfCtx = ctx;
+    return prev;
+}
+
+//======================================================================================================================
+// 统计函数, 调用实际的像素处理函数并累计耗时
+
+template<int FUNC>
+static void prof_luma_ipred(uint8_t* dst, int pitch, NBUsable usable)
+{
+    FrmDecContext* ctx = s_ProfCtx;
+    const int64_t start = read_cycles();
+    (*ctx->avsCtx->kernels.pfnLumaIPred[FUNC])(dst, pitch, usable);
+    ctx->stats.cycles[STAGE_INTRA] += read_cycles() - start;
+}
+
+template<int FUNC>
+static void prof_cbcr_ipred(uint8_t* dst, int pitch, NBUsable usable)
+{
+    FrmDecContext* ctx = s_ProfCtx;
+    const int64_t start = read_cycles();
+    (*ctx->avsCtx->kernels.pfnCbCrIPred[FUNC])(dst, pitch, usable);
+    ctx->stats.cycles[STAGE_INTRA] += read_cycles() - start;
+}
+
+// 帧间预测中可能等待参考帧, 等待的耗时单独统计
+template<PFN_LumaInterPred DecKernels::*PFN>
+static void prof_luma_mc(FrmDecContext* ctx, const RefPicture* refPic, uint8_t* dst, int dstPitch, int x, int y)
+{
+    const int64_t waited = ctx->stats.cycles[STAGE_WAIT];
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(ctx, refPic, dst, dstPitch, x, y);
+    ctx->stats.cycles[STAGE_INTER] += read_cycles() - start - (ctx->stats.cycles[STAGE_WAIT] - waited);
+}
+
+template<PFN_ChromaInterPred DecKernels::*PFN>
+static void prof_chroma_mc(FrmDecContext* ctx, const RefPicture* refPic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    const int64_t waited = ctx->stats.cycles[STAGE_WAIT];
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(ctx, refPic, dstCb, dstCr, dstPitch, x, y);
+    ctx->stats.cycles[STAGE_INTER] += read_cycles() - start - (ctx->stats.cycles[STAGE_WAIT] - waited);
+}
+
+template<PFN_LumaInterPredBlend DecKernels::*PFN>
+static void prof_luma_mc_blend(FrmDecContext* ctx, const RefPicture* refPic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    const int64_t waited = ctx->stats.cycles[STAGE_WAIT];
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(ctx, refPic, dst, dstPitch, x, y, blend);
+    ctx->stats.cycles[STAGE_INTER] += read_cycles() - start - (ctx->stats.cycles[STAGE_WAIT] - waited);
+}
+
+template<PFN_ChromaInterPredBlend DecKernels::*PFN>
+static void prof_chroma_mc_blend(FrmDecContext* ctx, const RefPicture* refPic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    const int64_t waited = ctx->stats.cycles[STAGE_WAIT];
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(ctx, refPic, dstCb, dstCr, dstPitch, x, y, blend);
+    ctx->stats.cycles[STAGE_INTER] += read_cycles() - start - (ctx->stats.cycles[STAGE_WAIT] - waited);
+}
+
+template<PFN_IDCT8x8Add DecKernels::*PFN>
+static void prof_idct_add(const int16_t src[64], uint8_t* dst, int dstPitch)
+{
+    FrmDecContext* ctx = s_ProfCtx;
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(src, dst, dstPitch);
+    ctx->stats.cycles[STAGE_IDCT] += read_cycles() - start;
+}
+
+template<PFN_LoopFilter DecKernels::*PFN>
+static void prof_loop_filter(FrmDecContext* ctx, int my)
+{
+    const int64_t start = read_cycles();
+    (*(ctx->avsCtx->kernels.*PFN))(ctx, my);
+    ctx->stats.cycles[STAGE_LOOP_FILTER] += read_cycles() - start;
+}
+
+const DecKernels g_ProfKernels =
+{
+    {
+        &prof_luma_ipred<0>, &prof_luma_ipred<1>, &prof_luma_ipred<2>,
+        &prof_luma_ipred<3>, &prof_luma_ipred<4>,
+    },
+    {
+        &prof_cbcr_ipred<0>, &prof_cbcr_ipred<1>, &prof_cbcr_ipred<2>, &prof_cbcr_ipred<3>,
+    },
+    &prof_luma_mc<&DecKernels::pfnLumaMC16x16>,
+    &prof_luma_mc<&DecKernels::pfnLumaMC16x8>,
+    &prof_luma_mc<&DecKernels::pfnLumaMC8x16>,
+    &prof_luma_mc<&DecKernels::pfnLumaMC8x8>,
+    &prof_chroma_mc<&DecKernels::pfnChromaMC8x8>,
+    &prof_chroma_mc<&DecKernels::pfnChromaMC8x4>,
+    &prof_chroma_mc<&DecKernels::pfnChromaMC4x8>,
+    &prof_chroma_mc<&DecKernels::pfnChromaMC4x4>,
+    &prof_luma_mc_blend<&DecKernels::pfnLumaMCBlend16x16>,
+    &prof_luma_mc_blend<&DecKernels::pfnLumaMCBlend16x8>,
+    &prof_luma_mc_blend<&DecKernels::pfnLumaMCBlend8x16>,
+    &prof_luma_mc_blend<&DecKernels::pfnLumaMCBlend8x8>,
+    &prof_chroma_mc_blend<&DecKernels::pfnChromaMCBlend8x8>,
+    &prof_chroma_mc_blend<&DecKernels::pfnChromaMCBlend8x4>,
+    &prof_chroma_mc_blend<&DecKernels::pfnChromaMCBlend4x8>,
+    &prof_chroma_mc_blend<&DecKernels::pfnChromaMCBlend4x4>,
+    &prof_idct_add<&DecKernels::pfnIdct8x8Add>,
+    &prof_idct_add<&DecKernels::pfnIdct8x8AddDC>,
+    &prof_idct_add<&DecKernels::pfnIdct8x8Add4x4>,
+    &prof_idct_add<&DecKernels::pfnIdct16x8Add>,
+    &prof_loop_filter<&DecKernels::pfnLoopFilterI>,
+    &prof_loop_filter<&DecKernels::pfnLoopFilterPB>,
+};
+
+}   // namespace irk_avs_dec
@@ -0,0 +1,589 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+#include "AvsDecoder.h"
+
+namespace irk_avs_dec {
+
+void padding_mb_row(FrmDecContext* ctx, int my);
+void notify_decoded_rows(FrmDecContext* ctx, int line);
+
+// 重建命令类型
+enum
+{
+    RC_LUMA_MC = 0,     // 亮度分量帧间预测
+    RC_CHROMA_MC,       // 色差分量帧间预测
+    RC_LUMA_MC_BLEND,   // 亮度分量帧间预测, 同时加权及取平均
+    RC_CHROMA_MC_BLEND, // 色差分量帧间预测, 同时加权及取平均
+    RC_LUMA_IPRED,      // 亮度分量帧内预测
+    RC_CBCR_IPRED,      // 色差分量帧内预测
+    RC_IDCT_ADD,        // 反变换并叠加, 之后附加反量化后的系数
+    RC_LOOP_FILTER,     // 宏块行环路滤波, 之后附加该行的 MbContext
+    RC_PADDING,         // 填充宏块行左右边界
+    RC_PROGRESS,        // 发布解码进度
+    RC_MB_BEGIN,        // 宏块开始, 用于同步相邻宏块行的重建进度
+    RC_ROW_BEGIN,       // 宏块行开始, 之后附加 ReconRow
+    RC_END,             // 解析结束
+    RC_NEXT_CHUNK,      // 当前缓存块结束, 转到下一缓存块
+};
+
+// 重建命令, 按 16 字节对齐存储, 附加数据紧随其后
+struct ReconCmd
+{
+    uint8_t     op;         // 命令类型
+    uint8_t     func;       // 函数索引, 如块大小, 帧内预测模式等
+    int16_t     refIdx;     // 参考帧索引
+    int32_t     pitch;      // 目标 pitch
+    int32_t     arg[5];     // 其他参数
+    uint8_t*    dst[2];     // 目标地址
+};
+
+// 宏块行的回放状态, 作为 RC_ROW_BEGIN 的附加数据存放在命令缓存中, 该行的命令紧随其后
+struct ReconRow
+{
+    ReconChunk*     chunk;      // 该行第一条命令所在的缓存块
+    int             pos;        // 该行第一条命令在缓存块内的位置
+    int             row;        // 宏块行
+    volatile int    mbDone;     // 已重建的宏块数, INT32_MAX 表示该行所有命令都已回放
+};
+
+static const int kCmdSize = (sizeof(ReconCmd) + 15) & ~15;
+static const int kChunkSize = 256 * 1024;
+
+// 命令的附加数据, 16 字节对齐
+static inline uint8_t* cmd_payload(const ReconCmd* cmd)
+{
+    return (uint8_t*)cmd + kCmdSize;
+}
+
+// 当前线程正在记录的重建任务, 用于没有 FrmDecContext 参数的像素处理函数
+static thread_local ReconJob* s_CurRecJob = nullptr;
+
+//======================================================================================================================
+// 记录函数, 解析线程调用, 只记录命令不处理像素
+
+template<int FUNC>
+static void record_luma_mc(FrmDecContext* ctx, const RefPicture* refPic, uint8_t* dst, int dstPitch, int x, int y)
+{
+    assert(refPic >= ctx->refPics && refPic < ctx->refPics + 4);
+    ReconCmd* cmd = ctx->reconJob->alloc_cmd(RC_LUMA_MC, FUNC, 0);
+    cmd->refIdx = (int16_t)(refPic - ctx->refPics);
+    cmd->pitch = dstPitch;
+    cmd->arg[0] = x;
+    cmd->arg[1] = y;
+    cmd->dst[0] = dst;
+}
+
+template<int FUNC>
+static void record_chroma_mc(FrmDecContext* ctx, const RefPicture* refPic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y)
+{
+    assert(refPic >= ctx->refPics && refPic < ctx->refPics + 4);
+    ReconCmd* cmd = ctx->reconJob->alloc_cmd(RC_CHROMA_MC, FUNC, 0);
+    cmd->refIdx = (int16_t)(refPic - ctx->refPics);
+    cmd->pitch = dstPitch;
+    cmd->arg[0] = x;
+    cmd->arg[1] = y;
+    cmd->dst[0] = dstCb;
+    cmd->dst[1] = dstCr;
+}
+
+template<int FUNC>
+static void record_luma_mc_blend(FrmDecContext* ctx, const RefPicture* refPic, uint8_t* dst, int dstPitch,
+    int x, int y, const McBlend* blend)
+{
+    assert(refPic >= ctx->refPics && refPic < ctx->refPics + 4);
+    ReconCmd* cmd = ctx->reconJob->alloc_cmd(RC_LUMA_MC_BLEND, FUNC, 0);
+    cmd->refIdx = (int16_t)(refPic - ctx->refPics);
+    cmd->pitch = dstPitch;
+    cmd->arg[0] = x;
+    cmd->arg[1] = y;
+    cmd->arg[2] = blend->mode;
+    cmd->arg[3] = blend->scale;
+    cmd->arg[4] = blend->delta;
+    cmd->dst[0] = dst;
+}
+
+template<int FUNC>
+static void record_chroma_mc_blend(FrmDecContext* ctx, const RefPicture* refPic,
+    uint8_t* dstCb, uint8_t* dstCr, int dstPitch, int x, int y, const McBlend* blend)
+{
+    assert(refPic >= ctx->refPics && refPic < ctx->refPics + 4);
+    ReconCmd* cmd = ctx->reconJob->alloc_cmd(RC_CHROMA_MC_BLEND, FUNC, 0);
+    cmd->refIdx = (int16_t)(refPic - ctx->refPics);
+    cmd->pitch = dstPitch;
+    cmd->arg[0] = x;
+    cmd->arg[1] = y;
+    cmd->arg[2] = blend->mode;
+    cmd->arg[3] = blend->scale;
+    cmd->arg[4] = blend->delta;
+    cmd->dst[0] = dstCb;
+    cmd->dst[1] = dstCr;
+}
+
+template<int FUNC>
+static void record_luma_ipred(uint8_t* dst, int pitch, NBUsable usable)
+{
+    ReconCmd* cmd = s_CurRecJob->alloc_cmd(RC_LUMA_IPRED, FUNC, 0);
+    cmd->pitch = pitch;
+    cmd->arg[0] = (int32_t)usable.u32;
+    cmd->dst[0] = dst;
+}
+
+template<int FUNC>
+static void record_cbcr_ipred(uint8_t* dst, int pitch, NBUsable usable)
+{
+    ReconCmd* cmd = s_CurRecJob->alloc_cmd(RC_CBCR_IPRED, FUNC, 0);
+    cmd->pitch = pitch;
+    cmd->arg[0] = (int32_t)usable.u32;
+    cmd->dst[0] = dst;
+}
+
+// 各反变换函数读取的系数个数: 8x8, 只有 DC, 左上角 4x4, 两个 8x8
+static const int s_IdctCoeffCnt[4] = {64, 1, 32, 128};
+
+template<int FUNC>
+static void record_idct_add(const int16_t src[64], uint8_t* dst, int dstPitch)
+{
+    const int bytes = s_IdctCoeffCnt[FUNC] * sizeof(int16_t);
+    ReconCmd* cmd = s_CurRecJob->alloc_cmd(RC_IDCT_ADD, FUNC, bytes);
+    cmd->pitch = dstPitch;
+    cmd->dst[0] = dst;
+    memcpy(cmd_payload(cmd), src, bytes);       // 系数缓存会被后续宏块重用, 需要复制
+}
+
+// 环路滤波只读取当前宏块行的 MbContext, 复制一份以便解析线程继续使用宏块行存储区
+template<int FUNC>
+static void record_loop_filter(FrmDecContext* ctx, int my)
+{
+    const int mbCnt = ctx->mbColCnt + 2;
+    ReconCmd* cmd = ctx->reconJob->alloc_cmd(RC_LOOP_FILTER, FUNC, mbCnt * sizeof(MbContext));
+    cmd->arg[0] = my;
+    memcpy(cmd_payload(cmd), ctx->topMbBuf[(my & 1) ^ 1], mbCnt * sizeof(MbContext));
+}
+
+const DecKernels g_RecordKernels =
+{
+    {
+        &record_luma_ipred<0>, &record_luma_ipred<1>, &record_luma_ipred<2>,
+        &record_luma_ipred<3>, &record_luma_ipred<4>,
+    },
+    {
+        &record_cbcr_ipred<0>, &record_cbcr_ipred<1>, &record_cbcr_ipred<2>, &record_cbcr_ipred<3>,
+    },
+    &record_luma_mc<0>,
+    &record_luma_mc<1>,
+    &record_luma_mc<2>,
+    &record_luma_mc<3>,
+    &record_chroma_mc<0>,
+    &record_chroma_mc<1>,
+    &record_chroma_mc<2>,
+    &record_chroma_mc<3>,
+    &record_luma_mc_blend<0>,
+    &record_luma_mc_blend<1>,
+    &record_luma_mc_blend<2>,
+    &record_luma_mc_blend<3>,
+    &record_chroma_mc_blend<0>,
+    &record_chroma_mc_blend<1>,
+    &record_chroma_mc_blend<2>,
+    &record_chroma_mc_blend<3>,
+    &record_idct_add<0>,
+    &record_idct_add<1>,
+    &record_idct_add<2>,
+    &record_idct_add<3>,
+    &record_loop_filter<0>,
+    &record_loop_filter<1>,
+};
+
+//======================================================================================================================
+
+static ReconChunk* alloc_recon_chunk()
+{
+    ReconChunk* chunk = new ReconChunk;
+    chunk->next = nullptr;
+    chunk->data = (uint8_t*)irk::aligned_malloc(kChunkSize, 16);
+    return chunk;
+}
+
+ReconJob::ReconJob(FrmDecContext* ctx, int workerCnt) : mainCtx(ctx), writePos(0), readyCnt(0), nextRow(0), idleCnt(0),
+    finished(false), progWaiters(0)
+{
+    assert(workerCnt > 0);
+    for (int i = 0; i < workerCnt; i++)
+        this->workers.push_back(new FrmDecContext);
+    this->chunkList = alloc_recon_chunk();
+    this->writeChunk = this->chunkList;
+}
+
+ReconJob::~ReconJob()
+{
+    assert(this->tasks.empty());
+    for (size_t i = 0; i < this->workers.size(); i++)
+        delete this->workers[i];
+
+    ReconChunk* chunk = this->chunkList;
+    while (chunk)
+    {
+        ReconChunk* next = chunk->next;
+        irk::aligned_free(chunk->data);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+// 开始解析帧/场, 启动重建任务
+void ReconJob::start()
+{
+    assert(this->tasks.empty() && s_CurRecJob == nullptr);
+    this->writeChunk = this->chunkList;
+    this->writePos = 0;
+    this->readyCnt = 0;
+    this->nextRow = 0;
+    this->idleCnt = 0;
+    this->finished = false;
+    this->progWaiters = 0;
+    this->rows.clear();
+    s_CurRecJob = this;
+
+    const int taskCnt = (int)this->workers.size();
+    this->doneEvt.reset(taskCnt);
+    for (int i = 0; i < taskCnt; i++)
+    {
+        ReconTask* task = new ReconTask(this, this->workers[i]);
+        task->add_ref();
+        this->tasks.push_back(task);
+        this->mainCtx->avsCtx->threadPool->run_task(task);
+    }
+}
+
+// 解析结束, 当前线程参与重建, 等待重建完成
+void ReconJob::finish()
+{
+    assert(s_CurRecJob == this);
+    s_CurRecJob = nullptr;
+    this->alloc_cmd(RC_END, 0, 0);          // 最后一个宏块行的命令到此结束
+
+    irk::Mutex::Guard guard_(this->mutex);
+    this->readyCnt = (int)this->rows.size();
+    this->finished = true;
+    if (this->idleCnt > 0)
+        this->dataCond.notify_all();
+    guard_.unlock();
+
+    // 取消尚未开始运行的任务, 这些任务不会再访问 job, 当前线程使用其 context 回放剩余的宏块行
+    FrmDecContext* freeCtx = nullptr;
+    for (size_t i = 0; i < this->tasks.size(); i++)
+    {
+        if (this->tasks[i]->cancel())
+        {
+            this->doneEvt.dec();
+            if (freeCtx == nullptr)
+                freeCtx = this->workers[i];
+        }
+        this->tasks[i]->dismiss();
+    }
+    this->tasks.clear();
+    if (freeCtx)
+        this->replay(freeCtx);
+    this->doneEvt.wait();
+
+    // 重建 context 不持有帧引用
+    for (size_t i = 0; i < this->workers.size(); i++)
+    {
+        FrmDecContext* worker = this->workers[i];
+        this->mainCtx->stats.merge(worker->stats);
+        worker->curFrame = nullptr;
+        worker->refFrames[0] = nullptr;
+        worker->refFrames[1] = nullptr;
+    }
+}
+
+// 分配命令空间, payload 为命令之后附加数据的字节数
+ReconCmd* ReconJob::alloc_cmd(int op, int func, int payload)
+{
+    const int size = kCmdSize + ((payload + 15) & ~15);
+    assert(size + kCmdSize <= kChunkSize);
+
+    // 当前缓存块剩余空间不足, 保留 kCmdSize 字节用以记录 RC_NEXT_CHUNK
+    if (this->writePos + size + kCmdSize > kChunkSize)
+    {
+        ReconCmd* cmd = (ReconCmd*)(this->writeChunk->data + this->writePos);
+        cmd->op = RC_NEXT_CHUNK;
+        if (this->writeChunk->next == nullptr)
+            this->writeChunk->next = alloc_recon_chunk();
+        this->writeChunk = this->writeChunk->next;
+        this->writePos = 0;
+    }
+
+    ReconCmd* cmd = (ReconCmd*)(this->writeChunk->data + this->writePos);
+    cmd->op = (uint8_t)op;
+    cmd->func = (uint8_t)func;
+    this->writePos += size;
+    return cmd;
+}
+
+// 宏块行的第一个宏块开始新的宏块行, 此时上一宏块行(包括其后的环路滤波, 边界填充等)已解析完成, 可以被领取
+void ReconJob::record_mb(int mx, int my)
+{
+    if (mx != 0)
+    {
+        ReconCmd* cmd = this->alloc_cmd(RC_MB_BEGIN, 0, 0);
+        cmd->arg[0] = mx;
+        return;
+    }
+
+    ReconCmd* cmd = this->alloc_cmd(RC_ROW_BEGIN, 0, sizeof(ReconRow));
+    ReconRow* row = (ReconRow*)cmd_payload(cmd);
+    row->chunk = this->writeChunk;
+    row->pos = this->writePos;
+    row->row = my;
+    row->mbDone = 0;
+
+    irk::Mutex::Guard guard_(this->mutex);
+    this->rows.push_back(row);
+    this->readyCnt = (int)this->rows.size() - 1;
+    if (this->idleCnt > 0 && this->nextRow < this->readyCnt)
+        this->dataCond.notify_one();
+}
+
+void ReconJob::record_padding(int my)
+{
+    ReconCmd* cmd = this->alloc_cmd(RC_PADDING, 0, 0);
+    cmd->arg[0] = my;
+}
+
+void ReconJob::record_progress(int line)
+{
+    ReconCmd* cmd = this->alloc_cmd(RC_PROGRESS, 0, 0);
+    cmd->arg[0] = line;
+}
+
+// 更新宏块行的重建进度, 进度只增不减
+void ReconJob::set_row_progress(ReconRow* row, int mbCnt)
+{
+    irk::atomic_store(&row->mbDone, mbCnt);
+
+    // 与 wait_row_progress 中的 progWaiters 增加构成 Dekker 式同步: 要么更新者看到等待者, 要么等待者看到新进度
+    atomic_full_fence();
+    if (irk::atomic_load(&this->progWaiters) > 0)
+    {
+        irk::Mutex::Guard guard_(this->mutex);
+        this->progCond.notify_all();
+    }
+}
+
+// 等待宏块行重建完 mbCnt 个宏块, 先自旋, 仍未满足则阻塞
+void ReconJob::wait_row_progress(const ReconRow* row, int mbCnt)
+{
+    if (irk::atomic_load(&row->mbDone) >= mbCnt)
+        return;
+
+    // 相邻宏块行的重建速度相差不大, 短暂自旋可以避免大部分线程切换
+    for (int i = 0; i < 1024; i++)
+    {
+        atomic_cpu_pause();
+        if (irk::atomic_load(&row->mbDone) >= mbCnt)
+            return;
+    }
+
+    irk::Mutex::Guard guard_(this->mutex);
+    irk::atomic_inc(&this->progWaiters);
+    while (irk::atomic_load(&row->mbDone) < mbCnt)
+        this->progCond.wait(this->mutex);
+    irk::atomic_dec(&this->progWaiters);
+}
+
+// 逐一领取已解析完成的宏块行并回放其命令, 直到解析结束并且所有宏块行都已领取
+void ReconJob::replay(FrmDecContext* ctx)
+{
+    const DecKernels* kernels = ctx->profiling ? &g_ProfKernels : &this->mainCtx->avsCtx->kernels;
+    FrmDecContext* prevCtx = set_prof_context(ctx);
+    const PFN_LumaInterPred lumaMC[4] =
+    {
+        kernels->pfnLumaMC16x16, kernels->pfnLumaMC16x8, kernels->pfnLumaMC8x16, kernels->pfnLumaMC8x8,
+    };
+    const PFN_ChromaInterPred chromaMC[4] =
+    {
+        kernels->pfnChromaMC8x8, kernels->pfnChromaMC8x4, kernels->pfnChromaMC4x8, kernels->pfnChromaMC4x4,
+    };
+    const PFN_LumaInterPredBlend lumaMCBlend[4] =
+    {
+        kernels->pfnLumaMCBlend16x16, kernels->pfnLumaMCBlend16x8,
+        kernels->pfnLumaMCBlend8x16, kernels->pfnLumaMCBlend8x8,
+    };
+    const PFN_ChromaInterPredBlend chromaMCBlend[4] =
+    {
+        kernels->pfnChromaMCBlend8x8, kernels->pfnChromaMCBlend8x4,
+        kernels->pfnChromaMCBlend4x8, kernels->pfnChromaMCBlend4x4,
+    };
+    const PFN_IDCT8x8Add idctAdd[4] =
+    {
+        kernels->pfnIdct8x8Add, kernels->pfnIdct8x8AddDC, kernels->pfnIdct8x8Add4x4, kernels->pfnIdct16x8Add,
+    };
+    const PFN_LoopFilter loopFilter[2] = {kernels->pfnLoopFilterI, kernels->pfnLoopFilterPB};
+
+    // 只有一个重建线程时宏块行总是按顺序逐一回放, 不需要同步
+    const bool wavefront = this->workers.size() > 1;
+    const int mbColCnt = ctx->mbColCnt;
+    while (1)
+    {
+        // 领取下一个已解析完成的宏块行
+        irk::Mutex::Guard guard_(this->mutex);
+        while (this->nextRow == this->readyCnt && !this->finished)
+        {
+            this->idleCnt++;
+            this->dataCond.wait(this->mutex);
+            this->idleCnt--;
+        }
+        if (this->nextRow == this->readyCnt)
+            break;
+        ReconRow* row = this->rows[this->nextRow];
+        const ReconRow* prev = (wavefront && this->nextRow > 0) ? this->rows[this->nextRow - 1] : nullptr;
+        this->nextRow++;
+        guard_.unlock();
+
+        // 错误码流中 slice 的起始行可能不连续, 上一个领取的宏块行不是上方的宏块行, 等待之前的宏块行全部回放
+        if (prev && prev->row + 1 != row->row)
+        {
+            this->wait_row_progress(prev, INT32_MAX);
+            prev = nullptr;
+        }
+
+        ReconChunk* chunk = row->chunk;
+        int readPos = row->pos;
+        int mbIdx = 0;                  // 当前宏块在宏块行中的位置
+        bool inTail = false;            // 是否已回放到宏块之后的环路滤波, 边界填充等命令
+        bool rowEnd = false;
+        while (!rowEnd)
+        {
+            const ReconCmd* cmd = (const ReconCmd*)(chunk->data + readPos);
+            int size = kCmdSize;
+            NBUsable usable;
+            McBlend blend;
+
+            // 环路滤波会修改上方宏块行的像素, 边界填充和进度发布依赖环路滤波的结果,
+            // 这些命令必须在之前的宏块行全部回放后才能开始, 以保持解析时的顺序
+            if (prev && !inTail && cmd->op >= RC_LOOP_FILTER && cmd->op <= RC_PROGRESS)
+            {
+                this->set_row_progress(row, mbColCnt);
+                this->wait_row_progress(prev, INT32_MAX);
+                inTail = true;
+            }
+
+            switch (cmd->op)
+            {
+            case RC_LUMA_MC:
+                (*lumaMC[cmd->func])(ctx, ctx->refPics + cmd->refIdx, cmd->dst[0], cmd->pitch, cmd->arg[0], cmd->arg[1]);
+                break;
+            case RC_CHROMA_MC:
+                (*chromaMC[cmd->func])(ctx, ctx->refPics + cmd->refIdx,
+                    cmd->dst[0], cmd->dst[1], cmd->pitch, cmd->arg[0], cmd->arg[1]);
+                break;
+            case RC_LUMA_MC_BLEND:
+                blend.mode = cmd->arg[2];
+                blend.scale = cmd->arg[3];
+                blend.delta = cmd->arg[4];
+                (*lumaMCBlend[cmd->func])(ctx, ctx->refPics + cmd->refIdx,
+                    cmd->dst[0], cmd->pitch, cmd->arg[0], cmd->arg[1], &blend);
+                break;
+            case RC_CHROMA_MC_BLEND:
+                blend.mode = cmd->arg[2];
+                blend.scale = cmd->arg[3];
+                blend.delta = cmd->arg[4];
+                (*chromaMCBlend[cmd->func])(ctx, ctx->refPics + cmd->refIdx,
+                    cmd->dst[0], cmd->dst[1], cmd->pitch, cmd->arg[0], cmd->arg[1], &blend);
+                break;
+            case RC_LUMA_IPRED:
+                if (prev)   // 帧内预测读取上方和右上方宏块的像素
+                    this->wait_row_progress(prev, std::min(mbIdx + 2, mbColCnt));
+                usable.u32 = (uint32_t)cmd->arg[0];
+                (*kernels->pfnLumaIPred[cmd->func])(cmd->dst[0], cmd->pitch, usable);
+                break;
+            case RC_CBCR_IPRED:
+                if (prev)
+                    this->wait_row_progress(prev, std::min(mbIdx + 2, mbColCnt));
+                usable.u32 = (uint32_t)cmd->arg[0];
+                (*kernels->pfnCbCrIPred[cmd->func])(cmd->dst[0], cmd->pitch, usable);
+                break;
+            case RC_IDCT_ADD:
+                (*idctAdd[cmd->func])((const int16_t*)cmd_payload(cmd), cmd->dst[0], cmd->pitch);
+                size += (s_IdctCoeffCnt[cmd->func] * sizeof(int16_t) + 15) & ~15;
+                break;
+            case RC_LOOP_FILTER:
+            {
+                const int my = cmd->arg[0];
+                const int bytes = (mbColCnt + 2) * sizeof(MbContext);
+                memcpy(ctx->topMbBuf[(my & 1) ^ 1], cmd_payload(cmd), bytes);
+                (*loopFilter[cmd->func])(ctx, my);
+                size += (bytes + 15) & ~15;
+                break;
+            }
+            case RC_PADDING:
+                padding_mb_row(ctx, cmd->arg[0]);
+                break;
+            case RC_PROGRESS:
+                ctx->curFrame->decState->update_state(cmd->arg[0]);
+                if (ctx->avsCtx->rowNotify)
+                    notify_decoded_rows(ctx, cmd->arg[0]);
+                break;
+            case RC_MB_BEGIN:
+                mbIdx = cmd->arg[0];
+                if (wavefront)
+                    this->set_row_progress(row, mbIdx);
+                break;
+            case RC_ROW_BEGIN:
+            case RC_END:
+                rowEnd = true;
+                break;
+            case RC_NEXT_CHUNK:
+                size = kChunkSize - readPos;
+                break;
+            default:
+                assert(0);
+                break;
+            }
+
+            readPos += size;
+            if (readPos == kChunkSize)
+            {
+                chunk = chunk->next;
+                readPos = 0;
+            }
+        }
+
+        // 没有帧内预测和环路滤波等命令的宏块行不会等待上一宏块行, 此处仍需等待,
+        // 使 INT32_MAX 总是表示该行及之前的宏块行都已回放完成, 解码进度依赖这一点
+        if (prev && !inTail)
+        {
+            this->set_row_progress(row, mbColCnt);
+            this->wait_row_progress(prev, INT32_MAX);
+        }
+        if (wavefront)
+            this->set_row_progress(row, INT32_MAX);
+    }
+
+    set_prof_context(prevCtx);
+}
+
+// 重建任务
+void ReconTask::work()
+{
+    // 任务可能已被取消, 此时 job 可能已被重用
+    if (irk::atomic_compare_swap(&m_state, 0, 1) != 0)
+        return;
+
+    m_job->replay(m_ctx);
+    m_job->doneEvt.dec();
+}
+
+}   // namespace irk_avs_dec
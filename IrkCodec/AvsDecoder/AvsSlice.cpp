@@ -17,12 +17,82 @@ namespace irk_avs_dec {
 
 void dec_macroblock_I8x8(FrmDecContext* ctx, int mx, int my);
 void dec_macroblock_PSkip(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P16x16(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P16x8(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P8x16(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P8x8(FrmDecContext* ctx, int mx, int my);
 void dec_macroblock_BSkip(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_BDirect(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B16x16(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B16x8(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B8x16(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B8x8(FrmDecContext* ctx, int mx, int my);
 void dec_macroblock_I8x8_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P16x16_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P16x8_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P8x16_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_P8x8_AEC(FrmDecContext* ctx, int mx, int my);
 void dec_macroblock_BSkip_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_BDirect_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B16x16_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B16x8_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B8x16_AEC(FrmDecContext* ctx, int mx, int my);
+void dec_macroblock_B8x8_AEC(FrmDecContext* ctx, int mx, int my);
+
+// P 宏块解码, ctx->mbTypeIdx 取值 [0, 4], 直接调用以免经过函数指针
+template<int AEC>
+static inline void dec_macroblock_P(FrmDecContext* ctx, int mx, int my)
+{
+    switch (ctx->mbTypeIdx)
+    {
+    case 0:
+        dec_macroblock_PSkip(ctx, mx, my);
+        break;
+    case 1:
+        AEC ? dec_macroblock_P16x16_AEC(ctx, mx, my) : dec_macroblock_P16x16(ctx, mx, my);
+        break;
+    case 2:
+        AEC ? dec_macroblock_P16x8_AEC(ctx, mx, my) : dec_macroblock_P16x8(ctx, mx, my);
+        break;
+    case 3:
+        AEC ? dec_macroblock_P8x16_AEC(ctx, mx, my) : dec_macroblock_P8x16(ctx, mx, my);
+        break;
+    default:
+        AEC ? dec_macroblock_P8x8_AEC(ctx, mx, my) : dec_macroblock_P8x8(ctx, mx, my);
+        break;
+    }
+}
 
-void loop_filterI_sse4(FrmDecContext* ctx, int my);
-void loop_filterPB_sse4(FrmDecContext* ctx, int my);
+// B 宏块解码, ctx->mbTypeIdx 取值 [0, 23]
+// 2~4 为 16x16, 5~22 中奇数为 16x8, 偶数为 8x16, 23 为 8x8
+template<int AEC>
+static inline void dec_macroblock_B(FrmDecContext* ctx, int mx, int my)
+{
+    const int mbType = ctx->mbTypeIdx;
+    switch (mbType)
+    {
+    case 0:
+        AEC ? dec_macroblock_BSkip_AEC(ctx, mx, my) : dec_macroblock_BSkip(ctx, mx, my);
+        break;
+    case 1:
+        AEC ? dec_macroblock_BDirect_AEC(ctx, mx, my) : dec_macroblock_BDirect(ctx, mx, my);
+        break;
+    case 2:
+    case 3:
+    case 4:
+        AEC ? dec_macroblock_B16x16_AEC(ctx, mx, my) : dec_macroblock_B16x16(ctx, mx, my);
+        break;
+    case 23:
+        AEC ? dec_macroblock_B8x8_AEC(ctx, mx, my) : dec_macroblock_B8x8(ctx, mx, my);
+        break;
+    default:
+        if (mbType & 1)
+            AEC ? dec_macroblock_B16x8_AEC(ctx, mx, my) : dec_macroblock_B16x8(ctx, mx, my);
+        else
+            AEC ? dec_macroblock_B8x16_AEC(ctx, mx, my) : dec_macroblock_B8x16(ctx, mx, my);
+        break;
+    }
+}
 
 // 重置宏块 context
 static inline void reset_mbctx(MbContext* ctx)
@@ -43,6 +113,21 @@ static inline void reset_mbctx(MbContext* ctx)
     ctx->mvs[1][1].i32 = 0;
 }
 
+void notify_decoded_rows(FrmDecContext* ctx, int line);
+
+// 发布解码进度, rowEnd 之前的宏块行已解码完成
+static inline void publish_progress(FrmDecContext* ctx, int rowEnd, int mbHeight)
+{
+    if (ctx->reconJob)  // 两级流水线或 wavefront 模式, 重建线程回放到此处时才发布解码进度
+        ctx->reconJob->record_progress(rowEnd * mbHeight);
+    else
+    {
+        ctx->curFrame->decState->update_state(rowEnd * mbHeight);
+        if (ctx->avsCtx->rowNotify)
+            notify_decoded_rows(ctx, rowEnd * mbHeight);
+    }
+}
+
 // 重置一行 MbContext, 针对 I Slice
 static void reset_top_mbs_I(MbContext* ctxLine, int mbCnt)
 {
@@ -76,13 +161,21 @@ static void reset_top_mbs_PB(MbContext* ctxLine, int mbCnt)
     }
 }
 
-// 填充参考帧左右边界, 方便进行运动补偿
-static void padding_edge(FrmDecContext* ctx, int my)
+void convert_mb_row(FrmDecContext* ctx, int my);
+
+// 填充宏块行 my 的左右边界
+// 此时宏块行已完成环路滤波, 如果输出格式不是 I420, 趁数据仍在缓存中同时转换为输出格式
+void padding_mb_row(FrmDecContext* ctx, int my)
 {
-    if (my < 0 || my >= ctx->mbRowCnt)
-    {
+    if (ctx->avsCtx->rowConvert)
+        convert_mb_row(ctx, my);
+
+    // 低分辨率解码时帧间预测直接限制参考坐标的范围, 不需要边界填充
+    // 关闭边界填充时, 超出图像的参考块在帧间预测时按需扩展
+    if (ctx->resShift != 0 || !ctx->avsCtx->edgePadding)
         return;
-    }
+
+    const int64_t start = ctx->profiling ? read_cycles() : 0;
 
     // luma
     int width = ctx->picWidth;
@@ -118,12 +211,37 @@ static void padding_edge(FrmDecContext* ctx, int my)
         *(uint32_as*)(dstCr + width) = *(uint32_as*)(dstCr + width + 4) = dstCr[width - 1] * 0x01010101u;
         dstCr += pitch;
     }
+
+    if (ctx->profiling)
+        ctx->stats.cycles[STAGE_PADDING] += read_cycles() - start;
+}
+
+// 两级流水线或 wavefront 模式下标记宏块开始, 重建线程据此划分宏块行并同步相邻宏块行的重建进度
+static inline void begin_macroblock(FrmDecContext* ctx, int mx, int my)
+{
+    if (ctx->reconJob)
+        ctx->reconJob->record_mb(mx, my);
+}
+
+// 填充参考帧左右边界, 方便进行运动补偿
+static inline void padding_edge(FrmDecContext* ctx, int my)
+{
+    if (my < 0 || my >= ctx->mbRowCnt)
+    {
+        return;
+    }
+
+    if (ctx->reconJob)  // 两级流水线或 wavefront 模式, 由重建线程填充
+        ctx->reconJob->record_padding(my);
+    else
+        padding_mb_row(ctx, my);
 }
 
 //======================================================================================================================
 
-// I 帧或者 I 场解码
-void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
+// I 帧或者 I 场解码, LF_ENABLE 表示是否进行环路滤波
+template<int LF_ENABLE>
+static void dec_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -140,6 +258,7 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
             return;
         }
     }
+    const int firstRow = my;            // 当前 slice 的第一个宏块行
 
     AvsBitStream& bitsm = ctx->bitsm;
     bitsm.set_buffer(data + 4, size - 4);
@@ -167,10 +286,10 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
 
     // 解码进度, 用以并行解码
     assert(ctx->curFrame->decState);
-    DecodingState* decState = ctx->curFrame->decState;
+    int readyRow = firstRow;            // 此行之前的宏块行已发布解码进度
     int mbHeight = 0;                   // 按帧计算的宏块高度
     int lfDelay = 0;                    // 环路滤波引起的延时
-    if (ctx->avsCtx->threadCnt > 1)     // 并行解码
+    if (ctx->avsCtx->threadCnt > 1 || ctx->avsCtx->rowNotify)  // 并行解码, 或者需要逐行通知
     {
         if (ctx->frameCoding == 0)      // 场编码视频
         {
@@ -181,13 +300,13 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
         {
             mbHeight = 16;
         }
-        if (ctx->lfDisabled == 0)
+        if (LF_ENABLE)
         {
             lfDelay = 2;
         }
     }
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     ctx->errCode = 0;
     ctx->mbTypeIdx = 0;         // I Macroblock with CBP
 
@@ -195,6 +314,7 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
     while (1)
     {
         // 宏块解码
+        begin_macroblock(ctx, mx, my);
         dec_macroblock_I8x8(ctx, mx, my);
 
         // 检测到解码错误后立即结束当前 slice 的解码
@@ -203,19 +323,19 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
 
         if (++mx == ctx->mbColCnt)  // 到达当前宏块行末尾
         {
-            if (my >= lfMy)
+            if (LF_ENABLE && my >= lfMy)
             {
-                loop_filterI_sse4(ctx, my - 1);     // 环路滤波
+                (*ctx->kernels->pfnLoopFilterI)(ctx, my - 1);     // 环路滤波
                 padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
             }
             else
             {
-                padding_edge(ctx, my);      // 填充边界方便后续帧间预测
+                padding_edge(ctx, my);              // 填充边界方便后续帧间预测
             }
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())    // 查看是否已到 slice 末尾
+            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())     // 查看是否已到 slice 末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -227,29 +347,41 @@ void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
             ctx->leftMb.curQp = -127;
 
             // 更新解码进度
-            if (mbHeight > 0 && my > lfDelay)
+            if (mbHeight > 0 && my - lfDelay > readyRow)
             {
-                decState->update_state((my - lfDelay) * mbHeight);
+                publish_progress(ctx, my - lfDelay, mbHeight);
+                readyRow = my - lfDelay;
             }
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterI_sse4(ctx, my - 1);     // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterI)(ctx, my - 1);     // 最后一行环路滤波
         padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
         padding_edge(ctx, my - 1);
     }
 
     // 更新解码进度
-    if (mbHeight > 0)
+    if (mbHeight > 0 && my > readyRow)
     {
-        decState->update_state(my * mbHeight);
+        publish_progress(ctx, my, mbHeight);
     }
 }
 
-// P 帧或者 P 场解码
-void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
+// I 帧或者 I 场解码
+void decode_slice_I(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    if (ctx->lfDisabled)
+        dec_slice_I<0>(ctx, data, size);
+    else
+        dec_slice_I<1>(ctx, data, size);
+}
+
+// P 帧或者 P 场解码, SKIP_MODE 即 skip_mode_flag, LF_ENABLE 表示是否进行环路滤波
+// 这些条件在 slice 内不变, 作为模板参数以去除宏块循环中的分支
+template<int SKIP_MODE, int LF_ENABLE>
+static void dec_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -266,6 +398,7 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
             return;
         }
     }
+    const int firstRow = my;            // 当前 slice 的第一个宏块行
 
     AvsBitStream& bitsm = ctx->bitsm;
     bitsm.set_buffer(data + 4, size - 4);
@@ -313,10 +446,10 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
 
     // 解码进度, 用以并行解码
     assert(ctx->curFrame->decState);
-    DecodingState* decState = ctx->curFrame->decState;
+    int readyRow = firstRow;            // 此行之前的宏块行已发布解码进度
     int mbHeight = 0;                   // 按帧计算的宏块高度
     int lfDelay = 0;                    // 环路滤波引起的延时
-    if (ctx->avsCtx->threadCnt > 1)     // 并行解码
+    if (ctx->avsCtx->threadCnt > 1 || ctx->avsCtx->rowNotify)  // 并行解码, 或者需要逐行通知
     {
         if (ctx->frameCoding == 0)      // 场编码视频
         {
@@ -327,27 +460,26 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
         {
             mbHeight = 16;
         }
-        if (ctx->lfDisabled == 0)
+        if (LF_ENABLE)
         {
             lfDelay = 2;
         }
     }
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
-    const int skipModeFlag = ctx->picHdr.skip_mode_flag;
-    PFN_DecodeMB* pfnDecMb = ctx->avsCtx->pfnDecMbP;
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     ctx->errCode = 0;
 
     // 宏块逐一解码
     while (1)
     {
-        if (skipModeFlag)
+        if (SKIP_MODE)
         {
             int skipCnt = bitsm.read_ue16();     // mb_skip_run
 
             // P-Skip 宏块解析
             while (skipCnt-- > 0)
             {
+                begin_macroblock(ctx, mx, my);
                 dec_macroblock_PSkip(ctx, mx, my);
                 *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
                 *(int16_as*)(ctx->leftMb.ipMode) = -1;
@@ -355,19 +487,19 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
                 if (++mx == ctx->mbColCnt)     // 到达当前宏块行末尾
                 {
                     // 环路滤波
-                    if (my >= lfMy)
+                    if (LF_ENABLE && my >= lfMy)
                     {
-                        loop_filterPB_sse4(ctx, my - 1);
-                        padding_edge(ctx, my - 2);      // 填充边界方便后续帧间预测
+                        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
+                        padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
                     }
                     else
                     {
-                        padding_edge(ctx, my);          // 填充边界方便后续帧间预测
+                        padding_edge(ctx, my);              // 填充边界方便后续帧间预测
                     }
 
                     mx = 0;
                     my++;
-                    if (my >= ctx->mbRowCnt)            // 是否已到图像末尾
+                    if (my >= ctx->mbRowCnt)             // 是否已到图像末尾
                         break;
 
                     ctx->topLine = ctx->curLine;
@@ -375,9 +507,10 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
                     reset_mbctx(&ctx->leftMb);     // 重置左边界
 
                     // 更新解码进度
-                    if (mbHeight > 0 && my > lfDelay)
+                    if (mbHeight > 0 && my - lfDelay > readyRow)
                     {
-                        decState->update_state((my - lfDelay) * mbHeight);
+                        publish_progress(ctx, my - lfDelay, mbHeight);
+                        readyRow = my - lfDelay;
                     }
                 }
             }
@@ -393,6 +526,7 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
             ctx->mbTypeIdx = bitsm.read_ue8();
         }
 
+        begin_macroblock(ctx, mx, my);
         if (ctx->mbTypeIdx >= 5)   // I_8x8
         {
             // I 宏块解码
@@ -409,7 +543,7 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
         else
         {
             // P 宏块解码
-            (*pfnDecMb[ctx->mbTypeIdx])(ctx, mx, my);
+            dec_macroblock_P<0>(ctx, mx, my);
             *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
             *(int16_as*)(ctx->leftMb.ipMode) = -1;
         }
@@ -421,19 +555,19 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
         if (++mx == ctx->mbColCnt)         // 下一宏块到达当前宏块行末尾
         {
             // 环路滤波
-            if (my >= lfMy)
+            if (LF_ENABLE && my >= lfMy)
             {
-                loop_filterPB_sse4(ctx, my - 1);
-                padding_edge(ctx, my - 2);     // 填充边界方便后续帧间预测
+                (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
+                padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
             }
             else
             {
-                padding_edge(ctx, my);         // 填充边界方便后续帧间预测
+                padding_edge(ctx, my);              // 填充边界方便后续帧间预测
             }
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())   // 是否已到图像末尾
+            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())      // 是否已到图像末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -441,29 +575,43 @@ void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
             reset_mbctx(&ctx->leftMb);     // 重置左边界
 
             // 更新解码进度
-            if (mbHeight > 0 && my > lfDelay)
+            if (mbHeight > 0 && my - lfDelay > readyRow)
             {
-                decState->update_state((my - lfDelay) * mbHeight);
+                publish_progress(ctx, my - lfDelay, mbHeight);
+                readyRow = my - lfDelay;
             }
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterPB_sse4(ctx, my - 1);    // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);    // 最后一行环路滤波
         padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
         padding_edge(ctx, my - 1);
     }
 
     // 更新解码进度
-    if (mbHeight > 0)
+    if (mbHeight > 0 && my > readyRow)
     {
-        decState->update_state(my * mbHeight);
+        publish_progress(ctx, my, mbHeight);
     }
 }
 
-// B 帧或者 B 场解码
-void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
+// P 帧或者 P 场解码
+void decode_slice_P(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    static const PFN_DecodeSlice s_DecSlice[2][2] = {
+        {&dec_slice_P<0, 0>, &dec_slice_P<0, 1>},
+        {&dec_slice_P<1, 0>, &dec_slice_P<1, 1>},
+    };
+    const int skipMode = ctx->picHdr.skip_mode_flag ? 1 : 0;
+    const int lfEnable = ctx->lfDisabled ? 0 : 1;
+    (*s_DecSlice[skipMode][lfEnable])(ctx, data, size);
+}
+
+// B 帧或者 B 场解码, SKIP_MODE 即 skip_mode_flag, LF_ENABLE 表示是否进行环路滤波
+template<int SKIP_MODE, int LF_ENABLE>
+static void dec_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -519,21 +667,20 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
         ctx->mbWPFlag = bitsm.read1();
     }
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
-    const int skipModeFlag = ctx->picHdr.skip_mode_flag;
-    PFN_DecodeMB* pfnDecMb = ctx->avsCtx->pfnDecMbB;
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     ctx->errCode = 0;
 
     // 宏块逐一解码
     while (1)
     {
-        if (skipModeFlag)
+        if (SKIP_MODE)
         {
             int skipCnt = bitsm.read_ue16();    // mb_skip_run
 
             // B-Skip 宏块解析
             while (skipCnt-- > 0)
             {
+                begin_macroblock(ctx, mx, my);
                 dec_macroblock_BSkip(ctx, mx, my);
                 *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
                 *(int16_as*)(ctx->leftMb.ipMode) = -1;
@@ -541,12 +688,12 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
                 if (++mx == ctx->mbColCnt)      // 到达当前宏块行末尾
                 {
                     // 环路滤波
-                    if (my >= lfMy)
-                        loop_filterPB_sse4(ctx, my - 1);
+                    if (LF_ENABLE && my >= lfMy)
+                        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
 
                     mx = 0;
                     my++;
-                    if (my >= ctx->mbRowCnt)    // 是否已到图像末尾
+                    if (my >= ctx->mbRowCnt)     // 是否已到图像末尾
                         break;
 
                     ctx->topLine = ctx->curLine;
@@ -566,6 +713,7 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
             ctx->mbTypeIdx = bitsm.read_ue8();
         }
 
+        begin_macroblock(ctx, mx, my);
         if (ctx->mbTypeIdx >= 24)   // I_8x8
         {
             dec_macroblock_I8x8(ctx, mx, my);
@@ -585,7 +733,7 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
         else
         {
             // B 宏块解码
-            (*pfnDecMb[ctx->mbTypeIdx])(ctx, mx, my);
+            dec_macroblock_B<0>(ctx, mx, my);
             *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
             *(int16_as*)(ctx->leftMb.ipMode) = -1;
         }
@@ -597,12 +745,12 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
         if (++mx == ctx->mbColCnt)     // 到达当前宏块行末尾
         {
             // 环路滤波
-            if (my >= lfMy)
-                loop_filterPB_sse4(ctx, my - 1);
+            if (LF_ENABLE && my >= lfMy)
+                (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())   // 是否已到图像末尾
+            if (my >= ctx->mbRowCnt || bitsm.is_end_of_slice())      // 是否已到图像末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -611,17 +759,30 @@ void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterPB_sse4(ctx, my - 1);    // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);    // 最后一行环路滤波
     }
 }
 
+// B 帧或者 B 场解码
+void decode_slice_B(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    static const PFN_DecodeSlice s_DecSlice[2][2] = {
+        {&dec_slice_B<0, 0>, &dec_slice_B<0, 1>},
+        {&dec_slice_B<1, 0>, &dec_slice_B<1, 1>},
+    };
+    const int skipMode = ctx->picHdr.skip_mode_flag ? 1 : 0;
+    const int lfEnable = ctx->lfDisabled ? 0 : 1;
+    (*s_DecSlice[skipMode][lfEnable])(ctx, data, size);
+}
+
 //======================================================================================================================
 // 以下为高级熵编码
 
-// I 帧或者 I 场解码
-void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+// I 帧或者 I 场解码, LF_ENABLE 表示是否进行环路滤波
+template<int LF_ENABLE>
+static void dec_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -637,6 +798,7 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             return;
         }
     }
+    const int firstRow = my;            // 当前 slice 的第一个宏块行
 
     // 重置边界
     ctx->topLine = ctx->topMbBuf[my & 1] + 1;
@@ -667,10 +829,10 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 
     // 解码进度, 用以并行解码
     assert(ctx->curFrame->decState);
-    DecodingState* decState = ctx->curFrame->decState;
+    int readyRow = firstRow;            // 此行之前的宏块行已发布解码进度
     int mbHeight = 0;                   // 按帧计算的宏块高度
     int lfDelay = 0;                    // 环路滤波引起的延时
-    if (ctx->avsCtx->threadCnt > 1)     // 并行解码
+    if (ctx->avsCtx->threadCnt > 1 || ctx->avsCtx->rowNotify)  // 并行解码, 或者需要逐行通知
     {
         if (ctx->frameCoding == 0)      // 场编码视频
         {
@@ -681,7 +843,7 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         {
             mbHeight = 16;
         }
-        if (ctx->lfDisabled == 0)
+        if (LF_ENABLE)
         {
             lfDelay = 2;
         }
@@ -691,7 +853,7 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
     parser->make_byte_aligned();
     parser->init();
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     ctx->errCode = 0;
     ctx->mbTypeIdx = 0;         // I Macroblock with CBP
 
@@ -699,6 +861,7 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
     while (1)
     {
         // 宏块解码
+        begin_macroblock(ctx, mx, my);
         dec_macroblock_I8x8_AEC(ctx, mx, my);
 
         // 检测到解码错误后立即结束当前 slice 的解码
@@ -711,9 +874,9 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 
         if (++mx == ctx->mbColCnt)                  // 到达当前宏块行末尾
         {
-            if (my >= lfMy)
+            if (LF_ENABLE && my >= lfMy)
             {
-                loop_filterI_sse4(ctx, my - 1);     // 环路滤波
+                (*ctx->kernels->pfnLoopFilterI)(ctx, my - 1);     // 环路滤波
                 padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
             }
             else
@@ -723,7 +886,7 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())  // 查看是否已到 slice 末尾
+            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())     // 查看是否已到 slice 末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -737,30 +900,41 @@ void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             ctx->leftMb.curQp = -127;
 
             // 更新解码进度
-            if (mbHeight > 0 && my > lfDelay)
+            if (mbHeight > 0 && my - lfDelay > readyRow)
             {
-                decState->update_state((my - lfDelay) * mbHeight);
+                publish_progress(ctx, my - lfDelay, mbHeight);
+                readyRow = my - lfDelay;
             }
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterI_sse4(ctx, my - 1);     // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterI)(ctx, my - 1);     // 最后一行环路滤波
         padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
         padding_edge(ctx, my - 1);
     }
     padding_edge(ctx, my);
 
     // 更新解码进度
-    if (mbHeight > 0)
+    if (mbHeight > 0 && my > readyRow)
     {
-        decState->update_state(my * mbHeight);
+        publish_progress(ctx, my, mbHeight);
     }
 }
 
-// P 帧或者 P 场解码
-void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+// I 帧或者 I 场解码
+void decode_slice_I_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    if (ctx->lfDisabled)
+        dec_slice_I_AEC<0>(ctx, data, size);
+    else
+        dec_slice_I_AEC<1>(ctx, data, size);
+}
+
+// P 帧或者 P 场解码, SKIP_MODE 即 skip_mode_flag, LF_ENABLE 表示是否进行环路滤波
+template<int SKIP_MODE, int LF_ENABLE>
+static void dec_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -776,6 +950,7 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             return;
         }
     }
+    const int firstRow = my;            // 当前 slice 的第一个宏块行
 
     // 重置边界
     ctx->topLine = ctx->topMbBuf[my & 1] + 1;
@@ -825,10 +1000,10 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 
     // 解码进度, 用以并行解码
     assert(ctx->curFrame->decState);
-    DecodingState* decState = ctx->curFrame->decState;
+    int readyRow = firstRow;            // 此行之前的宏块行已发布解码进度
     int mbHeight = 0;                   // 按帧计算的宏块高度
     int lfDelay = 0;                    // 环路滤波引起的延时
-    if (ctx->avsCtx->threadCnt > 1)     // 并行解码
+    if (ctx->avsCtx->threadCnt > 1 || ctx->avsCtx->rowNotify)  // 并行解码, 或者需要逐行通知
     {
         if (ctx->frameCoding == 0)      // 场编码视频
         {
@@ -839,7 +1014,7 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         {
             mbHeight = 16;
         }
-        if (ctx->lfDisabled == 0)
+        if (LF_ENABLE)
         {
             lfDelay = 2;
         }
@@ -849,15 +1024,13 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
     parser->make_byte_aligned();
     parser->init();
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
-    const int skipModeFlag = ctx->picHdr.skip_mode_flag;
-    PFN_DecodeMB* pfnDecMb = ctx->avsCtx->pfnDecMbP_AEC;
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     ctx->errCode = 0;
 
     // 宏块逐一解码
     while (1)
     {
-        if (skipModeFlag)
+        if (SKIP_MODE)
         {
             // mb_skip_run
             int skipCnt = parser->dec_mb_skip_run();
@@ -865,6 +1038,7 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             {
                 while (skipCnt-- > 0)   // P-Skip 宏块解析
                 {
+                    begin_macroblock(ctx, mx, my);
                     dec_macroblock_PSkip(ctx, mx, my);
                     *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
                     *(int16_as*)(ctx->leftMb.ipMode) = -1;
@@ -872,19 +1046,19 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
                     if (++mx == ctx->mbColCnt)          // 到达当前宏块行末尾
                     {
                         // 环路滤波
-                        if (my >= lfMy)
+                        if (LF_ENABLE && my >= lfMy)
                         {
-                            loop_filterPB_sse4(ctx, my - 1);
-                            padding_edge(ctx, my - 2);  // 填充边界方便后续帧间预测
+                            (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
+                            padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
                         }
                         else
                         {
-                            padding_edge(ctx, my);      // 填充边界方便后续帧间预测
+                            padding_edge(ctx, my);              // 填充边界方便后续帧间预测
                         }
 
                         mx = 0;
                         my++;
-                        if (my >= ctx->mbRowCnt)        // 是否已到图像末尾
+                        if (my >= ctx->mbRowCnt)         // 是否已到图像末尾
                             break;
 
                         ctx->topLine = ctx->curLine;
@@ -893,9 +1067,10 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
                         *(uint64_as*)(ctx->mvdA[0]) = 0;
 
                         // 更新解码进度
-                        if (mbHeight > 0 && my > lfDelay)
+                        if (mbHeight > 0 && my - lfDelay > readyRow)
                         {
-                            decState->update_state((my - lfDelay) * mbHeight);
+                            publish_progress(ctx, my - lfDelay, mbHeight);
+                            readyRow = my - lfDelay;
                         }
                     }
                 }
@@ -940,6 +1115,7 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             }
         }
 
+        begin_macroblock(ctx, mx, my);
         if (ctx->mbTypeIdx == 5)   // I_8x8
         {
             // I 宏块解码
@@ -959,7 +1135,7 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         else
         {
             // P 宏块解码
-            (*pfnDecMb[ctx->mbTypeIdx])(ctx, mx, my);
+            dec_macroblock_P<1>(ctx, mx, my);
 
             MbContext* curMb = ctx->curLine + mx;
             *(int16_as*)(curMb->ipMode) = -1;
@@ -979,19 +1155,19 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         if (++mx == ctx->mbColCnt)          // 下一宏块到达当前宏块行末尾
         {
             // 环路滤波
-            if (my >= lfMy)
+            if (LF_ENABLE && my >= lfMy)
             {
-                loop_filterPB_sse4(ctx, my - 1);
-                padding_edge(ctx, my - 2);  // 填充边界方便后续帧间预测
+                (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
+                padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
             }
             else
             {
-                padding_edge(ctx, my);      // 填充边界方便后续帧间预测
+                padding_edge(ctx, my);              // 填充边界方便后续帧间预测
             }
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())   // 是否已到图像末尾
+            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())      // 是否已到图像末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -1000,30 +1176,44 @@ void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             *(uint64_as*)(ctx->mvdA[0]) = 0;
 
             // 更新解码进度
-            if (mbHeight > 0 && my > lfDelay)
+            if (mbHeight > 0 && my - lfDelay > readyRow)
             {
-                decState->update_state((my - lfDelay) * mbHeight);
+                publish_progress(ctx, my - lfDelay, mbHeight);
+                readyRow = my - lfDelay;
             }
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterPB_sse4(ctx, my - 1);    // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);    // 最后一行环路滤波
         padding_edge(ctx, my - 2);          // 填充边界方便后续帧间预测
         padding_edge(ctx, my - 1);
     }
     padding_edge(ctx, my);
 
     // 更新解码进度
-    if (mbHeight > 0)
+    if (mbHeight > 0 && my > readyRow)
     {
-        decState->update_state(my * mbHeight);
+        publish_progress(ctx, my, mbHeight);
     }
 }
 
-// B 帧或者 B 场解码
-void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+// P 帧或者 P 场解码
+void decode_slice_P_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    static const PFN_DecodeSlice s_DecSlice[2][2] = {
+        {&dec_slice_P_AEC<0, 0>, &dec_slice_P_AEC<0, 1>},
+        {&dec_slice_P_AEC<1, 0>, &dec_slice_P_AEC<1, 1>},
+    };
+    const int skipMode = ctx->picHdr.skip_mode_flag ? 1 : 0;
+    const int lfEnable = ctx->lfDisabled ? 0 : 1;
+    (*s_DecSlice[skipMode][lfEnable])(ctx, data, size);
+}
+
+// B 帧或者 B 场解码, SKIP_MODE 即 skip_mode_flag, LF_ENABLE 表示是否进行环路滤波
+template<int SKIP_MODE, int LF_ENABLE>
+static void dec_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
 {
     assert(ctx->curFrame);
     assert((*(uint32_t*)data & 0xFFFFFF) == 0x010000);
@@ -1085,22 +1275,21 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
     parser->make_byte_aligned();
     parser->init();
 
-    const int lfMy = ctx->lfDisabled ? INT32_MAX : my + 1;  // 环路滤波开始宏块行
-    const int skipModeFlag = ctx->picHdr.skip_mode_flag;
-    PFN_DecodeMB* pfnDecMb = ctx->avsCtx->pfnDecMbB_AEC;
+    const int lfMy = my + 1;    // 环路滤波开始宏块行
     MbContext* leftMb = &ctx->leftMb;
     ctx->errCode = 0;
 
     // 宏块逐一解码
     while (1)
     {
-        if (skipModeFlag)
+        if (SKIP_MODE)
         {
             int skipCnt = parser->dec_mb_skip_run();    // mb_skip_run
             if (skipCnt > 0)
             {
                 while (skipCnt-- > 0)       // B-Skip 宏块解析
                 {
+                    begin_macroblock(ctx, mx, my);
                     dec_macroblock_BSkip_AEC(ctx, mx, my);
                     *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
                     *(int16_as*)(leftMb->ipMode) = -1;
@@ -1108,12 +1297,12 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
                     if (++mx == ctx->mbColCnt)      // 到达当前宏块行末尾
                     {
                         // 环路滤波
-                        if (my >= lfMy)
-                            loop_filterPB_sse4(ctx, my - 1);
+                        if (LF_ENABLE && my >= lfMy)
+                            (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
 
                         mx = 0;
                         my++;
-                        if (my >= ctx->mbRowCnt)    // 是否已到图像末尾
+                        if (my >= ctx->mbRowCnt)     // 是否已到图像末尾
                             break;
 
                         ctx->topLine = ctx->curLine;
@@ -1155,6 +1344,7 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
             }
         }
 
+        begin_macroblock(ctx, mx, my);
         if (ctx->mbTypeIdx == 24)  // I_8x8
         {
             dec_macroblock_I8x8_AEC(ctx, mx, my);
@@ -1179,7 +1369,7 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         else
         {
             // B 宏块解码
-            (*pfnDecMb[ctx->mbTypeIdx])(ctx, mx, my);
+            dec_macroblock_B<1>(ctx, mx, my);
             *(int16_as*)(ctx->curLine[mx].ipMode) = -1;
             *(int16_as*)(leftMb->ipMode) = -1;
         }
@@ -1195,12 +1385,12 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         if (++mx == ctx->mbColCnt)  // 到达当前宏块行末尾
         {
             // 环路滤波
-            if (my >= lfMy)
-                loop_filterPB_sse4(ctx, my - 1);
+            if (LF_ENABLE && my >= lfMy)
+                (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);
 
             mx = 0;
             my++;
-            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())   // 是否已到图像末尾
+            if (my >= ctx->mbRowCnt || parser->is_end_of_slice())      // 是否已到图像末尾
                 break;
 
             ctx->topLine = ctx->curLine;
@@ -1210,10 +1400,22 @@ void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
         }
     }
 
-    if (my >= lfMy)
+    if (LF_ENABLE && my >= lfMy)
     {
-        loop_filterPB_sse4(ctx, my - 1);    // 最后一行环路滤波
+        (*ctx->kernels->pfnLoopFilterPB)(ctx, my - 1);    // 最后一行环路滤波
     }
 }
 
+// B 帧或者 B 场解码
+void decode_slice_B_AEC(FrmDecContext* ctx, const uint8_t* data, int size)
+{
+    static const PFN_DecodeSlice s_DecSlice[2][2] = {
+        {&dec_slice_B_AEC<0, 0>, &dec_slice_B_AEC<0, 1>},
+        {&dec_slice_B_AEC<1, 0>, &dec_slice_B_AEC<1, 1>},
+    };
+    const int skipMode = ctx->picHdr.skip_mode_flag ? 1 : 0;
+    const int lfEnable = ctx->lfDisabled ? 0 : 1;
+    (*s_DecSlice[skipMode][lfEnable])(ctx, data, size);
+}
+
 }   // namespace irk_avs_dec
@@ -0,0 +1,69 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+
+#include <smmintrin.h>      // SSE4.1
+#include "AvsDecoder.h"
+#include "AvsBitstream.h"
+
+extern "C" int get_sse_version();
+
+namespace irk_avs_dec {
+
+// 查找 00 00 01(起始码) 或 00 00 02(伪起始码), 返回其开始位置, 找不到返回 size
+// 每次检测 16 个位置, 绝大多数数据块不含 0 字节, 只需一次比较即可跳过
+int find_sc_candidate_sse4(const uint8_t* data, int size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    int i = 0;
+    for (; i + 18 <= size; i += 16)
+    {
+        __m128i xm0 = _mm_loadu_si128((const __m128i*)(data + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(xm0, zero));
+        if (mask == 0)
+            continue;
+
+        __m128i xm1 = _mm_loadu_si128((const __m128i*)(data + i + 1));
+        __m128i xm2 = _mm_loadu_si128((const __m128i*)(data + i + 2));
+        xm2 = _mm_sub_epi8(xm2, one);                               // 0x1, 0x2 -> 0x0, 0x1
+        xm1 = _mm_cmpeq_epi8(xm1, zero);
+        xm2 = _mm_cmpeq_epi8(_mm_min_epu8(xm2, one), xm2);
+        mask &= _mm_movemask_epi8(_mm_and_si128(xm1, xm2));
+        if (mask != 0)
+            return i + irk::lsb_index_unzero((uint32_t)mask);
+    }
+
+    for (; i + 2 < size; i++)
+    {
+        if (data[i] == 0 && data[i + 1] == 0 && (uint8_t)(data[i + 2] - 1) <= 1)
+            return i;
+    }
+    return size;
+}
+
+// AVX2 版本编译时同时允许生成 BMI2 指令, 与解码器的选择条件一致
+static PFN_FindScCandidate select_find_sc_candidate()
+{
+    return (get_sse_version() >= 502) ? &find_sc_candidate_avx2 : &find_sc_candidate_sse4;
+}
+
+// 查找 00 00 01(起始码) 或 00 00 02(伪起始码), 返回其开始位置, 找不到返回 size
+// 不依赖解码器, 第一次调用时检测 CPU 特性
+int find_sc_candidate(const uint8_t* data, int size)
+{
+    static const PFN_FindScCandidate pfnFind = select_find_sc_candidate();
+    return (*pfnFind)(data, size);
+}
+
+}   // namespace irk_avs_dec
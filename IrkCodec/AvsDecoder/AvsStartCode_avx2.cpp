@@ -0,0 +1,68 @@
+﻿/*
+* This Source Code Form is subject to the terms of the Mozilla Public License Version 2.0.
+* If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+
+* Covered Software is provided on an "as is" basis,
+* without warranty of any kind, either expressed, implied, or statutory,
+* that the Covered Software is free of defects, merchantable,
+* fit for a particular purpose or non-infringing.
+
+* Copyright (c) Wei Dongliang <illigle@163.com>.
+*/
+
+
+// 本文件单独使用 AVX2 编译选项, 只能被运行时检测到 AVX2 支持后调用
+// 注意: 不要在本文件中调用头文件中的非 static inline 函数, 避免链接时与 SSE 版本混淆
+
+#include <immintrin.h>      // AVX2
+#include "AvsDecoder.h"
+#include "AvsBitstream.h"
+
+namespace irk_avs_dec {
+
+// 最低的非 0 比特位置, value 不能为 0
+static inline int first_set_bit(uint32_t value)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, value);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// 查找 00 00 01(起始码) 或 00 00 02(伪起始码), 返回其开始位置, 找不到返回 size
+// 每次检测 32 个位置
+int find_sc_candidate_avx2(const uint8_t* data, int size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    int i = 0;
+    for (; i + 34 <= size; i += 32)
+    {
+        __m256i ym0 = _mm256_loadu_si256((const __m256i*)(data + i));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ym0, zero));
+        if (mask == 0)
+            continue;
+
+        __m256i ym1 = _mm256_loadu_si256((const __m256i*)(data + i + 1));
+        __m256i ym2 = _mm256_loadu_si256((const __m256i*)(data + i + 2));
+        ym2 = _mm256_sub_epi8(ym2, one);                            // 0x1, 0x2 -> 0x0, 0x1
+        ym1 = _mm256_cmpeq_epi8(ym1, zero);
+        ym2 = _mm256_cmpeq_epi8(_mm256_min_epu8(ym2, one), ym2);
+        mask &= (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(ym1, ym2));
+        if (mask != 0)
+            return i + first_set_bit(mask);
+    }
+
+    for (; i + 2 < size; i++)
+    {
+        if (data[i] == 0 && data[i + 1] == 0 && (uint8_t)(data[i + 2] - 1) <= 1)
+            return i;
+    }
+    return size;
+}
+
+}   // namespace irk_avs_dec
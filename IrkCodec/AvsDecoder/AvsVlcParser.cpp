@@ -368,179 +368,186 @@ static const struct VLCMap s_ChromaVlcTab[5] =
     }
 };
 
+// 根据当前 level 下一个 chroma vlc map 索引
+static const uint8_t s_ChromaNextIdx[8] = {1, 1, 2, 3, 3, 4, 4, 4};
+
 //======================================================================================================================
-bool AvsVlcParser::dec_intra_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
+// 查找表: 由后续 8 比特直接得到短码字对应的 (level, run) 和下一个 VLC 表索引,
+// 码字超过 8 比特或者为转义码时按常规方式解析
+
+struct VLCLutEntry
 {
-    int16_t levelAry[65];   // 最多 64 个系数 + EOB
-    uint8_t runAry[65];
-    const VLCMap* vlc = s_IntraVlcTab;
-    int i = 0;
-    for (; i < 65; i++)
+    int8_t  level;          // 0 表示 EOB
+    uint8_t run;
+    uint8_t len;            // 码字长度, 0 表示需按常规方式解析
+    uint8_t next;           // 下一个 VLC 表索引
+};
+
+typedef VLCLutEntry VLCLut[256];
+
+struct VLCLutTables
+{
+    VLCLut  intra[7];
+    VLCLut  inter[7];
+    VLCLut  chroma[5];
+
+    VLCLutTables()
     {
-        int code = bitsm.read_egk(vlc->order);
-        if (code >= 59)
+        build(intra, s_IntraVlcTab, 7);
+        build(inter, s_InterVlcTab, 7);
+        build(chroma, s_ChromaVlcTab, 5);
+    }
+
+    // 用常规解析方式解析每个 8 比特组合, 保证查找表与常规方式结果一致
+    static void build(VLCLut* luts, const VLCMap* vlcTab, int tabCnt)
+    {
+        for (int t = 0; t < tabCnt; t++)
         {
-            int run = (code - 59) >> 1;
-            int msk = -(code & 1);                  // -1 or 0
-            int diff = bitsm.read_egk(1);         // escape_level_diff
-            int level = diff + (run > vlc->maxRun ? 1 : vlc->refAbsLevel[run]);
-            levelAry[i] = (level ^ msk) - msk;
-            runAry[i] = run + 1;
-            if (level > 10)
-            {
-                vlc = s_IntraVlcTab + 6;
-            }
-            else
+            for (int bits = 0; bits < 256; bits++)
             {
-                const VLCMap* nextVlc = s_IntraVlcTab + s_IntraNextIdx[level];
-                if (nextVlc > vlc)     // 只前进不后退
-                    vlc = nextVlc;
+                VLCLutEntry& entry = luts[t][bits];
+                entry = VLCLutEntry();
+
+                uint8_t buf[8] = {(uint8_t)bits, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+                AvsBitStream bitsm(buf, sizeof(buf));
+                int code = bitsm.read_egk(vlcTab[t].order);
+                int len = (int)bitsm.offset();
+                if (len > 8 || code >= 59)
+                    continue;
+
+                entry.level = vlcTab[t].levelRunInc[code][0];
+                entry.run = vlcTab[t].levelRunInc[code][1];
+                entry.len = (uint8_t)len;
+                entry.next = (uint8_t)(t + vlcTab[t].levelRunInc[code][2]);
             }
         }
-        else
-        {
-            int level = vlc->levelRunInc[code][0];
-            if (level == 0)        // EOB
-                break;
-            levelAry[i] = level;
-            runAry[i] = vlc->levelRunInc[code][1];
-            vlc += vlc->levelRunInc[code][2];
-        }
-    }
-    if (i >= 65)            // 码流错误
-        return false;
-
-    zero_block8x8(coeff);
-    int rnd = 1 << (shift - 1);
-    int k = -1;
-    while (--i >= 0)
-    {
-        k += runAry[i];
-        if (k >= 64)        // 码流错误
-            return false;
-        int idx = m_invScan[k];
-        int tmp = ((levelAry[i] * m_weightQM[idx] >> 3) * scale) >> 4;
-        coeff[idx] = (int16_t)((tmp + rnd) >> shift);
     }
+};
 
-    return true;
-}
+static const VLCLutTables s_VlcLut;
 
-bool AvsVlcParser::dec_inter_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
+// 解析 (level, run) 序列直到 EOB, 返回系数个数, 码流错误返回 -1
+// 查找表命中时直接从一次 peek() 得到的数据中连续解析, 只在剩余位数不足时重新读取
+template<int ESC_ORDER, int MAX_LEVEL>
+static int dec_level_run(AvsBitStream& bitsm, const VLCMap* vlcTab, const VLCLut* luts, const uint8_t* nextIdx,
+                         int lastIdx, int16_t* levelAry, uint8_t* runAry)
 {
-    int16_t levelAry[65];       // 最多 64 个系数 + EOB
-    uint8_t runAry[65];
-    const VLCMap* vlc = s_InterVlcTab;
-    int i = 0;
-    for (; i < 65; i++)
+    int t = 0;                          // 当前 VLC 表索引
+    uint32_t bits = bitsm.peek();       // 至少 25 位有效
+    int used = 0;                       // bits 中已解析的位数
+    for (int i = 0; i < 65; i++)
     {
+        if (used > 17)                  // 保证至少 8 位有效
+        {
+            bitsm.skip_bits(used);
+            bits = bitsm.peek();
+            used = 0;
+        }
+
+        const VLCLutEntry& entry = luts[t][(bits << used) >> 24];
+        if (entry.len != 0)
+        {
+            used += entry.len;
+            if (entry.level == 0)       // EOB
+            {
+                bitsm.skip_bits(used);
+                return i;
+            }
+            levelAry[i] = entry.level;
+            runAry[i] = entry.run;
+            t = entry.next;
+            continue;
+        }
+
+        // 长码字或者转义码
+        bitsm.skip_bits(used);
+        const VLCMap* vlc = vlcTab + t;
         int code = bitsm.read_egk(vlc->order);
         if (code >= 59)
         {
             int run = (code - 59) >> 1;
-            int msk = -(code & 1);              // -1 or 0
-            int diff = bitsm.read_egk(0);       // escape_level_diff
+            int msk = -(code & 1);                      // -1 or 0
+            int diff = bitsm.read_egk(ESC_ORDER);       // escape_level_diff
             int level = diff + (run > vlc->maxRun ? 1 : vlc->refAbsLevel[run]);
             levelAry[i] = (level ^ msk) - msk;
             runAry[i] = run + 1;
-            if (level > 9)
-            {
-                vlc = s_InterVlcTab + 6;
-            }
-            else
-            {
-                const VLCMap* tmp = s_InterVlcTab + s_InterNextIdx[level];
-                if (tmp > vlc)      // 只前进不后退
-                    vlc = tmp;
-            }
+            if (level > MAX_LEVEL)
+                t = lastIdx;
+            else if (nextIdx[level] > t)                // 只前进不后退
+                t = nextIdx[level];
         }
         else
         {
             int level = vlc->levelRunInc[code][0];
-            if (level == 0)         // EOB
-                break;
+            if (level == 0)             // EOB
+                return i;
             levelAry[i] = level;
             runAry[i] = vlc->levelRunInc[code][1];
-            vlc += vlc->levelRunInc[code][2];
+            t += vlc->levelRunInc[code][2];
         }
+        bits = bitsm.peek();
+        used = 0;
     }
-    if (i >= 65)           // 码流错误
-        return false;
 
+    bitsm.skip_bits(used);
+    return -1;                          // 码流错误
+}
+
+// 反扫描并反量化, 返回非零系数的分布
+static int dequant_coeff_block(int16_t* coeff, const int16_t* levelAry, const uint8_t* runAry, int cnt,
+                               const uint8_t* invScan, const uint8_t* weightQM, int scale, uint8_t shift)
+{
     zero_block8x8(coeff);
     int rnd = 1 << (shift - 1);
+    int nzMask = 0;
     int k = -1;
+    int i = cnt;
     while (--i >= 0)
     {
         k += runAry[i];
         if (k >= 64)        // 码流错误
-            return false;
-        int idx = m_invScan[k];
-        int tmp = ((levelAry[i] * m_weightQM[idx] >> 3) * scale) >> 4;
+            return COEFF_ERROR;
+        int idx = invScan[k];
+        int tmp = ((levelAry[i] * weightQM[idx] >> 3) * scale) >> 4;
         coeff[idx] = (int16_t)((tmp + rnd) >> shift);
+        nzMask |= (coeff[idx] != 0) ? (idx | 64) : 0;
     }
 
-    return true;
+    return coeff_shape(nzMask);
 }
 
-bool AvsVlcParser::dec_chroma_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
+//======================================================================================================================
+int AvsVlcParser::dec_intra_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
 {
-    // 根据当前 level 下一个 chroma vlc map 索引
-    static const uint8_t s_ChromaNextIdx[8] = {1, 1, 2, 3, 3, 4, 4, 4};
+    int16_t levelAry[65];   // 最多 64 个系数 + EOB
+    uint8_t runAry[65];
+    int cnt = dec_level_run<1, 10>(bitsm, s_IntraVlcTab, s_VlcLut.intra, s_IntraNextIdx, 6, levelAry, runAry);
+    if (cnt < 0)            // 码流错误
+        return COEFF_ERROR;
+
+    return dequant_coeff_block(coeff, levelAry, runAry, cnt, m_invScan, m_weightQM, scale, shift);
+}
 
-    int16_t levelAry[65];       // 最多 64 个系数 + EOB
+int AvsVlcParser::dec_inter_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
+{
+    int16_t levelAry[65];   // 最多 64 个系数 + EOB
     uint8_t runAry[65];
-    const VLCMap* vlc = s_ChromaVlcTab;
-    int i = 0;
-    for (; i < 65; i++)
-    {
-        int code = bitsm.read_egk(vlc->order);
-        if (code >= 59)
-        {
-            int run = (code - 59) >> 1;
-            int msk = -(code & 1);              // -1 or 0
-            int diff = bitsm.read_egk(0);       // escape_level_diff
-            int level = diff + (run > vlc->maxRun ? 1 : vlc->refAbsLevel[run]);
-            levelAry[i] = (level ^ msk) - msk;
-            runAry[i] = run + 1;
-            if (level > 4)
-            {
-                vlc = s_ChromaVlcTab + 4;
-            }
-            else
-            {
-                const VLCMap* tmp = s_ChromaVlcTab + s_ChromaNextIdx[level];
-                if (tmp > vlc)      // 只前进不后退
-                    vlc = tmp;
-            }
-        }
-        else
-        {
-            int level = vlc->levelRunInc[code][0];
-            if (level == 0)         // EOB
-                break;
-            levelAry[i] = level;
-            runAry[i] = vlc->levelRunInc[code][1];
-            vlc += vlc->levelRunInc[code][2];
-        }
-    }
-    if (i >= 65)            // 码流错误
-        return false;
+    int cnt = dec_level_run<0, 9>(bitsm, s_InterVlcTab, s_VlcLut.inter, s_InterNextIdx, 6, levelAry, runAry);
+    if (cnt < 0)            // 码流错误
+        return COEFF_ERROR;
 
-    zero_block8x8(coeff);
-    int rnd = 1 << (shift - 1);
-    int k = -1;
-    while (--i >= 0)
-    {
-        k += runAry[i];
-        if (k >= 64)        // 码流错误
-            return false;
-        int idx = m_invScan[k];
-        int tmp = ((levelAry[i] * m_weightQM[idx] >> 3) * scale) >> 4;
-        coeff[idx] = (int16_t)((tmp + rnd) >> shift);
-    }
+    return dequant_coeff_block(coeff, levelAry, runAry, cnt, m_invScan, m_weightQM, scale, shift);
+}
+
+int AvsVlcParser::dec_chroma_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift)
+{
+    int16_t levelAry[65];   // 最多 64 个系数 + EOB
+    uint8_t runAry[65];
+    int cnt = dec_level_run<0, 4>(bitsm, s_ChromaVlcTab, s_VlcLut.chroma, s_ChromaNextIdx, 4, levelAry, runAry);
+    if (cnt < 0)            // 码流错误
+        return COEFF_ERROR;
 
-    return true;
+    return dequant_coeff_block(coeff, levelAry, runAry, cnt, m_invScan, m_weightQM, scale, shift);
 }
 
 }   // namespace irk_avs_dec
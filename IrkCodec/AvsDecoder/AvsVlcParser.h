@@ -30,10 +30,10 @@ public:
         m_weightQM = wqm;
     }
 
-    // 解析 8x8 系数块
-    bool dec_intra_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
-    bool dec_inter_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
-    bool dec_chroma_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
+    // 解析 8x8 系数块, 返回非零系数的分布 CoeffShape, 码流错误返回 COEFF_ERROR(0)
+    int dec_intra_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
+    int dec_inter_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
+    int dec_chroma_coeff_block(int16_t* coeff, AvsBitStream& bitsm, int scale, uint8_t shift);
 
 private:
     const uint8_t*  m_invScan;
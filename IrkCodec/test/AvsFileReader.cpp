@@ -1,15 +1,30 @@
 ﻿#include "AvsFileReader.h"
+#include "IrkAvsDecoder.h"
+#include <string.h>
+#include <algorithm>
 
 #ifndef _MSC_VER
 #define _fseeki64 fseeko
 #endif
 
+#ifndef _WIN32
+#define AVS_READER_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define READ_SIZE (16*1024)
+#define INDEX_READ_SIZE (1024*1024)
 
 AvsFileReader::AvsFileReader()
 {
     m_BufIdx = 0;
     m_pFile = nullptr;
+    m_pMap = nullptr;
+    m_MapLen = 0;
+    m_FileSize = 0;
+    m_MapPos = 0;
 }
 
 AvsFileReader::~AvsFileReader()
@@ -18,10 +33,13 @@ AvsFileReader::~AvsFileReader()
     {
         ::fclose(m_pFile);
     }
+    unmap();
 }
 
-bool AvsFileReader::open(const char* filename)
+bool AvsFileReader::open(const char* filename, bool mapped)
 {
+    unmap();
+
     m_DataBuf[0].clear();
     m_DataBuf[0].reserve(1024 * 128);
     m_DataBuf[1].clear();
@@ -34,7 +52,39 @@ bool AvsFileReader::open(const char* filename)
         m_pFile = nullptr;
     }
     m_pFile = ::fopen(filename, "rb");
-    return m_pFile != nullptr;
+    if (!m_pFile)
+        return false;
+
+#ifdef AVS_READER_MMAP
+    struct stat st;
+    const int fd = ::fileno(m_pFile);
+    if (mapped && ::fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        // 先预留文件长度加填充的匿名内存, 再把文件映射到开始部分, 文件末尾之后就是可读的 0 填充
+        const size_t pageSize = (size_t)::sysconf(_SC_PAGESIZE);
+        const size_t fileLen = ((size_t)st.st_size + pageSize - 1) & ~(pageSize - 1);
+        const size_t mapLen = fileLen + ((IRK_AVS_DEC_INPUT_PADDING + pageSize - 1) & ~(pageSize - 1));
+        void* base = ::mmap(nullptr, mapLen, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+            return true;    // 使用普通读取模式
+        void* data = ::mmap(base, fileLen, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::munmap(base, mapLen);
+            return true;
+        }
+
+        // 顺序读取, 由系统预读
+        ::madvise(data, fileLen, MADV_SEQUENTIAL);
+        m_pMap = (uint8_t*)data;
+        m_MapLen = mapLen;
+        m_FileSize = st.st_size;
+        m_MapPos = 0;
+    }
+#else
+    (void)mapped;
+#endif
+    return true;
 }
 
 void AvsFileReader::close()
@@ -44,6 +94,19 @@ void AvsFileReader::close()
         fclose(m_pFile);
         m_pFile = nullptr;
     }
+    unmap();
+}
+
+void AvsFileReader::unmap()
+{
+#ifdef AVS_READER_MMAP
+    if (m_pMap)
+        ::munmap(m_pMap, m_MapLen);
+#endif
+    m_pMap = nullptr;
+    m_MapLen = 0;
+    m_FileSize = 0;
+    m_MapPos = 0;
 }
 
 int AvsFileReader::seek(int64_t offset)
@@ -51,6 +114,12 @@ int AvsFileReader::seek(int64_t offset)
     m_DataBuf[0].clear();
     m_DataBuf[1].clear();
 
+    if (m_pMap)
+    {
+        if (offset < 0 || offset > m_FileSize)
+            return -1;
+        m_MapPos = offset;
+    }
     if (m_pFile)
     {
         ::rewind(m_pFile);
@@ -59,9 +128,20 @@ int AvsFileReader::seek(int64_t offset)
     return -1;
 }
 
+// 从位置 i 开始查找 start code, 返回其位置, 找不到返回 size, size 之后还有 3 个字节的有效数据
+static inline int next_start_code(const uint8_t* data, int i, int size)
+{
+    if (i >= size)
+        return size;
+    i += irk_avs_find_start_code(data + i, size + 3 - i);
+    return i < size ? i : size;
+}
+
 const uint8_t*  AvsFileReader::get_picture(size_t* psize)
 {
     *psize = 0;
+    if (m_pMap)
+        return get_mapped_picture(psize);
     if (!m_pFile)
         return nullptr;
 
@@ -77,7 +157,7 @@ const uint8_t*  AvsFileReader::get_picture(size_t* psize)
         // search for start code
         if (k < 0)
         {
-            for (; i < size; i++)
+            for (i = next_start_code(data, i, size); i < size; i = next_start_code(data, i + 1, size))
             {
                 uint32_t sc = *(uint32_t*)(data + i);
                 if (sc == 0xB0010000 || sc == 0xB3010000 || sc == 0xB6010000)
@@ -96,7 +176,7 @@ const uint8_t*  AvsFileReader::get_picture(size_t* psize)
             // search for picture header
             if (startCode != 0xB3010000 && startCode != 0xB6010000)
             {
-                for (; i < size; i++)
+                for (i = next_start_code(data, i, size); i < size; i = next_start_code(data, i + 1, size))
                 {
                     uint32_t sc = *(uint32_t*)(data + i);
                     if (sc == 0xB3010000 || sc == 0xB6010000)
@@ -111,7 +191,7 @@ const uint8_t*  AvsFileReader::get_picture(size_t* psize)
             // search for next picture
             if (startCode == 0xB3010000 || startCode == 0xB6010000)
             {
-                for (; i < size; i++)
+                for (i = next_start_code(data, i, size); i < size; i = next_start_code(data, i + 1, size))
                 {
                     uint32_t sc = *(uint32_t*)(data + i);
                     if (sc == 0xB0010000 || sc == 0xB3010000 || sc == 0xB6010000)
@@ -158,3 +238,221 @@ const uint8_t*  AvsFileReader::get_picture(size_t* psize)
     *psize = 0;
     return nullptr;
 }
+
+// 内存映射模式下从位置 pos 开始查找 start code, 返回其位置, 找不到返回 end, end 之后还有 3 个字节的有效数据
+int64_t AvsFileReader::map_next_start_code(int64_t pos, int64_t end) const
+{
+    while (pos < end)
+    {
+        // 分段查找, 相邻两段重叠 3 个字节, 避免遗漏跨越分段边界的 start code
+        const int len = (int)std::min<int64_t>(end + 3 - pos, 1 << 30);
+        const int k = irk_avs_find_start_code(m_pMap + pos, len);
+        if (k < len)
+            return std::min(pos + k, end);
+        pos += len - 3;
+    }
+    return end;
+}
+
+// 内存映射模式下读取一帧数据, 分帧方式与普通读取模式相同
+const uint8_t* AvsFileReader::get_mapped_picture(size_t* psize)
+{
+    const uint8_t* data = m_pMap;
+    const int64_t size = m_FileSize - 3;
+    uint32_t startCode = 0;
+    int64_t i = 0;
+    int64_t k = -1;     // 图像起始位置
+
+    // search for start code
+    for (i = map_next_start_code(m_MapPos, size); i < size; i = map_next_start_code(i + 1, size))
+    {
+        uint32_t sc = *(uint32_t*)(data + i);
+        if (sc == 0xB0010000 || sc == 0xB3010000 || sc == 0xB6010000)
+        {
+            k = i;
+            i += 8;
+            startCode = sc;
+            break;
+        }
+    }
+
+    // search for picture header
+    if (k >= 0 && startCode != 0xB3010000 && startCode != 0xB6010000)
+    {
+        for (i = map_next_start_code(i, size); i < size; i = map_next_start_code(i + 1, size))
+        {
+            uint32_t sc = *(uint32_t*)(data + i);
+            if (sc == 0xB3010000 || sc == 0xB6010000)
+            {
+                i += 8;
+                startCode = sc;
+                break;
+            }
+        }
+    }
+
+    // search for next picture
+    if (k >= 0 && (startCode == 0xB3010000 || startCode == 0xB6010000))
+    {
+        for (i = map_next_start_code(i, size); i < size; i = map_next_start_code(i + 1, size))
+        {
+            uint32_t sc = *(uint32_t*)(data + i);
+            if (sc == 0xB0010000 || sc == 0xB3010000 || sc == 0xB6010000)
+            {
+                m_MapPos = i;
+                *psize = (size_t)(i - k);
+                return data + k;
+            }
+        }
+
+        // 文件末尾的这一帧可能不是完整的一帧
+        if (size > k + 64)
+        {
+            m_MapPos = m_FileSize;
+            *psize = (size_t)(m_FileSize - k);
+            return data + k;
+        }
+    }
+
+    m_MapPos = m_FileSize;
+    return nullptr;
+}
+
+// 读取 picture header 中的比特, picture header 开始的几个字节中极少出现伪起始码, 这里不做处理
+static uint32_t read_hdr_bits(const uint8_t* data, int* bitPos, int bits)
+{
+    uint32_t val = 0;
+    for (int i = 0; i < bits; i++, (*bitPos)++)
+        val = (val << 1) | ((data[*bitPos >> 3] >> (7 - (*bitPos & 7))) & 1);
+    return val;
+}
+
+// 解析 picture header 开始部分, 得到图像类型和 picture_distance, data 指向 start code
+static int parse_pic_type(const uint8_t* data, uint8_t profile, AvsPicIndex* pic)
+{
+    int pos = 32;
+    read_hdr_bits(data, &pos, 16);      // bbv_delay
+    if (profile == 0x48)                // AVS+ broadcast profile
+        read_hdr_bits(data, &pos, 8);
+
+    if (data[3] == 0xB3)
+    {
+        pic->picType = 1;
+        if (read_hdr_bits(data, &pos, 1))   // time_code_flag
+            read_hdr_bits(data, &pos, 24);
+        read_hdr_bits(data, &pos, 1);       // marker_bit
+    }
+    else
+    {
+        pic->picType = (uint8_t)(1 + read_hdr_bits(data, &pos, 2));
+        if (pic->picType != 2 && pic->picType != 3)
+            pic->picType = 0;
+    }
+    return (int)read_hdr_bits(data, &pos, 8);   // picture_distance
+}
+
+bool AvsFileReader::build_index(std::vector<AvsPicIndex>* index)
+{
+    index->clear();
+    if (!m_pFile || seek(0) != 0)
+        return false;
+
+    DataVec buf;
+    int64_t base = 0;           // buf 开始位置在文件中的偏移
+    int64_t lastHdr = -8;       // 上一个 sequence header 或 picture header 的位置
+    int64_t seqPos = -1;        // 尚未归属于图像的 sequence header 的位置
+    uint8_t profile = 0;
+    int     refDist = -1;       // 上一个参考帧的 picture_distance
+    int     refPoc = 0;         // 上一个参考帧展开后的 picture_distance
+    bool    inPic = false;
+    AvsPicIndex pic = {};
+
+    while (1)
+    {
+        // 读入数据, 末尾补 0 保证 picture header 解析不越界
+        uint8_t* pbuf = buf.alloc(INDEX_READ_SIZE + 16);
+        size_t rdsize = ::fread(pbuf, 1, INDEX_READ_SIZE, m_pFile);
+        buf.commit(rdsize);
+        memset(buf.data() + buf.size(), 0, 16);
+        const bool eof = rdsize < INDEX_READ_SIZE;
+
+        // 未到文件末尾时保留最后 12 个字节, 保证 start code 之后的 picture header 是完整的
+        const uint8_t* data = buf.data();
+        const int end = (int)buf.size() - (eof ? 3 : 12);
+        int i = 0;
+        while (1)
+        {
+            i += irk_avs_find_start_code(data + i, (int)buf.size() - i);
+            if (i >= end)
+            {
+                i = std::max(end, 0);
+                break;
+            }
+
+            const uint8_t scode = data[i + 3];
+            const int64_t pos = base + i;
+            i += 3;
+
+            // 与 get_picture 的分帧方式保持一致
+            if (scode != 0xB0 && scode != 0xB3 && scode != 0xB6)
+                continue;
+            if (pos < lastHdr + 8 || (scode == 0xB0 && seqPos >= 0))
+                continue;
+
+            if (inPic)      // 上一帧结束
+            {
+                pic.size = (uint32_t)(pos - pic.offset);
+                index->push_back(pic);
+                inPic = false;
+            }
+
+            lastHdr = pos;
+            if (scode == 0xB0)
+            {
+                seqPos = pos;
+                profile = data[i + 1];
+                continue;
+            }
+
+            pic.offset = seqPos >= 0 ? seqPos : pos;
+            pic.seqHdr = seqPos >= 0 ? 1 : 0;
+            seqPos = -1;
+            const int picDist = parse_pic_type(data + i - 3, profile, &pic);
+            pic.poc = refDist < 0 ? picDist : refPoc + (int8_t)(uint8_t)(picDist - refDist);
+            if (pic.picType != 3)
+            {
+                refDist = picDist;
+                refPoc = pic.poc;
+            }
+            inPic = true;
+        }
+
+        if (eof)
+            break;
+        base += i;
+        buf.pop_front(i);
+    }
+
+    // 文件末尾的这一帧可能不是完整的一帧, 判断条件与 get_picture 相同
+    const int64_t fileSize = base + (int64_t)buf.size();
+    if (inPic && fileSize - pic.offset > 67)
+    {
+        pic.size = (uint32_t)(fileSize - pic.offset);
+        index->push_back(pic);
+    }
+
+    return seek(0) == 0;
+}
+
+int AvsFileReader::seek_to_key(const std::vector<AvsPicIndex>& index, int picIdx)
+{
+    if (picIdx < 0 || picIdx >= (int)index.size())
+        return -1;
+
+    int k = picIdx;
+    while (k >= 0 && index[k].picType != 1)
+        k--;
+    if (k < 0 || seek(index[k].offset) != 0)
+        return -1;
+    return k;
+}
@@ -2,6 +2,17 @@
 #define _AVS_FILEREADER_H_
 
 #include "IrkVector.h"
+#include <vector>
+
+// 码流索引中的一帧, 与 get_picture 返回的数据一一对应
+struct AvsPicIndex
+{
+    int64_t     offset;     // 在文件中的偏移, 前面有 sequence header 时从 sequence header 开始
+    uint32_t    size;       // 数据大小, 包括前面的 sequence header
+    uint8_t     picType;    // 1: I, 2: P, 3: B, 0: 未知
+    uint8_t     seqHdr;     // 是否以 sequence header 开始
+    int32_t     poc;        // 按解码顺序展开的 picture_distance, 不受 8 比特回绕影响
+};
 
 // AVS 裸流读取器
 class AvsFileReader
@@ -10,18 +21,38 @@ public:
     AvsFileReader();
     ~AvsFileReader();
 
-    bool open(const char* filename);
+    // mapped == true: 内存映射模式, get_picture 直接返回映射内存中的数据, 不再复制, 不支持的平台上忽略
+    // NOTE: 映射的数据是只读的, 解码器不能使用零拷贝输入模式(零拷贝模式会改写数据之后的填充区域)
+    bool open(const char* filename, bool mapped = false);
     void close();
     int  seek(int64_t offset);
 
     // 读取一帧数据, 返回的指针无需释放, 在下一次调用和关闭前有效
+    // 内存映射模式下返回的指针在关闭前一直有效, 最后一帧之后也有可读的 0 填充
     const uint8_t* get_picture(size_t* psize);
 
+    // 扫描整个文件建立索引, 完成后回到文件开始位置
+    bool build_index(std::vector<AvsPicIndex>* index);
+
+    // 定位到第 picIdx 帧之前(含)最近的 I 帧, 之后 get_picture 从该帧开始读取
+    // 返回该 I 帧在索引中的位置, 失败返回 -1
+    // NOTE: 解码器应先调用 irk_avs_decoder_seek_reset, 若该 I 帧不以 sequence header 开始, 解码器需已解析过 sequence header
+    int  seek_to_key(const std::vector<AvsPicIndex>& index, int picIdx);
+
 private:
+    const uint8_t* get_mapped_picture(size_t* psize);
+    int64_t map_next_start_code(int64_t pos, int64_t end) const;
+    void    unmap();
+
     typedef irk::Vector<uint8_t> DataVec;
     DataVec m_DataBuf[2];
     int     m_BufIdx;
     FILE*   m_pFile;
+
+    uint8_t*    m_pMap;         // 内存映射模式下文件的映射地址
+    size_t      m_MapLen;       // 映射长度, 包括文件末尾之后的填充
+    int64_t     m_FileSize;     // 文件长度
+    int64_t     m_MapPos;       // 内存映射模式下的读取位置
 };
 
 #endif
@@ -0,0 +1,458 @@
+﻿#include "AvsFileReader.h"
+#include "IrkAvsDecoder.h"
+#include "IrkCmdLine.h"
+#include "IrkThread.h"
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+typedef std::chrono::steady_clock BenchClock;
+
+// 内存中的一帧码流
+struct BenchPicture
+{
+    size_t  offset;
+    size_t  size;
+};
+
+// 一次解码过程的统计数据
+struct BenchRun
+{
+    std::vector<BenchClock::time_point> sendTime;   // 每帧送入解码器的时刻
+    std::vector<double>                 latency;    // 每帧从送入到输出的时间, 毫秒
+    std::vector<BenchClock::time_point> firstRows;  // 逐行通知时, 每帧第一次通知已完成图像行的时刻
+    std::vector<double>                 rowLatency; // 每帧从送入到第一次通知已完成图像行的时间, 毫秒
+    FILE*                               fpyuv;      // 输出 YUV 文件, 可为空
+    int                                 outFormat;  // 输出格式, IRK_AVS_OUTPUT_XXX
+    IrkAvsDecStats                      stats;      // 各阶段耗时, 多次解码累计
+};
+
+// 输出图像平面 k 每行的字节数, NV12 的 CbCr 平面和 UYVY 每个像素 2 字节
+static int line_bytes(int outFormat, int k, int width)
+{
+    if ((outFormat == IRK_AVS_OUTPUT_NV12 && k == 1) || outFormat == IRK_AVS_OUTPUT_UYVY)
+        return width * 2;
+    return width;
+}
+
+static void bench_notifier(int code, void* data, void* cbparam)
+{
+    BenchRun* run = (BenchRun*)cbparam;
+
+    // 在解码线程调用, 每帧只有一次从第 0 行开始的通知, 各帧写入不同位置, 不需要加锁
+    if (code == IRK_AVS_DEC_ROWS_READY)
+    {
+        const IrkAvsDecedRows* rows = (const IrkAvsDecedRows*)data;
+        size_t idx = (size_t)rows->pic->userpts;
+        if (rows->line_beg == 0 && idx < run->firstRows.size())
+            run->firstRows[idx] = BenchClock::now();
+        return;
+    }
+    if (code != IRK_CODEC_DONE)
+        return;
+
+    const IrkAvsDecedPic* pframe = (const IrkAvsDecedPic*)data;
+
+    size_t idx = (size_t)pframe->userpts;
+    if (idx < run->sendTime.size())
+    {
+        auto elapsed = BenchClock::now() - run->sendTime[idx];
+        run->latency.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+        if (idx < run->firstRows.size())
+        {
+            elapsed = run->firstRows[idx] - run->sendTime[idx];
+            run->rowLatency.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+        }
+    }
+
+    if (run->fpyuv)
+    {
+        for (int k = 0; k < 3 && pframe->plane[k]; k++)
+        {
+            const uint8_t* src = pframe->plane[k];
+            const int lineSize = line_bytes(run->outFormat, k, pframe->width[k]);
+            for (int i = 0; i < pframe->height[k]; i++)
+            {
+                fwrite(src, 1, lineSize, run->fpyuv);
+                src += pframe->pitch[k];
+            }
+        }
+    }
+}
+
+// 解码内存中的码流一次, 返回耗时(秒), 失败返回负数
+static double bench_decode_once(const IrkAvsDecConfig& cfg, int skipMode, const irk::Vector<uint8_t>& stream,
+                                const std::vector<BenchPicture>& pics, BenchRun* run)
+{
+    IrkAvsDecoder* decoder = irk_create_avs_decoder(&cfg);
+    if (!decoder)
+    {
+        fprintf(stderr, "irk_create_avs_decoder failed\n");
+        return -1;
+    }
+    irk_avs_decoder_set_notify(decoder, &bench_notifier, run);
+    irk_avs_decoder_set_skip(decoder, skipMode);
+
+    run->sendTime.resize(pics.size());
+    run->latency.clear();
+    run->latency.reserve(pics.size());
+    run->firstRows.assign(cfg.row_notify ? pics.size() : 0, BenchClock::time_point());
+    run->rowLatency.clear();
+
+    auto startTime = BenchClock::now();
+
+    IrkCodedPic encPic = {};
+    for (size_t i = 0; i < pics.size(); i++)
+    {
+        encPic.data = (uint8_t*)stream.data() + pics[i].offset;
+        encPic.size = pics[i].size;
+        encPic.userpts = (int64_t)i;
+        run->sendTime[i] = BenchClock::now();
+        if (irk_avs_decoder_decode(decoder, &encPic) < 0)
+            break;
+    }
+
+    // 输出缓存的帧
+    irk_avs_decoder_decode(decoder, NULL);
+
+    auto endTime = BenchClock::now();
+
+    IrkAvsDecStats stats;
+    if (cfg.enable_stats && irk_avs_decoder_get_stats(decoder, &stats, 0) == 0)
+    {
+        run->stats.frames += stats.frames;
+        run->stats.header_cycles += stats.header_cycles;
+        run->stats.entropy_cycles += stats.entropy_cycles;
+        run->stats.intra_pred_cycles += stats.intra_pred_cycles;
+        run->stats.inter_pred_cycles += stats.inter_pred_cycles;
+        run->stats.idct_cycles += stats.idct_cycles;
+        run->stats.loop_filter_cycles += stats.loop_filter_cycles;
+        run->stats.padding_cycles += stats.padding_cycles;
+        run->stats.wait_cycles += stats.wait_cycles;
+    }
+    irk_destroy_avs_decoder(decoder);
+
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+// 排序后的数据取百分位
+static double percentile(const std::vector<double>& sorted, double pct)
+{
+    if (sorted.empty())
+        return 0;
+    size_t idx = (size_t)(pct * 0.01 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+// 随机访问测试中的一次定位
+struct SeekRun
+{
+    int64_t target;     // 目标帧在索引中的位置
+    bool    hit;        // 目标帧是否已输出
+};
+
+static void seek_notifier(int code, void* data, void* cbparam)
+{
+    if (code != IRK_CODEC_DONE)
+        return;
+
+    const IrkAvsDecedPic* pframe = (const IrkAvsDecedPic*)data;
+    SeekRun* run = (SeekRun*)cbparam;
+    if (pframe->userpts == run->target)
+        run->hit = true;
+}
+
+// 随机访问测试: 建立码流索引, 依次定位到均匀分布的 seekCnt 个目标帧,
+// 从目标帧之前最近的 I 帧开始解码, 直到目标帧输出, 耗时包括文件读取
+static int bench_seek(const char* avsFileName, bool mapped, const IrkAvsDecConfig& cfg, int seekCnt)
+{
+    AvsFileReader reader;
+    if (!reader.open(avsFileName, mapped))
+    {
+        fprintf(stderr, "open file %s failed\n", avsFileName);
+        return -1;
+    }
+
+    auto startTime = BenchClock::now();
+    std::vector<AvsPicIndex> index;
+    if (!reader.build_index(&index) || index.empty())
+    {
+        fprintf(stderr, "no picture found in %s\n", avsFileName);
+        return -1;
+    }
+    double indexTime = std::chrono::duration<double, std::milli>(BenchClock::now() - startTime).count();
+    int keyCnt = 0;
+    for (size_t i = 0; i < index.size(); i++)
+        keyCnt += (index[i].picType == 1);
+    printf("%s: %d pictures, %d I pictures, index built in %.3f ms\n", avsFileName, (int)index.size(), keyCnt, indexTime);
+
+    IrkAvsDecoder* decoder = irk_create_avs_decoder(&cfg);
+    if (!decoder)
+    {
+        fprintf(stderr, "irk_create_avs_decoder failed\n");
+        return -1;
+    }
+    SeekRun run = {-1, false};
+    irk_avs_decoder_set_notify(decoder, &seek_notifier, &run);
+
+    // 先解码第一帧, 使解码器得到 sequence header, 之后定位到的 I 帧不一定以 sequence header 开始
+    // 非零拷贝输入模式下解码器会复制输入数据, 直接使用读取器返回的数据
+    size_t firstSize = 0;
+    const uint8_t* firstPic = reader.get_picture(&firstSize);
+    if (firstPic)
+    {
+        IrkCodedPic encPic = {};
+        encPic.data = (uint8_t*)firstPic;
+        encPic.size = firstSize;
+        encPic.userpts = -1;
+        irk_avs_decoder_decode(decoder, &encPic);
+        irk_avs_decoder_decode(decoder, NULL);
+    }
+
+    std::vector<double> seekTime;
+    int hitCnt = 0;
+    int64_t decodedCnt = 0;
+    for (int n = 0; n < seekCnt; n++)
+    {
+        int target = (int)((int64_t)index.size() * (2 * n + 1) / (2 * seekCnt));
+        run.target = target;
+        run.hit = false;
+        startTime = BenchClock::now();
+
+        int k = reader.seek_to_key(index, target);
+        if (k < 0)
+            continue;
+        irk_avs_decoder_seek_reset(decoder);
+        IrkCodedPic encPic = {};
+        for (; k <= target && !run.hit; k++)
+        {
+            size_t size = 0;
+            const uint8_t* data = reader.get_picture(&size);
+            if (!data)
+                break;
+            encPic.data = (uint8_t*)data;
+            encPic.size = size;
+            encPic.userpts = k;
+            if (irk_avs_decoder_decode(decoder, &encPic) < 0)
+                break;
+            decodedCnt++;
+        }
+        if (!run.hit)
+            irk_avs_decoder_decode(decoder, NULL);
+
+        seekTime.push_back(std::chrono::duration<double, std::milli>(BenchClock::now() - startTime).count());
+        hitCnt += run.hit;
+    }
+    irk_destroy_avs_decoder(decoder);
+
+    std::sort(seekTime.begin(), seekTime.end());
+    double total = 0;
+    for (size_t i = 0; i < seekTime.size(); i++)
+        total += seekTime[i];
+    printf("seeks  hits  pics/seek  avg(ms)  p50(ms)  p90(ms)  max(ms)\n");
+    printf("%5d %5d %10.2f %8.3f %8.3f %8.3f %8.3f\n", (int)seekTime.size(), hitCnt,
+           seekTime.empty() ? 0 : (double)decodedCnt / seekTime.size(), seekTime.empty() ? 0 : total / seekTime.size(),
+           percentile(seekTime, 50), percentile(seekTime, 90), seekTime.empty() ? 0 : seekTime.back());
+    return 0;
+}
+
+// 输出各阶段耗时占比
+static void print_stats(const IrkAvsDecStats& stats)
+{
+    const int64_t cycles[] = {
+        stats.header_cycles, stats.entropy_cycles, stats.intra_pred_cycles, stats.inter_pred_cycles,
+        stats.idct_cycles, stats.loop_filter_cycles, stats.padding_cycles, stats.wait_cycles,
+    };
+    const char* names[] = {"header", "entropy", "intra", "inter", "idct", "deblock", "padding", "wait"};
+
+    int64_t total = 0;
+    for (int i = 0; i < 8; i++)
+        total += cycles[i];
+    if (stats.frames <= 0 || total <= 0)
+        return;
+
+    printf("        stages:");
+    for (int i = 0; i < 8; i++)
+        printf(" %s %.1f%%", names[i], cycles[i] * 100.0 / total);
+    printf(", %.0f kcycles/frame\n", total / 1000.0 / stats.frames);
+}
+
+static void print_usage(const char* exe)
+{
+    fprintf(stderr, "usage: %s -i=<avs file> [options]\n", exe);
+    fprintf(stderr, "  -r=<N>         repeat decoding N times for each thread count, default 3\n");
+    fprintf(stderr, "  -t=<N>         sweep thread count from 1 to N, default CPU core count\n");
+    fprintf(stderr, "  -t1=<N>        only test thread count N\n");
+    fprintf(stderr, "  -n=<N>         only decode the first N pictures\n");
+    fprintf(stderr, "  -wavefront     enable macroblock row wavefront reconstruction\n");
+    fprintf(stderr, "  -pipeline      enable parse/reconstruct pipeline mode\n");
+    fprintf(stderr, "  -zerocopy      enable zero-copy input mode\n");
+    fprintf(stderr, "  -stats         report per-stage cycle breakdown\n");
+    fprintf(stderr, "  -skip=<N>      skip mode, 1: skip non-reference pictures, 2: only decode I pictures\n");
+    fprintf(stderr, "  -thumbnail     only decode I pictures into 1/8 size thumbnails\n");
+    fprintf(stderr, "  -lowres=<N>    reduced resolution decoding, 1: 1/2 size, 2: 1/4 size\n");
+    fprintf(stderr, "  -format=<fmt>  output picture format, i420(default), nv12 or uyvy\n");
+    fprintf(stderr, "  -mmap          read the AVS file by memory mapping\n");
+    fprintf(stderr, "  -hugepage      pre-allocate decoded pictures from huge pages\n");
+    fprintf(stderr, "  -nopadding     do not pad reference pictures, extend blocks outside the picture on demand\n");
+    fprintf(stderr, "  -rownotify     notify finished picture rows while decoding, report latency of the first rows\n");
+    fprintf(stderr, "  -numa=<N>      bind huge page pictures and decoding threads to NUMA node N, implies -hugepage\n");
+    fprintf(stderr, "  -seek=<N>      random access test, seek to N evenly spaced pictures via the stream index\n");
+    fprintf(stderr, "  -o=<yuv file>  write YUV of the first run, no YUV output by default\n");
+}
+
+int main(int argc, char** argv)
+{
+    irk::CmdLine cmdline;
+    cmdline.parse(argc, argv);
+
+    const char* avsFileName = cmdline.get_optvalue("-i");
+    if (!avsFileName)
+    {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    const char* optval = cmdline.get_optvalue("-r");
+    int repeatCnt = optval ? std::max(atoi(optval), 1) : 3;
+    optval = cmdline.get_optvalue("-n");
+    int maxPicCnt = optval ? atoi(optval) : 0;
+    optval = cmdline.get_optvalue("-t");
+    int maxThreads = optval ? std::max(atoi(optval), 1) : irk::cpu_core_count();
+    int minThreads = 1;
+    optval = cmdline.get_optvalue("-t1");
+    if (optval)
+        minThreads = maxThreads = std::max(atoi(optval), 1);
+    optval = cmdline.get_optvalue("-skip");
+    int skipMode = optval ? atoi(optval) : IRK_AVS_DEC_SKIP_NONE;
+
+    bool mapped = false;
+    IrkAvsDecConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    optval = cmdline.get_optvalue("-lowres");
+    cfg.low_res = optval ? atoi(optval) : 0;
+    optval = cmdline.get_optvalue("-format");
+    if (optval && strcmp(optval, "nv12") == 0)
+        cfg.output_format = IRK_AVS_OUTPUT_NV12;
+    else if (optval && strcmp(optval, "uyvy") == 0)
+        cfg.output_format = IRK_AVS_OUTPUT_UYVY;
+    optval = cmdline.get_optvalue("-numa");
+    if (optval)
+    {
+        cfg.huge_page = 1;
+        cfg.numa_node = std::max(atoi(optval), 0) + 1;
+    }
+    for (unsigned i = 1; i < cmdline.arg_count(); i++)
+    {
+        if (cmdline[i] == "-wavefront")
+            cfg.wavefront = 1;
+        else if (cmdline[i] == "-pipeline")
+            cfg.pipeline = 1;
+        else if (cmdline[i] == "-zerocopy")
+            cfg.zero_copy = 1;
+        else if (cmdline[i] == "-stats")
+            cfg.enable_stats = 1;
+        else if (cmdline[i] == "-thumbnail")
+            cfg.thumbnail = 1;
+        else if (cmdline[i] == "-mmap")
+            mapped = true;
+        else if (cmdline[i] == "-hugepage")
+            cfg.huge_page = 1;
+        else if (cmdline[i] == "-nopadding")
+            cfg.disable_padding = 1;
+        else if (cmdline[i] == "-rownotify")
+            cfg.row_notify = 1;
+    }
+
+    optval = cmdline.get_optvalue("-seek");
+    if (optval)
+    {
+        cfg.thread_cnt = minThreads;
+        cfg.zero_copy = 0;      // 随机访问测试直接解码读取器返回的数据
+        return bench_seek(avsFileName, mapped, cfg, std::max(atoi(optval), 1));
+    }
+
+    // 读取整个码流到内存, 每帧之后预留零拷贝输入要求的填充
+    AvsFileReader reader;
+    if (!reader.open(avsFileName, mapped))
+    {
+        fprintf(stderr, "open file %s failed\n", avsFileName);
+        return -1;
+    }
+    irk::Vector<uint8_t> stream;
+    std::vector<BenchPicture> pics;
+    while (maxPicCnt <= 0 || (int)pics.size() < maxPicCnt)
+    {
+        size_t size = 0;
+        const uint8_t* data = reader.get_picture(&size);
+        if (!data)
+            break;
+        BenchPicture pic = {stream.size(), size};
+        pics.push_back(pic);
+        stream.push_back(data, size);
+        stream.resize(stream.size() + IRK_AVS_DEC_INPUT_PADDING);
+    }
+    reader.close();
+    if (pics.empty())
+    {
+        fprintf(stderr, "no picture found in %s\n", avsFileName);
+        return -1;
+    }
+
+    printf("%s: %d pictures, %d runs per thread count\n", avsFileName, (int)pics.size(), repeatCnt);
+    printf("threads       fps   speedup  lat-p50(ms)  lat-p90(ms)  lat-p99(ms)  lat-max(ms)\n");
+
+    const char* yuvFileName = cmdline.get_optvalue("-o");
+    BenchRun run;
+    run.fpyuv = nullptr;
+    run.outFormat = cfg.output_format;
+    double baseFps = 0;
+
+    for (int thrCnt = minThreads; thrCnt <= maxThreads; thrCnt++)
+    {
+        cfg.thread_cnt = thrCnt;
+
+        double totalTime = 0;
+        size_t outCnt = 0;
+        std::vector<double> latency;
+        std::vector<double> rowLatency;
+        memset(&run.stats, 0, sizeof(run.stats));
+        for (int r = 0; r < repeatCnt; r++)
+        {
+            run.fpyuv = (yuvFileName && thrCnt == minThreads && r == 0) ? fopen(yuvFileName, "wb") : nullptr;
+            double elapsed = bench_decode_once(cfg, skipMode, stream, pics, &run);
+            if (run.fpyuv)
+                fclose(run.fpyuv);
+            if (elapsed < 0)
+                return -1;
+
+            totalTime += elapsed;
+            outCnt += run.latency.size();
+            latency.insert(latency.end(), run.latency.begin(), run.latency.end());
+            rowLatency.insert(rowLatency.end(), run.rowLatency.begin(), run.rowLatency.end());
+        }
+
+        // 吞吐量以输出帧数计算, 延迟为送入解码器到输出的时间, 包含输出顺序重排的等待
+        std::sort(latency.begin(), latency.end());
+        double fps = totalTime > 0 ? outCnt / totalTime : 0;
+        if (thrCnt == minThreads)
+            baseFps = fps;
+
+        printf("%7d %9.2f %8.2fx %12.3f %12.3f %12.3f %12.3f\n", thrCnt, fps, baseFps > 0 ? fps / baseFps : 0,
+               percentile(latency, 50), percentile(latency, 90), percentile(latency, 99),
+               latency.empty() ? 0 : latency.back());
+        if (cfg.row_notify && !rowLatency.empty())
+        {
+            // 第一次通知已完成图像行的时间, 即低延迟使用者可以开始处理的时间
+            std::sort(rowLatency.begin(), rowLatency.end());
+            printf("    first rows:                    %12.3f %12.3f %12.3f %12.3f\n", percentile(rowLatency, 50),
+                   percentile(rowLatency, 90), percentile(rowLatency, 99), rowLatency.back());
+        }
+        if (cfg.enable_stats)
+            print_stats(run.stats);
+    }
+
+    return 0;
+}
@@ -31,9 +31,20 @@
 #define AVS_PICTURE_TYPE_P              2
 #define AVS_PICTURE_TYPE_B              3
 
+// output picture format
+#define IRK_AVS_OUTPUT_I420         0   // planar Y, Cb, Cr
+#define IRK_AVS_OUTPUT_NV12         1   // planar Y, interleaved CbCr
+#define IRK_AVS_OUTPUT_UYVY         2   // packed 4:2:2, U0 Y0 V0 Y1
+
+// padding bytes required after the coded data in zero-copy input mode, may be overwritten by the decoder
+#define IRK_AVS_DEC_INPUT_PADDING   4096
+
 // opaque AVS+ decoder
 struct IrkAvsDecoder;
 
+// opaque thread pool, can be shared by several AVS+ decoders
+struct IrkAvsThreadPool;
+
 // AVS+ decoder configuration, for defaults set the whole struct to 0
 struct IrkAvsDecConfig
 {
@@ -56,6 +67,96 @@ struct IrkAvsDecConfig
     void*               alloc_cbparam;          // callback parameter of custom memory allocator
     PFN_CodecDealloc    dealloc_callback;       // custom memory deallocator
     void*               dealloc_cbparam;        // callback parameter of custom memory deallocator
+
+    // NOTE: fields below are added later, new fields are always appended at the end to keep the layout
+    //       of existing fields compatible with applications built against older versions
+
+    // 1: wavefront mode, one thread parses a picture, macroblock rows of the picture are reconstructed
+    //    by several threads in parallel, each row stays 2 macroblocks behind the row above it,
+    //    reduces per-picture latency, also for bitstreams with only one slice per picture
+    // 0: only pictures are decoded in parallel
+    // NOTE: only used by multi-thread decoding, the picture is parsed the same way as the pipeline mode
+    int     wavefront;
+
+    // 1: two-stage pipeline, one thread parses a picture (entropy decoding, motion vector prediction),
+    //    another thread reconstructs it (prediction, inverse transform, loop filter) at the same time,
+    //    reduces per-picture latency if the bitstream has only one slice per picture
+    // 0: parsing and reconstruction are done by the same thread
+    // NOTE: only used by multi-thread decoding, ignored if wavefront mode is enabled
+    int     pipeline;
+
+    // 1: zero-copy input, coded data is parsed in place instead of being copied to internal buffer,
+    //    only start code units containing emulation prevention bytes are copied.
+    //    the caller must guarantee IRK_AVS_DEC_INPUT_PADDING writable bytes after the coded data,
+    //    and keep the coded data valid and unmodified until the decoded picture is delivered
+    //    by the notify callback or irk_avs_decoder_decode(decoder, NULL) returns
+    // 0: coded data is copied to internal buffer
+    int     zero_copy;
+
+    // if not NULL, multi-thread decoding runs in this shared thread pool instead of creating internal threads,
+    // thread_cnt then limits the number of pictures decoded in parallel by this decoder(0: pool thread count),
+    // so that one decoder can not flood the pool, pending tasks of all decoders are served in FIFO order.
+    // NOTE: the thread pool must outlive the decoder
+    IrkAvsThreadPool*   thread_pool;
+
+    // capacity of the output picture queue used by irk_avs_decoder_send_packet/irk_avs_decoder_receive_frame,
+    // 0 means default(8)
+    int     output_queue_size;
+
+    // 1: collect per-stage decoding statistics, see irk_avs_decoder_get_stats, adds a little overhead
+    // 0: no statistics
+    int     enable_stats;
+
+    // 1: thumbnail mode, only I pictures are decoded(as skip mode IRK_AVS_DEC_SKIP_NONKEY),
+    //    blocks are reconstructed with DC coefficients only and without loop filter,
+    //    then each 8x8 block is averaged into one pixel, output pictures are 1/8 width and height(rounded up).
+    //    the result is an approximation of the real picture, only suitable for previews
+    // 0: normal decoding
+    int     thumbnail;
+
+    // reduced resolution decoding, pictures are reconstructed directly at lower resolution:
+    // 1: 1/2 width and height, 2: 1/4 width and height(both rounded up), 0: full resolution.
+    // residuals use a scaled inverse transform, motion compensation is bilinear on the reduced
+    // reference pictures and loop filter is disabled, so errors accumulate(drift) until the next I picture.
+    // the result is an approximation of the real picture. ignored in thumbnail mode
+    int     low_res;
+
+    // output picture format, IRK_AVS_OUTPUT_XXX, 0(I420) by default.
+    // IRK_AVS_OUTPUT_NV12: plane[0] is Y, plane[1] is interleaved CbCr, width[1] is the number of CbCr pairs.
+    // IRK_AVS_OUTPUT_UYVY: plane[0] is packed UYVY, width[0] in pixels(2 bytes per pixel),
+    //                      chroma lines of 4:2:0 pictures are duplicated vertically.
+    // the conversion is done right after each macroblock row is reconstructed, while the data is still in cache,
+    // reference pictures keep an internal planar copy, unused planes are NULL
+    int     output_format;
+
+    // 1: the decoded picture pool is pre-allocated from 2MB huge pages when the sequence header is parsed,
+    //    explicit huge pages(MAP_HUGETLB) are used if reserved by the system, otherwise transparent huge pages.
+    //    reduces TLB misses of motion compensation on large pictures, more pictures are allocated on demand
+    // 0: pictures are allocated one by one when needed
+    // NOTE: ignored if custom allocator is used
+    int     huge_page;
+
+    // NUMA node of the huge page picture pool plus one, only used if huge_page is 1:
+    // n > 0: pictures are bound to NUMA node n-1, internal decoding threads only run on CPUs of this node.
+    //        threads of shared thread pool are not affected
+    // 0: no binding, pictures are allocated on the node of the thread parsing the sequence header
+    int     numa_node;
+
+    // 1: reference pictures are not padded, the left and right 8-pixel margins are removed from the picture buffers,
+    //    blocks whose motion vectors reach outside the picture are extended on demand
+    // 0: left and right edges of every reconstructed row are extended into the margins
+    int     disable_padding;
+
+    // 1: besides IRK_CODEC_DONE, the notify callback also gets IRK_AVS_DEC_ROWS_READY codes while a picture is
+    //    being decoded, each reports picture lines which are final(reconstructed, loop filtered and converted to
+    //    the output format), so that the top of the picture can be consumed before the bottom is decoded.
+    //    lines are reported from top to bottom in decoding order, the whole picture is reported before
+    //    IRK_CODEC_DONE of the same picture. second field of interlaced pictures is needed before lines are final.
+    //    if the bitstream is corrupted, reported lines may still be modified by error handling until IRK_CODEC_DONE
+    // 0: only IRK_CODEC_DONE is notified
+    // NOTE: the callback is called in decoding threads, maybe concurrently for different pictures,
+    //       ignored in thumbnail mode and pull mode(irk_avs_decoder_send_packet)
+    int     row_notify;
 };
 
 // decoded AVS+ picture
@@ -67,6 +168,28 @@ struct IrkAvsDecedPic : IrkDecedPic
     uint8_t     repeat_first_field;
 };
 
+// per-stage decoding statistics, in CPU time stamp counter cycles, summed over all decoding threads
+struct IrkAvsDecStats
+{
+    int64_t     frames;             // decoded pictures
+    int64_t     header_cycles;      // start code splitting, header parsing and picture setup
+    int64_t     entropy_cycles;     // VLC/AEC entropy decoding, macroblock parsing and motion vector prediction
+    int64_t     intra_pred_cycles;  // intra prediction
+    int64_t     inter_pred_cycles;  // motion compensation, weighted prediction and bi-prediction average
+    int64_t     idct_cycles;        // inverse transform
+    int64_t     loop_filter_cycles; // loop filter
+    int64_t     padding_cycles;     // picture edge padding
+    int64_t     wait_cycles;        // waiting for decoding progress of reference pictures
+};
+
+// data of IRK_AVS_DEC_ROWS_READY notify code, see IrkAvsDecConfig::row_notify
+struct IrkAvsDecedRows
+{
+    const IrkAvsDecedPic*   pic;        // picture being decoded, only valid in notify callback
+    int                     line_beg;   // first luma line reported
+    int                     line_end;   // luma lines [line_beg, line_end) are final, chroma lines accordingly
+};
+
 // AVS+ coded stream basic information
 struct IrkAvsStreamInfo
 {
@@ -110,33 +233,95 @@ IRK_AVSDEC_EXPORT IrkAvsDecoder* irk_create_avs_decoder(const IrkAvsDecConfig* c
 // all resource allocated by the decoder will be destoryed
 IRK_AVSDEC_EXPORT void irk_destroy_avs_decoder(IrkAvsDecoder* decoder);
 
+// create thread pool shared by several AVS+ decoders, see IrkAvsDecConfig::thread_pool
+// thread_cnt == 0 means CPU core count
+// return NULL if failed(create threads failed)
+IRK_AVSDEC_EXPORT IrkAvsThreadPool* irk_create_avs_thread_pool(int thread_cnt);
+
+// destroy shared thread pool, all decoders using it must be destroyed first
+IRK_AVSDEC_EXPORT void irk_destroy_avs_thread_pool(IrkAvsThreadPool* pool);
+
 // reset AVS+ decoder(before decoding new bitstream)
 // if "resetAll" == false, global setting such as sequece header will not be reset
 IRK_AVSDEC_EXPORT void irk_avs_decoder_reset(IrkAvsDecoder* decoder, bool resetAll);
 
+// reset AVS+ decoder before decoding from a random access point(normally an I picture) after seeking in the bitstream
+// same as irk_avs_decoder_reset(decoder, false), in addition until the decoder is reset again,
+// P pictures before the first I picture and B pictures referencing pictures before it(leading B pictures of open GOP)
+// are skipped instead of being decoded with missing reference pictures
+IRK_AVSDEC_EXPORT void irk_avs_decoder_seek_reset(IrkAvsDecoder* decoder);
+
+// decoder's notify code: some lines of the picture being decoded are final, see IrkAvsDecConfig::row_notify
+#define IRK_AVS_DEC_ROWS_READY  1
+
 // set decoding notify callback
 // when got IRK_CODEC_DONE code, notify data point to IrkAvsDecedPic struct
+// when got IRK_AVS_DEC_ROWS_READY code, notify data point to IrkAvsDecedRows struct
 IRK_AVSDEC_EXPORT void irk_avs_decoder_set_notify(IrkAvsDecoder* decoder, PFN_CodecNotify callback, void* cbparam);
 
-// set skip mode, if "skip_mode" != 0, skip non-reference pictures
+#define IRK_AVS_DEC_SKIP_NONE   0   // decode all pictures
+#define IRK_AVS_DEC_SKIP_NONREF 1   // skip non-reference pictures(B pictures)
+#define IRK_AVS_DEC_SKIP_NONKEY 2   // skip all P and B pictures, only decode I pictures
+
+// set skip mode, see IRK_AVS_DEC_SKIP_XXX above, takes effect from the next picture
+// NOTE: if only I pictures are decoded, each picture is output as soon as it is decoded
 IRK_AVSDEC_EXPORT void irk_avs_decoder_set_skip(IrkAvsDecoder* decoder, int skip_mode);
 
 #define IRK_AVS_DEC_BAD_STREAM  -1
 #define IRK_AVS_DEC_UNAVAILABLE -2
 #define IRK_AVS_DEC_UNSUPPORTED -3
+#define IRK_AVS_DEC_AGAIN       -4
+#define IRK_AVS_DEC_EOF         -5
 
 // decode one AVS+ picture
 // if succeeded return data size consumed, 
 // if failed return negtive error code(see above)
 // NOTE 1: decoded picture will be send to user by the notify callback,
-//          notify callback will always be called in the thread calling this function
+//          notify callback will always be called in the thread calling this function,
+//          except IRK_AVS_DEC_ROWS_READY code(see IrkAvsDecConfig::row_notify)
 // NOTE 2: input NULL will flush cached pictures
 IRK_AVSDEC_EXPORT int irk_avs_decoder_decode(IrkAvsDecoder* decoder, const IrkCodedPic* encPic);
 
+// pull mode: decode one AVS+ picture, decoded pictures are put into the output queue instead of
+// being sent to the notify callback, user takes them by irk_avs_decoder_receive_frame
+// if succeeded return data size consumed,
+// if the output queue is full return IRK_AVS_DEC_AGAIN, nothing is consumed, receive some pictures first,
+// if failed return negtive error code(see above)
+// NOTE 1: input NULL will flush cached pictures into the output queue followed by an end of stream mark,
+//         this never fails with IRK_AVS_DEC_AGAIN
+// NOTE 2: do not mix with irk_avs_decoder_decode on the same decoder
+// NOTE 3: only decoded pictures(IRK_CODEC_DONE) are delivered in pull mode, other notify codes such as
+//         IRK_AVS_DEC_ROWS_READY are dropped, decoding errors are reported by the return value
+IRK_AVSDEC_EXPORT int irk_avs_decoder_send_packet(IrkAvsDecoder* decoder, const IrkCodedPic* encPic);
+
+// pull mode: take one decoded picture from the output queue
+// wait_ms == 0: return immediately, wait_ms < 0: wait until a picture is available, 
+// wait_ms > 0: wait at most wait_ms milliseconds
+// if succeeded return 0, if no picture is available return IRK_AVS_DEC_AGAIN,
+// if all pictures before the end of stream mark have been received return IRK_AVS_DEC_EOF once, the mark is put
+// by irk_avs_decoder_send_packet(decoder, NULL) and irk_avs_decoder_reset/irk_avs_decoder_seek_reset,
+// decoding can continue by sending new packets after that
+// NOTE 1: can be called in another thread than irk_avs_decoder_send_packet
+// NOTE 2: the returned picture is retained, user must release it by irk_avs_decoder_dismiss_picture
+// NOTE 3: irk_destroy_avs_decoder wakes up waiting callers with IRK_AVS_DEC_EOF and waits until they return,
+//         no new call may be started after irk_destroy_avs_decoder is called
+IRK_AVSDEC_EXPORT int irk_avs_decoder_receive_frame(IrkAvsDecoder* decoder, IrkAvsDecedPic** pic, int wait_ms);
+
+// get per-stage decoding statistics accumulated since the decoder was created or last reset by this function
+// "reset" != 0: clear the statistics after reading
+// if succeeded return 0, if statistics is not enabled(see IrkAvsDecConfig::enable_stats) return IRK_AVS_DEC_UNAVAILABLE
+// NOTE: statistics of a picture are added after it is delivered, call in the thread calling irk_avs_decoder_decode
+IRK_AVSDEC_EXPORT int irk_avs_decoder_get_stats(IrkAvsDecoder* decoder, IrkAvsDecStats* stats, int reset);
+
 // get AVS+ stream basic infomation
 // if succeeded return 0, if failed return negtive error code(see above)
 IRK_AVSDEC_EXPORT int irk_avs_decoder_get_info(IrkAvsDecoder* decoder, IrkAvsStreamInfo* pinfo);
 
+// find the next AVS+ start code(00 00 01) in the coded data, SSE4/AVX2 accelerated,
+// can be used to split the elementary stream into pictures
+// return offset of the start code, return "size" if not found
+IRK_AVSDEC_EXPORT int irk_avs_find_start_code(const uint8_t* data, int size);
+
 // normally decoded picture is only valid in notify callback function,
 // in case user wants to use decoded picture outside callback function, 
 // user can either use custom memory allocator or retain the decoded picture